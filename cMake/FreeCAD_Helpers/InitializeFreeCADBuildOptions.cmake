@@ -152,6 +152,7 @@ macro(InitializeFreeCADBuildOptions)
     option(BUILD_SPREADSHEET "Build the FreeCAD spreadsheet module" ON)
     option(BUILD_START "Build the FreeCAD start module" ON)
     option(BUILD_TEST "Build the FreeCAD test module" ON)
+    option(BUILD_BENCHMARK "Build FreeCADBench, the performance benchmarks of core and modules" OFF)
     option(BUILD_TECHDRAW "Build the FreeCAD Technical Drawing module" ON)
     option(BUILD_TUX "Build the FreeCAD Tux module" ON)
     option(BUILD_WEB "Build the FreeCAD web module" ON)
@@ -434,6 +434,7 @@ Document* Application::newDocument(const char * Name, const char * UserName, boo
     _pActiveDoc->signalDeletedObject.connect(boost::bind(&App::Application::slotDeletedObject, this, bp::_1));
     _pActiveDoc->signalBeforeChangeObject.connect(boost::bind(&App::Application::slotBeforeChangeObject, this, bp::_1, bp::_2));
     _pActiveDoc->signalChangedObject.connect(boost::bind(&App::Application::slotChangedObject, this, bp::_1, bp::_2));
+    _pActiveDoc->signalChangedObjects.connect(boost::bind(&App::Application::slotChangedObjects, this, bp::_1, bp::_2));
     _pActiveDoc->signalRelabelObject.connect(boost::bind(&App::Application::slotRelabelObject, this, bp::_1));
     _pActiveDoc->signalActivatedObject.connect(boost::bind(&App::Application::slotActivatedObject, this, bp::_1));
     _pActiveDoc->signalUndo.connect(boost::bind(&App::Application::slotUndoDocument, this, bp::_1));
@@ -476,6 +477,12 @@ bool Application::closeDocument(const char* name)
 
     Base::ConsoleRefreshDisabler disabler;
 
+    // an asynchronous recompute must be done before the objects go away
+    if (pos->second->hasAsyncRecompute()) {
+        pos->second->cancelRecompute();
+        while (pos->second->processAsyncRecompute(100)) {}
+    }
+
     // Trigger observers before removing the document from the internal map.
     // Some observers might rely on this document still being there.
     signalDeleteDocument(*pos->second);
@@ -1404,6 +1411,12 @@ void Application::slotChangedObject(const App::DocumentObject&O, const App::Prop
     this->signalChangedObject(O,P);
 }
 
+void Application::slotChangedObjects(const App::Document& doc,
+        const std::vector<std::pair<const App::DocumentObject*, const App::Property*> >& changes)
+{
+    this->signalChangedObjects(doc,changes);
+}
+
 void Application::slotRelabelObject(const App::DocumentObject&O)
 {
     this->signalRelabelObject(O);
@@ -1481,12 +1494,13 @@ char ** Application::_argv;
 void Application::destruct(void)
 {
     // saving system parameter
+    // merge the change journals, a clean exit leaves only the XML files
     Console().Log("Saving system parameter...\n");
-    _pcSysParamMngr->SaveDocument();
+    _pcSysParamMngr->MergeJournal();
     // saving the User parameter
     Console().Log("Saving system parameter...done\n");
     Console().Log("Saving user parameter...\n");
-    _pcUserParamMngr->SaveDocument();
+    _pcUserParamMngr->MergeJournal();
     Console().Log("Saving user parameter...done\n");
 
     // now save all other parameter files
@@ -1495,7 +1509,7 @@ void Application::destruct(void)
         if ((it->second != _pcSysParamMngr) && (it->second != _pcUserParamMngr)) {
             if (it->second->HasSerializer()) {
                 Console().Log("Saving %s...\n", it->first.c_str());
-                it->second->SaveDocument();
+                it->second->MergeJournal();
                 Console().Log("Saving %s...done\n", it->first.c_str());
             }
         }
@@ -1512,6 +1526,9 @@ void Application::destruct(void)
     assert(_pcSingleton);
     delete _pcSingleton;
 
+    // Deliver the pending messages and stop the drain thread of the console
+    Console().SetConnectionMode(ConsoleSingleton::Direct);
+
     // We must detach from console and delete the observer to save our file
     destructObserver();
 
@@ -1601,14 +1618,21 @@ void printBacktrace(size_t skip=0)
 }
 #endif
 
+// milliseconds the crash handlers wait for the asynchronous console
+static const int CrashFlushTimeout = 500;
+
 void segmentation_fault_handler(int sig)
 {
 #if defined(FC_OS_LINUX)
     (void)sig;
+    // print the messages still queued by the asynchronous console first,
+    // but don't hang if the drain thread can't make progress any more
+    Base::Console().Flush(CrashFlushTimeout);
     std::cerr << "Program received signal SIGSEGV, Segmentation fault.\n";
     printBacktrace(2);
     exit(1);
 #else
+    Base::Console().Flush(CrashFlushTimeout);
     switch (sig) {
         case SIGSEGV:
             std::cerr << "Illegal storage access..." << std::endl;
@@ -1631,6 +1655,7 @@ void segmentation_fault_handler(int sig)
 
 void unhandled_exception_handler()
 {
+    Base::Console().Flush(CrashFlushTimeout);
     std::cerr << "Terminating..." << std::endl;
 }
 
@@ -2030,6 +2055,17 @@ void Application::initConfig(int argc, char ** argv)
 #endif
     }
 
+    auto lograteParam = _pcUserParamMngr->GetGroup("BaseApp/LogRates");
+    for (const auto &v : lograteParam->GetIntMap())
+        Base::Console().SetLogRateLimit(v.first.c_str(), static_cast<int>(v.second));
+
+    // The report view and the status bar post their messages to the main
+    // thread, but the splash screen observer draws directly from SendLog(),
+    // so only use the asynchronous console when running without GUI
+    if (mConfig["Console"] != "0" && _pcUserParamMngr->GetGroup("BaseApp/Preferences/General")
+            ->GetBool("AsyncLogging", false))
+        Base::Console().SetConnectionMode(ConsoleSingleton::Async);
+
     // Change application tmp. directory
     std::string tmpPath = _pcUserParamMngr->GetGroup("BaseApp/Preferences/General")->GetASCII("TempPath");
     Base::FileInfo di(tmpPath);
@@ -2457,6 +2493,10 @@ void Application::ParseOptions(int ac, char ** av)
     ("module-path,M", value< vector<string> >()->composing(),"Additional module paths")
     ("python-path,P", value< vector<string> >()->composing(),"Additional python paths")
     ("single-instance", "Allow to run a single instance of the application")
+    ("profile-startup", value<string>()->implicit_value(""),
+     "Writes the time spent to initialize each module to the given file,\n"
+     "use --profile-startup=<file>. Defaults to StartupProfile.txt in the\n"
+     "user data directory")
     ;
 
 
@@ -2680,6 +2720,13 @@ void Application::ParseOptions(int ac, char ** av)
         mConfig["SingleInstance"] = "1";
     }
 
+    if (vm.count("profile-startup")) {
+        string file = vm["profile-startup"].as<string>();
+        if (file.empty())
+            file = mConfig["UserAppData"] + "StartupProfile.txt";
+        mConfig["ProfileStartup"] = file;
+    }
+
     if (vm.count("dump-config")) {
         std::stringstream str;
         for (std::map<std::string,std::string>::iterator it=mConfig.begin(); it != mConfig.end(); ++it) {
@@ -233,6 +233,9 @@ public:
     boost::signals2::signal<void (const App::DocumentObject&, const App::Property&)> signalBeforeChangeObject;
     /// signal on changed Object
     boost::signals2::signal<void (const App::DocumentObject&, const App::Property&)> signalChangedObject;
+    /// signal on changed Objects, see Document::signalChangedObjects
+    boost::signals2::signal<void (const App::Document&,
+            const std::vector<std::pair<const App::DocumentObject*, const App::Property*> >&)> signalChangedObjects;
     /// signal on relabeled Object
     boost::signals2::signal<void (const App::DocumentObject&)> signalRelabelObject;
     /// signal on activated Object
@@ -424,6 +427,8 @@ protected:
     void slotDeletedObject(const App::DocumentObject&);
     void slotBeforeChangeObject(const App::DocumentObject&, const App::Property& Prop);
     void slotChangedObject(const App::DocumentObject&, const App::Property& Prop);
+    void slotChangedObjects(const App::Document&,
+            const std::vector<std::pair<const App::DocumentObject*, const App::Property*> >&);
     void slotRelabelObject(const App::DocumentObject&);
     void slotActivatedObject(const App::DocumentObject&);
     void slotUndoDocument(const App::Document&);
@@ -87,6 +87,12 @@ recompute path. Also, it enables more complicated dependencies beyond trees.
 #include <unordered_set>
 #include <unordered_map>
 #include <random>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 #include <QCoreApplication>
 #include <QCryptographicHash>
@@ -167,6 +173,27 @@ struct DocumentP
 {
     // Array to preserve the creation order of created objects
     std::vector<DocumentObject*> objectArray;
+    // Objects of objectArray grouped by their exact type. Each object is
+    // tagged with a sequence number increasing in the order of objectArray.
+    typedef std::vector<std::pair<unsigned long, DocumentObject*> > TypeIndexEntry;
+    std::unordered_map<unsigned int, TypeIndexEntry> objectTypeIndex;
+    unsigned long objectTypeSeq;
+    // Dependency lists of all objects per getDependencyList() option, valid
+    // until DocumentObject::getDependencyGeneration() changes
+    std::map<int, std::vector<DocumentObject*> > dependencyCache;
+    std::vector<DocumentObject*> topoSortCache;
+    bool topoSortCached;
+    unsigned long dependencyGeneration;
+    // the caches above are also used by the worker of an asynchronous recompute
+    std::mutex dependencyMutex;
+    // Changes collected while a change batch is open, a property belongs to
+    // a single object, so it identifies a change on its own
+    typedef std::vector<std::pair<const DocumentObject*, const Property*> > ChangeList;
+    ChangeList changeBatch;
+    std::unordered_set<const Property*> changeBatchProps;
+    std::vector<ChangeList*> changeBatchDelivering;
+    int changeBatchLevel;
+    bool changeBatchEmitting;
     std::unordered_set<App::DocumentObject*> touchedObjs;
     std::unordered_map<std::string,DocumentObject*> objectMap;
     std::unordered_map<long,DocumentObject*> objectIdMap;
@@ -180,7 +207,7 @@ struct DocumentP
     bool committing;
     std::bitset<32> StatusBits;
     int iUndoMode;
-    unsigned int UndoMemSize;
+    std::size_t UndoMemSize;
     unsigned int UndoMaxStackSize;
     std::string programVersion;
 #ifdef USE_OLD_DAG
@@ -190,6 +217,66 @@ struct DocumentP
 #endif //USE_OLD_DAG
     std::multimap<const App::DocumentObject*, 
         std::unique_ptr<App::DocumentObjectExecReturn> > _RecomputeLog;
+    // written by the worker of an asynchronous recompute
+    std::mutex recomputeLogMutex;
+    std::atomic<bool> recomputeCanceled;
+
+    // State of an asynchronous recompute, see Document::recomputeAsync().
+    // Notifications raised by the worker thread are held back until the
+    // object being recomputed is done, then handed over to the owner thread
+    // which emits them in processAsyncRecompute(). While it exists, the
+    // document is locked, see checkAsyncLock().
+    struct AsyncRecompute {
+        enum EventType {
+            Change,
+            Recomputed,
+        };
+        struct Event {
+            EventType type;
+            const DocumentObject *obj;
+            const Property *prop;
+        };
+
+        Document *doc;
+        std::thread worker;
+        std::thread::id workerId;
+        std::vector<DocumentObject*> objects;
+
+        // worker only
+        std::vector<Event> pending;
+        std::unordered_set<const Property*> pendingChange;
+
+        // guarded by mutex
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::deque<Event> events;
+        bool finished = false;
+        bool hasError = false;
+
+        bool isWorker() const {
+            return std::this_thread::get_id() == workerId;
+        }
+
+        void post(EventType type, const DocumentObject *obj, const Property *prop) {
+            if(type == Change && !pendingChange.insert(prop).second)
+                return;
+            pending.push_back({type,obj,prop});
+        }
+
+        void flush() {
+            if(pending.empty())
+                return;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                events.insert(events.end(),pending.begin(),pending.end());
+            }
+            pending.clear();
+            pendingChange.clear();
+            cond.notify_all();
+            doc->signalAsyncRecomputeReady(*doc);
+        }
+    };
+    std::unique_ptr<AsyncRecompute> asyncRecompute;
 
     DocumentP() {
         static std::random_device _RD;
@@ -211,6 +298,136 @@ struct DocumentP
         iUndoMode = 0;
         UndoMemSize = 0;
         UndoMaxStackSize = 20;
+        objectTypeSeq = 0;
+        topoSortCached = false;
+        dependencyGeneration = 0;
+        changeBatchLevel = 0;
+        changeBatchEmitting = false;
+        recomputeCanceled = false;
+    }
+
+    // Queue a notification raised by the worker thread of an asynchronous
+    // recompute, returns false if it is to be emitted right away
+    bool postAsyncEvent(AsyncRecompute::EventType type,
+            const DocumentObject *obj, const Property *prop=0)
+    {
+        if(!asyncRecompute || !asyncRecompute->isWorker())
+            return false;
+        asyncRecompute->post(type,obj,prop);
+        return true;
+    }
+
+    void flushAsyncEvents() {
+        if(isAsyncWorker())
+            asyncRecompute->flush();
+    }
+
+    bool isAsyncWorker() const {
+        return asyncRecompute && asyncRecompute->isWorker();
+    }
+
+    // The owner thread must not save or modify the document, and neither
+    // thread may add or remove objects, while an asynchronous recompute runs
+    void checkAsyncLock(bool allowWorker=false) const {
+        if(asyncRecompute && (!allowWorker || !asyncRecompute->isWorker()))
+            throw Base::RuntimeError("Document is locked by an asynchronous recompute");
+    }
+
+    // Drop collected changes of a removed object or property, including the
+    // ones not yet delivered by closeChangeBatch()
+    void removeFromChangeBatch(const DocumentObject *obj, const Property *prop=0) {
+        if(changeBatch.empty() && changeBatchDelivering.empty())
+            return;
+        std::vector<ChangeList*> lists(changeBatchDelivering);
+        lists.push_back(&changeBatch);
+        for(auto changes : lists) {
+            for(auto &v : *changes) {
+                if(v.first==obj && (!prop || v.second==prop)) {
+                    changeBatchProps.erase(v.second);
+                    v.first = 0;
+                }
+            }
+        }
+    }
+
+    void clearChangeBatch() {
+        changeBatch.clear();
+        changeBatchProps.clear();
+        for(auto changes : changeBatchDelivering) {
+            for(auto &v : *changes)
+                v.first = 0;
+        }
+    }
+
+    // Called wherever objects are added to or removed from objectArray
+    void onObjectAdded(DocumentObject *obj) {
+        addToTypeIndex(obj);
+        DocumentObject::_invalidateDependencies();
+    }
+
+    void onObjectRemoved(DocumentObject *obj) {
+        removeFromTypeIndex(obj);
+        DocumentObject::_invalidateDependencies();
+        removeFromChangeBatch(obj);
+    }
+
+    void onObjectsCleared() {
+        objectTypeIndex.clear();
+        DocumentObject::_invalidateDependencies();
+        clearChangeBatch();
+    }
+
+    void addToTypeIndex(DocumentObject *obj) {
+        objectTypeIndex[obj->getTypeId().getKey()].emplace_back(++objectTypeSeq, obj);
+    }
+
+    void removeFromTypeIndex(DocumentObject *obj) {
+        auto it = objectTypeIndex.find(obj->getTypeId().getKey());
+        if(it == objectTypeIndex.end())
+            return;
+        auto &entry = it->second;
+        for(auto jt=entry.begin();jt!=entry.end();++jt) {
+            if(jt->second == obj) {
+                entry.erase(jt);
+                break;
+            }
+        }
+        if(entry.empty())
+            objectTypeIndex.erase(it);
+    }
+
+    // called with dependencyMutex locked
+    void checkDependencyCache() {
+        if(dependencyGeneration != DocumentObject::getDependencyGeneration()) {
+            dependencyCache.clear();
+            topoSortCache.clear();
+            topoSortCached = false;
+            dependencyGeneration = DocumentObject::getDependencyGeneration();
+        }
+    }
+
+    std::vector<DocumentObject*> getDependencyList(int options) {
+        std::lock_guard<std::mutex> lock(dependencyMutex);
+        checkDependencyCache();
+        auto it = dependencyCache.find(options);
+        if(it == dependencyCache.end()) {
+            auto objs = Document::getDependencyList(objectArray,options);
+            it = dependencyCache.emplace(options,std::move(objs)).first;
+        }
+        return it->second;
+    }
+
+    // Return the index entries of all types derived from 'type' and the
+    // total number of objects in them
+    std::size_t findTypeIndex(const Base::Type &type, std::vector<const TypeIndexEntry*> &entries) const {
+        std::size_t count = 0;
+        for(auto &v : objectTypeIndex) {
+            if(Base::Type::fromKey(v.first).isDerivedFrom(type)) {
+                entries.push_back(&v.second);
+                count += v.second.size();
+            }
+        }
+        return count;
     }
 
     void addRecomputeLog(const char *why, App::DocumentObject *obj) {
@@ -226,11 +443,13 @@ struct DocumentP
             delete returnCode;
             return;
         }
+        std::lock_guard<std::mutex> lock(recomputeLogMutex);
         _RecomputeLog.emplace(returnCode->Which, std::unique_ptr<DocumentObjectExecReturn>(returnCode));
         returnCode->Which->setStatus(ObjectStatus::Error,true);
     }
 
     void clearRecomputeLog(const App::DocumentObject *obj=0) {
+        std::lock_guard<std::mutex> lock(recomputeLogMutex);
         if(!obj)
             _RecomputeLog.clear();
         else
@@ -238,6 +457,7 @@ struct DocumentP
     }
 
     const char *findRecomputeLog(const App::DocumentObject *obj) {
+        std::lock_guard<std::mutex> lock(recomputeLogMutex);
         auto range = _RecomputeLog.equal_range(obj);
         if(range.first == range.second)
             return 0;
@@ -945,6 +1165,10 @@ bool Document::checkOnCycle(void)
 
 bool Document::undo(int id)
 {
+    if (d->asyncRecompute) {
+        FC_WARN("Cannot undo during asynchronous recompute");
+        return false;
+    }
     if (d->iUndoMode) {
         if(id) {
             auto it = mUndoMap.find(id);
@@ -997,6 +1221,10 @@ bool Document::undo(int id)
 
 bool Document::redo(int id)
 {
+    if (d->asyncRecompute) {
+        FC_WARN("Cannot redo during asynchronous recompute");
+        return false;
+    }
     if (d->iUndoMode) {
         if(id) {
             auto it = mRedoMap.find(id);
@@ -1047,7 +1275,14 @@ void Document::addOrRemovePropertyOfObject(TransactionalObject* obj, Property *p
 {
     if (!prop || !obj || !obj->isAttachedToDocument()) 
         return;
-    if(d->iUndoMode && !isPerformingTransaction() && !d->activeUndoTransaction) {
+    d->checkAsyncLock(true);
+    if (!add) {
+        auto docObj = Base::freecad_dynamic_cast<DocumentObject>(obj);
+        if (docObj)
+            d->removeFromChangeBatch(docObj, prop);
+    }
+    if(d->iUndoMode && !isPerformingTransaction() && !d->activeUndoTransaction
+            && !d->asyncRecompute) {
         if(!testStatus(Restoring) || testStatus(Importing)) {
             int tid=0;
             const char *name = GetApplication().getActiveTransaction(&tid);
@@ -1099,6 +1334,10 @@ int Document::_openTransaction(const char* name, int id)
             FC_WARN("Cannot open transaction while transacting");
         return 0;
     }
+    if(d->asyncRecompute) {
+        FC_WARN("Cannot open transaction during asynchronous recompute");
+        return 0;
+    }
 
     if (d->iUndoMode) {
         if(id && mUndoMap.find(id)!=mUndoMap.end())
@@ -1213,6 +1452,10 @@ void Document::_commitTransaction(bool notify)
             FC_WARN("Cannot commit transaction while transacting");
         return;
     }
+    if(d->asyncRecompute) {
+        FC_WARN("Cannot commit transaction during asynchronous recompute");
+        return;
+    }
     if (d->activeUndoTransaction) {
         Base::FlagToggler<> flag(d->committing);
         Application::TransactionSignaller signaller(false,true);
@@ -1225,6 +1468,17 @@ void Document::_commitTransaction(bool notify)
             delete mUndoTransactions.front();
             mUndoTransactions.pop_front();
         }
+        // drop the oldest transactions until the memory limit is met,
+        // the last one is always kept
+        if(d->UndoMemSize) {
+            std::size_t size = getUndoMemSize();
+            while(size > d->UndoMemSize && mUndoTransactions.size() > 1) {
+                size -= std::min(size, mUndoTransactions.front()->getUndoMemSize());
+                mUndoMap.erase(mUndoTransactions.front()->getID());
+                delete mUndoTransactions.front();
+                mUndoTransactions.pop_front();
+            }
+        }
         signalCommitTransaction(*this);
 
         if(notify)
@@ -1248,6 +1502,10 @@ void Document::_abortTransaction()
         if (FC_LOG_INSTANCE.isEnabled(FC_LOGLEVEL_LOG))
             FC_WARN("Cannot abort transaction while transacting");
     }
+    if(d->asyncRecompute) {
+        FC_WARN("Cannot abort transaction during asynchronous recompute");
+        return;
+    }
 
     if (d->activeUndoTransaction) {
         Base::FlagToggler<bool> flag(d->rollback);
@@ -1315,6 +1573,7 @@ void Document::clearDocument()
     if(this->d->objectArray.size()) {
         GetApplication().signalDeleteDocument(*this);
         this->d->objectArray.clear();
+        this->d->onObjectsCleared();
         for(auto &v : this->d->objectMap) {
             v.second->setStatus(ObjectStatus::Destroy, true);
             delete(v.second);
@@ -1330,6 +1589,7 @@ void Document::clearDocument()
 
     this->d->clearRecomputeLog();
     this->d->objectArray.clear();
+    this->d->onObjectsCleared();
     this->d->objectMap.clear();
     this->d->objectIdMap.clear();
     this->d->lastObjectId = 0;
@@ -1418,12 +1678,17 @@ int Document::getUndoMode(void) const
     return d->iUndoMode;
 }
 
-unsigned int Document::getUndoMemSize (void) const
+std::size_t Document::getUndoMemSize (void) const
 {
-    return d->UndoMemSize;
+    std::size_t size = 0;
+    for (auto transaction : mUndoTransactions)
+        size += transaction->getUndoMemSize();
+    for (auto transaction : mRedoTransactions)
+        size += transaction->getUndoMemSize();
+    return size;
 }
 
-void Document::setUndoLimit(unsigned int UndoMemSize)
+void Document::setUndoLimit(std::size_t UndoMemSize)
 {
     d->UndoMemSize = UndoMemSize;
 }
@@ -1491,6 +1756,25 @@ void Document::onChanged(const Property* prop)
 
 void Document::onBeforeChangeProperty(const TransactionalObject *Who, const Property *What)
 {
+    if(d->asyncRecompute) {
+        if(!d->asyncRecompute->isWorker()) {
+            // Only the objects are locked. Properties with Output status,
+            // e.g. Visibility, and those of the view providers don't affect
+            // the recompute. Their changes are not recorded, the worker owns
+            // the transaction.
+            bool isObject = Who->isDerivedFrom(App::DocumentObject::getClassTypeId());
+            if(isObject && !What->testStatus(Property::Output))
+                d->checkAsyncLock();
+            if(isObject)
+                signalBeforeChangeObject(*static_cast<const App::DocumentObject*>(Who), *What);
+            return;
+        }
+        // Not signaled for changes made by the worker, see recomputeAsync().
+        // The transaction is opened before the worker starts.
+        if(!d->rollback && !_IsRelabeling && d->activeUndoTransaction)
+            d->activeUndoTransaction->addObjectChange(Who,What);
+        return;
+    }
     if(Who->isDerivedFrom(App::DocumentObject::getClassTypeId()))
         signalBeforeChangeObject(*static_cast<const App::DocumentObject*>(Who), *What);
     if(!d->rollback && !_IsRelabeling) {
@@ -1502,9 +1786,87 @@ void Document::onBeforeChangeProperty(const TransactionalObject *Who, const Prop
 
 void Document::onChangedProperty(const DocumentObject *Who, const Property *What)
 {
+    if(d->postAsyncEvent(DocumentP::AsyncRecompute::Change, Who, What))
+        return;
+    if(d->changeBatchLevel) {
+        if(d->changeBatchProps.insert(What).second)
+            d->changeBatch.emplace_back(Who,What);
+        return;
+    }
+    // a change made by a slot of a delivered batch is not part of it
+    Base::StateLocker guard(d->changeBatchEmitting, false);
     signalChangedObject(*Who, *What);
 }
 
+void Document::openChangeBatch()
+{
+    ++d->changeBatchLevel;
+}
+
+void Document::closeChangeBatch()
+{
+    if(d->changeBatchLevel<=0 || --d->changeBatchLevel)
+        return;
+
+    DocumentP::ChangeList changes;
+    changes.swap(d->changeBatch);
+    d->changeBatchProps.clear();
+
+    // the slots may remove objects, which invalidates their pending changes
+    struct Delivering {
+        std::vector<DocumentP::ChangeList*> &lists;
+        Delivering(std::vector<DocumentP::ChangeList*> &l, DocumentP::ChangeList *changes)
+            :lists(l)
+        {
+            lists.push_back(changes);
+        }
+        ~Delivering() {
+            lists.pop_back();
+        }
+    } delivering(d->changeBatchDelivering, &changes);
+
+    for(auto &v : changes) {
+        if(v.first) {
+            Base::StateLocker guard(d->changeBatchEmitting);
+            signalChangedObject(*v.first, *v.second);
+        }
+    }
+    changes.erase(std::remove_if(changes.begin(), changes.end(),
+                [](const DocumentP::ChangeList::value_type &v) {return !v.first;}),
+            changes.end());
+    if(changes.size())
+        signalChangedObjects(*this,changes);
+}
+
+bool Document::hasChangeBatch() const
+{
+    return d->changeBatchLevel>0;
+}
+
+bool Document::isDeliveringChangeBatch() const
+{
+    return d->changeBatchEmitting;
+}
+
+ChangeBatchLocker::ChangeBatchLocker(Document *doc)
+    :doc(doc)
+{
+    doc->openChangeBatch();
+}
+
+ChangeBatchLocker::~ChangeBatchLocker()
+{
+    try {
+        doc->closeChangeBatch();
+    }
+    catch (const Base::Exception& e) {
+        e.ReportException();
+    }
+    catch (const std::exception& e) {
+        FC_ERR("exception while delivering batched changes: " << e.what());
+    }
+}
+
 void Document::setTransactionMode(int iMode)
 {
     d->iTransactionMode = iMode;
@@ -1634,6 +1996,7 @@ Document::~Document()
 #endif
 
     d->objectArray.clear();
+    d->onObjectsCleared();
     for (auto it = d->objectMap.begin(); it != d->objectMap.end(); ++it) {
         it->second->setStatus(ObjectStatus::Destroy, true);
         delete(it->second);
@@ -1679,6 +2042,7 @@ std::string Document::getTransientDirectoryName(const std::string& uuid, const s
 
 void Document::Save (Base::Writer &writer) const
 {
+    d->checkAsyncLock();
     writer.Stream() << "<Document SchemaVersion=\"4\" ProgramVersion=\""
                     << App::Application::Config()["BuildVersionMajor"] << "."
                     << App::Application::Config()["BuildVersionMinor"] << "R"
@@ -2207,7 +2571,7 @@ unsigned int Document::getMemSize (void) const
     size += PropertyContainer::getMemSize();
 
     // Undo Redo size
-    size += getUndoMemSize();
+    size += static_cast<unsigned int>(std::min<std::size_t>(getUndoMemSize(), UINT_MAX - size));
 
     return size;
 }
@@ -2575,6 +2939,7 @@ private:
 
 bool Document::saveToFile(const char* filename) const
 {
+    d->checkAsyncLock();
     signalStartSave(*this, filename);
 
     auto hGrp = App::GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Document");
@@ -2678,6 +3043,7 @@ void Document::restore (const char *filename,
         signal = true;
         GetApplication().signalDeleteDocument(*this);
         d->objectArray.clear();
+        d->onObjectsCleared();
         for(auto &v : d->objectMap) {
             v.second->setStatus(ObjectStatus::Destroy, true);
             delete(v.second);
@@ -2692,6 +3058,7 @@ void Document::restore (const char *filename,
 
     d->clearRecomputeLog();
     d->objectArray.clear();
+    d->onObjectsCleared();
     d->objectMap.clear();
     d->objectIdMap.clear();
     d->lastObjectId = 0;
@@ -3387,42 +3754,45 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
     return objectCount;
 }
 
+bool Document::recomputeAsync(const std::vector<App::DocumentObject*> &objs, bool force, int)
+{
+    // not supported with the old dependency graph, recompute right away
+    recompute(objs,force);
+    return false;
+}
+
 #else //ifdef USE_OLD_DAG
 
-int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool force, bool *hasError, int options) 
+bool Document::_canRecompute(const std::vector<App::DocumentObject*> &objs, bool force)
 {
     if (d->undoing || d->rollback) {
         if (FC_LOG_INSTANCE.isEnabled(FC_LOGLEVEL_LOG))
             FC_WARN("Ignore document recompute on undo/redo");
-        return 0;
+        return false;
     }
 
-    int objectCount = 0;
     if (testStatus(Document::PartialDoc)) {
         if(mustExecute()) 
             FC_WARN("Please reload partial document '" << Label.getValue() << "' for recomputation.");
-        return 0;
+        return false;
     }
     if (testStatus(Document::Recomputing)) {
         // this is clearly a bug in the calling instance
         FC_ERR("Recursive calling of recompute for document " << getName());
-        return 0;
+        return false;
     }
     // The 'SkipRecompute' flag can be (tmp.) set to avoid too many
     // time expensive recomputes
     if(!force && testStatus(Document::SkipRecompute)) {
         signalSkipRecompute(*this,objs);
-        return 0;
+        return false;
     }
+    return true;
+}
 
-    // delete recompute log
-    d->clearRecomputeLog();
-
-    FC_TIME_INIT(t);
-
-    Base::ObjectStatusLocker<Document::Status, Document> exe(Document::Recomputing, this);
-    signalBeforeRecompute(*this);
-
+std::vector<App::DocumentObject*> Document::_prepareRecompute(
+        const std::vector<App::DocumentObject*> &objs, int options)
+{
 #if 0
     //////////////////////////////////////////////////////////////////////////
     // FIXME Comment by Realthunder: 
@@ -3442,11 +3812,20 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
     }
     std::reverse(topoSortedObjects.begin(),topoSortedObjects.end());
 #else
-    auto topoSortedObjects = getDependencyList(objs.empty()?d->objectArray:objs,DepSort|options);
+    auto topoSortedObjects = objs.empty()?d->getDependencyList(DepSort|options)
+                                         :getDependencyList(objs,DepSort|options);
 #endif
     for(auto obj : topoSortedObjects)
         obj->setStatus(ObjectStatus::PendingRecompute,true);
 
+    d->recomputeCanceled = false;
+    return topoSortedObjects;
+}
+
+int Document::_recomputeObjects(const std::vector<App::DocumentObject*> &topoSortedObjects, bool *hasError)
+{
+    int objectCount = 0;
+
     ParameterGrp::handle hGrp = GetApplication().GetParameterGroupByPath(
             "User parameter:BaseApp/Preferences/Document");
     bool canAbort = hGrp->GetBool("CanAbortRecompute",true);
@@ -3464,6 +3843,8 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
                 seq.reset(new Base::SequencerLauncher("Recompute...", topoSortedObjects.size()));
             FC_LOG("Recompute pass " << passes);
             for (;idx<topoSortedObjects.size();(seq?seq->next(true):true),++idx) {
+                if(d->recomputeCanceled)
+                    throw Base::AbortException("Recompute canceled");
                 auto obj = topoSortedObjects[idx];
                 if(!obj->getNameInDocument() || filter.find(obj)!=filter.end())
                     continue;
@@ -3476,6 +3857,7 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
                     if(res) {
                         if(hasError)
                             *hasError = true;
+                        d->flushAsyncEvents();
                         if(res < 0) {
                             passes = 2;
                             break;
@@ -3488,12 +3870,14 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
                     }
                 }
                 if(obj->isTouched() || doRecompute) {
-                    signalRecomputedObject(*obj);
+                    if(!d->postAsyncEvent(DocumentP::AsyncRecompute::Recomputed, obj))
+                        signalRecomputedObject(*obj);
                     obj->purgeTouched();
                     // set all dependent object touched to force recompute
                     for (auto inObjIt : obj->getInList())
                         inObjIt->enforceRecompute();
                 }
+                d->flushAsyncEvents();
             }
             // check if all objects are recomputed but still thouched 
             for (size_t i=0;i<topoSortedObjects.size();++i) {
@@ -3519,6 +3903,11 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
 
     FC_TIME_LOG(t2, "Recompute");
 
+    return objectCount;
+}
+
+void Document::_finishRecompute(const std::vector<App::DocumentObject*> &topoSortedObjects)
+{
     for(auto obj : topoSortedObjects) {
         if(!obj->getNameInDocument())
             continue;
@@ -3527,6 +3916,24 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
         if(obj->testStatus(ObjectStatus::PendingRemove))
             obj->getDocument()->removeObject(obj->getNameInDocument());
     }
+}
+
+int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool force, bool *hasError, int options) 
+{
+    if(!_canRecompute(objs,force))
+        return 0;
+
+    // delete recompute log
+    d->clearRecomputeLog();
+
+    FC_TIME_INIT(t);
+
+    Base::ObjectStatusLocker<Document::Status, Document> exe(Document::Recomputing, this);
+    signalBeforeRecompute(*this);
+
+    auto topoSortedObjects = _prepareRecompute(objs,options);
+    int objectCount = _recomputeObjects(topoSortedObjects,hasError);
+    _finishRecompute(topoSortedObjects);
 
     signalRecomputed(*this,topoSortedObjects);
 
@@ -3538,8 +3945,171 @@ int Document::recompute(const std::vector<App::DocumentObject*> &objs, bool forc
     return objectCount;
 }
 
+bool Document::recomputeAsync(const std::vector<App::DocumentObject*> &objs, bool force, int options)
+{
+    if (d->asyncRecompute) {
+        FC_ERR("Asynchronous recompute of document " << getName() << " is still running");
+        return false;
+    }
+    if(!_canRecompute(objs,force))
+        return false;
+
+    d->clearRecomputeLog();
+
+    // Open the pending transaction now, the worker only records changes into
+    // it. Until the recompute is done, the document is locked against other
+    // transaction changes.
+    _checkTransaction(0,0,__LINE__);
+
+    // the status is kept until processAsyncRecompute() sees the worker finish
+    setStatus(Document::Recomputing,true);
+
+    std::unique_ptr<DocumentP::AsyncRecompute> async(new DocumentP::AsyncRecompute);
+    async->doc = this;
+    try {
+        signalBeforeRecompute(*this);
+        // sort on this thread, so that a dependency error is reported to the caller
+        async->objects = _prepareRecompute(objs,options);
+    }
+    catch (...) {
+        setStatus(Document::Recomputing,false);
+        throw;
+    }
+
+    auto worker = async.get();
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    worker->worker = std::thread([this,worker]() {
+        {
+            // wait for workerId
+            std::lock_guard<std::mutex> lock(worker->mutex);
+        }
+        bool hasError = false;
+        try {
+            _recomputeObjects(worker->objects,&hasError);
+        }
+        catch (const std::exception &e) {
+            FC_ERR("exception in asynchronous recompute: " << e.what());
+            hasError = true;
+        }
+        catch (...) {
+            FC_ERR("Unknown exception in asynchronous recompute");
+            hasError = true;
+        }
+        worker->flush();
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            worker->finished = true;
+            worker->hasError = hasError;
+        }
+        worker->cond.notify_all();
+        signalAsyncRecomputeReady(*this);
+    });
+    worker->workerId = worker->worker.get_id();
+    d->asyncRecompute = std::move(async);
+    return true;
+}
+
 #endif // USE_OLD_DAG
 
+bool Document::hasAsyncRecompute() const
+{
+    return !!d->asyncRecompute;
+}
+
+bool Document::processAsyncRecompute(int timeout, bool *hasError)
+{
+    auto async = d->asyncRecompute.get();
+    if(!async)
+        return false;
+    if(async->isWorker()) {
+        FC_ERR("Cannot process asynchronous recompute from its worker thread");
+        return true;
+    }
+
+    std::deque<DocumentP::AsyncRecompute::Event> events;
+    bool finished;
+    {
+        // the worker may need the GIL to execute Python features
+        std::unique_ptr<Base::PyGILStateRelease> release;
+#if PY_MAJOR_VERSION >= 3
+        if(timeout>0 && PyGILState_Check())
+            release.reset(new Base::PyGILStateRelease);
+#endif
+        std::unique_lock<std::mutex> lock(async->mutex);
+        if(timeout>0 && async->events.empty() && !async->finished)
+            async->cond.wait_for(lock,std::chrono::milliseconds(timeout));
+        events.swap(async->events);
+        finished = async->finished;
+    }
+
+    // Unlock the document before emitting the last events, so that their
+    // handlers may change the objects, e.g. to update the colors of a result
+    std::unique_ptr<DocumentP::AsyncRecompute> done;
+    if(finished) {
+        async->worker.join();
+        done = std::move(d->asyncRecompute);
+    }
+
+    // a failing handler must not cost the following ones their events
+    for(auto &ev : events) {
+        try {
+            switch(ev.type) {
+            case DocumentP::AsyncRecompute::Change:
+                onChangedProperty(ev.obj,ev.prop);
+                break;
+            case DocumentP::AsyncRecompute::Recomputed:
+                signalRecomputedObject(*ev.obj);
+                break;
+            }
+        }
+        catch (const Base::Exception& e) {
+            e.ReportException();
+        }
+        catch (const std::exception& e) {
+            FC_ERR("exception while emitting asynchronous recompute results: " << e.what());
+        }
+        catch (...) {
+            FC_ERR("Unknown exception while emitting asynchronous recompute results");
+        }
+    }
+
+    if(!finished)
+        return true;
+
+    if(hasError)
+        *hasError = done->hasError;
+
+    // set by recomputeAsync()
+    try {
+        _finishRecompute(done->objects);
+        signalRecomputed(*this,done->objects);
+    }
+    catch (...) {
+        setStatus(Document::Recomputing,false);
+        throw;
+    }
+    setStatus(Document::Recomputing,false);
+
+    if (d->_RecomputeLog.size())
+        Base::Console().Log("Recompute failed! Please check report view.\n");
+    return false;
+}
+
+void Document::cancelRecompute()
+{
+    if(!testStatus(Document::Recomputing))
+        return;
+    d->recomputeCanceled = true;
+    // let lengthy algorithms checking the sequencer know, e.g. Part::ProgressIndicator
+    if(Base::Sequencer().isRunning())
+        Base::Sequencer().tryToCancel();
+}
+
+bool Document::isRecomputeCanceled() const
+{
+    return d->recomputeCanceled;
+}
+
 /*!
   Does almost the same as topologicalSort() until no object with an input degree of zero
   can be found. It then searches for objects with an output degree of zero until neither
@@ -3704,7 +4274,13 @@ std::vector<App::DocumentObject*> DocumentP::topologicalSort(const std::vector<A
 
 std::vector<App::DocumentObject*> Document::topologicalSort() const
 {
-    return d->topologicalSort(d->objectArray);
+    std::lock_guard<std::mutex> lock(d->dependencyMutex);
+    d->checkDependencyCache();
+    if(!d->topoSortCached) {
+        d->topoSortCache = d->topologicalSort(d->objectArray);
+        d->topoSortCached = true;
+    }
+    return d->topoSortCache;
 }
 
 const char * Document::getErrorDescription(const App::DocumentObject*Obj) const
@@ -3791,6 +4367,7 @@ bool Document::recomputeFeature(DocumentObject* Feat, bool recursive)
 DocumentObject * Document::addObject(const char* sType, const char* pObjectName, 
                                      bool isNew, const char* viewType, bool isPartial)
 {
+    d->checkAsyncLock();
     Base::BaseClass* base = static_cast<Base::BaseClass*>(Base::Type::createInstanceByName(sType,true));
 
     string ObjectName;
@@ -3832,6 +4409,7 @@ DocumentObject * Document::addObject(const char* sType, const char* pObjectName,
     pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
     // insert in the vector
     d->objectArray.push_back(pcObject);
+    d->onObjectAdded(pcObject);
     // insert in the adjacence list and reference through the ConectionMap
     //_DepConMap[pcObject] = add_vertex(_DepList);
 
@@ -3871,6 +4449,7 @@ DocumentObject * Document::addObject(const char* sType, const char* pObjectName,
 
 std::vector<DocumentObject *> Document::addObjects(const char* sType, const std::vector<std::string>& objectNames, bool isNew)
 {
+    d->checkAsyncLock();
     Base::Type::importModule(sType);
     Base::Type type = Base::Type::fromName(sType);
     if (!type.isDerivedFrom(App::DocumentObject::getClassTypeId())) {
@@ -3934,6 +4513,7 @@ std::vector<DocumentObject *> Document::addObjects(const char* sType, const std:
         pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
         // insert in the vector
         d->objectArray.push_back(pcObject);
+        d->onObjectAdded(pcObject);
 
         pcObject->Label.setValue(ObjectName);
 
@@ -3966,6 +4546,7 @@ std::vector<DocumentObject *> Document::addObjects(const char* sType, const std:
 
 void Document::addObject(DocumentObject* pcObject, const char* pObjectName)
 {
+    d->checkAsyncLock();
     if (pcObject->getDocument()) {
         throw Base::RuntimeError("Document object is already added to a document");
     }
@@ -3998,6 +4579,7 @@ void Document::addObject(DocumentObject* pcObject, const char* pObjectName)
     pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
     // insert in the vector
     d->objectArray.push_back(pcObject);
+    d->onObjectAdded(pcObject);
 
     pcObject->Label.setValue( ObjectName );
 
@@ -4025,6 +4607,7 @@ void Document::_addObject(DocumentObject* pcObject, const char* pObjectName)
     if(!pcObject->_Id) pcObject->_Id = ++d->lastObjectId;
     d->objectIdMap[pcObject->_Id] = pcObject;
     d->objectArray.push_back(pcObject);
+    d->onObjectAdded(pcObject);
     // cache the pointer to the name string in the Object (for performance of DocumentObject::getNameInDocument())
     pcObject->pcNameInDocument = &(d->objectMap.find(ObjectName)->first);
 
@@ -4054,6 +4637,7 @@ void Document::_addObject(DocumentObject* pcObject, const char* pObjectName)
 /// Remove an object out of the document
 void Document::removeObject(const char* sName)
 {
+    d->checkAsyncLock();
     auto pos = d->objectMap.find(sName);
 
     // name not found?
@@ -4150,6 +4734,7 @@ void Document::removeObject(const char* sName)
         }
     }
 
+    d->onObjectRemoved(pos->second);
     for (std::vector<DocumentObject*>::iterator obj = d->objectArray.begin(); obj != d->objectArray.end(); ++obj) {
         if (*obj == pos->second) {
             d->objectArray.erase(obj);
@@ -4225,6 +4810,7 @@ void Document::_removeObject(DocumentObject* pcObject)
     d->objectIdMap.erase(pcObject->_Id);
     d->objectMap.erase(pos);
 
+    d->onObjectRemoved(pcObject);
     for (std::vector<DocumentObject*>::iterator it = d->objectArray.begin(); it != d->objectArray.end(); ++it) {
         if (*it == pcObject) {
             d->objectArray.erase(it);
@@ -4522,7 +5108,7 @@ std::string Document::getStandardObjectName(const char *Name, int d) const
 
 std::vector<DocumentObject*> Document::getDependingObjects() const
 {
-    return getDependencyList(d->objectArray);
+    return d->getDependencyList(0);
 }
 
 const std::vector<DocumentObject*> &Document::getObjects() const
@@ -4534,9 +5120,34 @@ const std::vector<DocumentObject*> &Document::getObjects() const
 std::vector<DocumentObject*> Document::getObjectsOfType(const Base::Type& typeId) const
 {
     std::vector<DocumentObject*> Objects;
-    for (std::vector<DocumentObject*>::const_iterator it = d->objectArray.begin(); it != d->objectArray.end(); ++it) {
-        if ((*it)->getTypeId().isDerivedFrom(typeId))
-            Objects.push_back(*it);
+    std::vector<const DocumentP::TypeIndexEntry*> entries;
+    std::size_t count = d->findTypeIndex(typeId, entries);
+    if (count == 0)
+        return Objects;
+
+    Objects.reserve(count);
+    if (entries.size() == 1) {
+        for (auto &v : *entries.front())
+            Objects.push_back(v.second);
+    }
+    else if (count == d->objectArray.size()) {
+        Objects = d->objectArray;
+    }
+    else if (count * 16 < d->objectArray.size()) {
+        // few matches, merge the entries by creation order
+        std::vector<std::pair<unsigned long, DocumentObject*> > merged;
+        merged.reserve(count);
+        for (auto entry : entries)
+            merged.insert(merged.end(), entry->begin(), entry->end());
+        std::sort(merged.begin(), merged.end());
+        for (auto &v : merged)
+            Objects.push_back(v.second);
+    }
+    else {
+        for (std::vector<DocumentObject*>::const_iterator it = d->objectArray.begin(); it != d->objectArray.end(); ++it) {
+            if ((*it)->getTypeId().isDerivedFrom(typeId))
+                Objects.push_back(*it);
+        }
     }
     return Objects;
 }
@@ -4565,32 +5176,26 @@ std::vector<DocumentObject*> Document::findObjects(const Base::Type& typeId, con
 
     std::vector<DocumentObject*> Objects;
     DocumentObject* found = nullptr;
-    for (std::vector<DocumentObject*>::const_iterator it = d->objectArray.begin(); it != d->objectArray.end(); ++it) {
-        if ((*it)->getTypeId().isDerivedFrom(typeId)) {
-            found = *it;
+    std::vector<DocumentObject*> candidates = getObjectsOfType(typeId);
+    for (std::vector<DocumentObject*>::const_iterator it = candidates.begin(); it != candidates.end(); ++it) {
+        found = *it;
 
-            if (!rx_name.empty() && !boost::regex_search((*it)->getNameInDocument(), what, rx_name))
-                found = nullptr;
+        if (!rx_name.empty() && !boost::regex_search((*it)->getNameInDocument(), what, rx_name))
+            found = nullptr;
 
-            if (!rx_label.empty() && !boost::regex_search((*it)->Label.getValue(), what, rx_label))
-                found = nullptr;
+        if (!rx_label.empty() && !boost::regex_search((*it)->Label.getValue(), what, rx_label))
+            found = nullptr;
 
-            if (found)
-                Objects.push_back(found);
-        }
+        if (found)
+            Objects.push_back(found);
     }
     return Objects;
 }
 
 int Document::countObjectsOfType(const Base::Type& typeId) const
 {
-    int ct=0;
-    for (auto it = d->objectMap.begin(); it != d->objectMap.end(); ++it) {
-        if (it->second->getTypeId().isDerivedFrom(typeId))
-            ct++;
-    }
-
-    return ct;
+    std::vector<const DocumentP::TypeIndexEntry*> entries;
+    return static_cast<int>(d->findTypeIndex(typeId, entries));
 }
 
 PyObject * Document::getPyObject(void)
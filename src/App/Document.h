@@ -128,10 +128,24 @@ public:
     //boost::signals2::signal<void (const App::DocumentObject&)>     m_sig;
     /// signal on deleted Object
     boost::signals2::signal<void (const App::DocumentObject&)> signalDeletedObject;
-    /// signal before changing an Object
+    /// signal before changing an Object, not emitted for changes made by recomputeAsync()
     boost::signals2::signal<void (const App::DocumentObject&, const App::Property&)> signalBeforeChangeObject;
     /// signal on changed Object
     boost::signals2::signal<void (const App::DocumentObject&, const App::Property&)> signalChangedObject;
+    /** signal on changed Objects, once per closed change batch (see
+     * openChangeBatch()). Changes outside of a batch are only notified by
+     * signalChangedObject.
+     *
+     * The changes of a batch are also emitted one by one by
+     * signalChangedObject before, because most observers, e.g. the view
+     * providers, the tree view and the expression bindings, only handle
+     * single changes and would miss them otherwise. An observer connected to
+     * both signals must ignore signalChangedObject while
+     * isDeliveringChangeBatch() is true, as the property view and the Python
+     * document observers with a slotChangedObjects() do.
+     */
+    boost::signals2::signal<void (const App::Document&,
+            const std::vector<std::pair<const App::DocumentObject*, const App::Property*> >&)> signalChangedObjects;
     /// signal on manually called DocumentObject::touch()
     boost::signals2::signal<void (const App::DocumentObject&)> signalTouchedObject;
     /// signal on relabeled Object
@@ -169,6 +183,11 @@ public:
     boost::signals2::signal<void (const App::Document&)> signalBeforeRecompute;
     boost::signals2::signal<void (const App::Document&, const std::vector<App::DocumentObject*>&)> signalRecomputed;
     boost::signals2::signal<void (const App::DocumentObject&)> signalRecomputedObject;
+    /** signal new results of an asynchronous recompute, see recomputeAsync()
+     * @note This signal is emitted from the worker thread, connected slots
+     * shall only wake up the owner thread to call processAsyncRecompute().
+     */
+    boost::signals2::signal<void (const App::Document&)> signalAsyncRecomputeReady;
     //signal a new opened transaction
     boost::signals2::signal<void (const App::Document&, std::string)> signalOpenTransaction;
     // signal a committed transaction
@@ -347,6 +366,53 @@ public:
             bool force=false,bool *hasError=0, int options=0);
     /// Recompute only one feature
     bool recomputeFeature(DocumentObject* Feat,bool recursive=false);
+    /** Start recomputing touched features on a worker thread
+     *
+     * The objects to recompute are sorted on the calling thread, which
+     * becomes the owner of the recompute. Notifications raised by the
+     * features while recomputing are not emitted on the worker thread, but
+     * queued object by object, each one once the object is done. The owner
+     * thread emits them by calling processAsyncRecompute() until it returns
+     * false, see also signalAsyncRecomputeReady. signalBeforeChangeObject
+     * is not emitted for the changes made by the worker, because they can't
+     * wait for the owner thread.
+     *
+     * The document is locked until then. Saving it, adding or removing
+     * objects, and changing the properties of its objects other than those
+     * with Property::Output status throws Base::RuntimeError. View provider
+     * properties may be changed, and the notifications emitted by the final
+     * processAsyncRecompute() call come after the document is unlocked. Transactions, undo and redo are
+     * refused. The pending transaction is opened right away and receives the
+     * changes of the recompute. Features recomputed this way can't add or
+     * remove objects.
+     *
+     * @return false if no recompute is started, e.g. during undo/redo or if
+     * another recompute is running.
+     */
+    bool recomputeAsync(const std::vector<App::DocumentObject*> &objs={},
+            bool force=false, int options=0);
+    /// Check if an asynchronous recompute is running or has pending results
+    bool hasAsyncRecompute() const;
+    /** Emit the queued notifications of an asynchronous recompute
+     *
+     * @param timeout: milliseconds to wait for new results if there are none
+     * @param hasError: optional output whether any object failed to recompute
+     *
+     * @return true while the recompute is running, false once it is finished
+     * and the document has left the Recomputing status.
+     */
+    bool processAsyncRecompute(int timeout=0, bool *hasError=0);
+    /** Request the running recompute to stop
+     *
+     * It is checked before each object and by lengthy algorithms polling
+     * Base::Sequencer().wasCanceled(). Within OCC only the Boolean operations
+     * of several shapes (Part::TopoShape::cut(), common(), fuse() and
+     * section() with a list of shapes, and generalFuse()) poll it, and only
+     * with OCC 7.2 to 7.4. All other OCC algorithms run to their end.
+     */
+    void cancelRecompute();
+    /// Check if cancelRecompute() was called for the running recompute
+    bool isRecomputeCanceled() const;
     /// get the text of the error of a specified object
     const char* getErrorDescription(const App::DocumentObject*) const;
     /// return the status bits
@@ -402,9 +468,9 @@ public:
     /// If no transaction is open true is returned.
     bool isTransactionEmpty() const;
     /// Set the Undo limit in Byte!
-    void setUndoLimit(unsigned int UndoMemSize=0);
+    void setUndoLimit(std::size_t UndoMemSize=0);
     /// Returns the actual memory consumption of the Undo redo stuff.
-    unsigned int getUndoMemSize (void) const;
+    std::size_t getUndoMemSize (void) const;
     /// Set the Undo limit as stack size
     void setMaxUndoStackSize(unsigned int UndoMaxStackSize=20);
     /// Set the Undo limit as stack size
@@ -429,6 +495,26 @@ public:
     void addOrRemovePropertyOfObject(TransactionalObject*, Property *prop, bool add);
     //@}
 
+    /** @name Batched change notification */
+    //@{
+    /** Open a change batch
+     *
+     * While a batch is open signalChangedObject is not emitted right away.
+     * The changes are collected, each property only once, and delivered in
+     * the order of their first change when the outermost batch is closed,
+     * followed by a single signalChangedObjects. Batches can be nested.
+     *
+     * @sa ChangeBatchLocker
+     */
+    void openChangeBatch();
+    /// Close a change batch opened by openChangeBatch() and deliver its changes
+    void closeChangeBatch();
+    /// Check if a change batch is open
+    bool hasChangeBatch() const;
+    /// Check if signalChangedObject is emitted for a change of a closed batch
+    bool isDeliveringChangeBatch() const;
+    //@}
+
     /** @name dependency stuff */
     //@{
     /// write GraphViz file
@@ -536,6 +622,15 @@ protected:
     /// helper which Recompute only this feature
     /// @return 0 if succeeded, 1 if failed, -1 if aborted by user.
     int _recomputeFeature(DocumentObject* Feat);
+    /** @name recompute steps shared by recompute() and recomputeAsync() */
+    //@{
+    bool _canRecompute(const std::vector<App::DocumentObject*> &objs, bool force);
+    std::vector<App::DocumentObject*> _prepareRecompute(
+            const std::vector<App::DocumentObject*> &objs, int options);
+    /// the part of the recompute that recomputeAsync() runs on the worker thread
+    int _recomputeObjects(const std::vector<App::DocumentObject*> &objs, bool *hasError);
+    void _finishRecompute(const std::vector<App::DocumentObject*> &objs);
+    //@}
     void _clearRedos();
 
     /// refresh the internal dependency graph
@@ -575,6 +670,17 @@ private:
     std::string myName;
 };
 
+/// Helper class to open a change batch for the lifetime of a scope
+class AppExport ChangeBatchLocker
+{
+public:
+    ChangeBatchLocker(Document *doc);
+    ~ChangeBatchLocker();
+
+private:
+    Document *doc;
+};
+
 template<typename T>
 inline std::vector<T*> Document::getObjectsOfType() const
 {
@@ -42,6 +42,8 @@
 #include "DocumentObjectExtension.h"
 #include "GeoFeatureGroupExtension.h"
 #include <App/DocumentObjectPy.h>
+#include <atomic>
+#include <mutex>
 #include <boost/bind/bind.hpp>
 
 FC_LOG_LEVEL_INIT("App",true,true)
@@ -57,6 +59,15 @@ PROPERTY_SOURCE(App::DocumentObject, App::TransactionalObject)
 
 DocumentObjectExecReturn *DocumentObject::StdReturn = 0;
 
+// Starts above the initial generation of the caches so that they are invalid.
+// Links may be changed while another thread recomputes, see Document::recomputeAsync()
+static std::atomic<unsigned long> _DependencyGeneration(1);
+
+// The recursive in and out lists are cached per object until the generation
+// changes. Only the objects that are queried keep their lists. Links may be
+// queried while another thread recomputes, so the caches are guarded.
+static std::mutex _RecursiveListMutex;
+
 //===========================================================================
 // DocumentObject
 //===========================================================================
@@ -380,10 +391,9 @@ std::vector<App::DocumentObject*> DocumentObject::getInListRecursive(void) const
 // problem.
 
 std::vector<App::DocumentObject*> DocumentObject::getInListRecursive(void) const {
-    std::set<App::DocumentObject*> inSet;
-    std::vector<App::DocumentObject*> res;
-    getInListEx(inSet,true,&res);
-    return res;
+    std::lock_guard<std::mutex> lock(_RecursiveListMutex);
+    _updateInListRecursive();
+    return _inListRecursive;
 }
 
 #endif
@@ -478,6 +488,29 @@ void _getOutListRecursive(std::set<DocumentObject*>& objSet,
 
 std::vector<App::DocumentObject*> DocumentObject::getOutListRecursive(void) const
 {
+    std::lock_guard<std::mutex> lock(_RecursiveListMutex);
+    _updateOutListRecursive();
+    return _outListRecursive;
+}
+
+void DocumentObject::_updateInListRecursive() const
+{
+    // read before collecting, a change meanwhile leaves the cache invalid
+    unsigned long generation = _DependencyGeneration;
+    if(_inListRecursiveGeneration == generation)
+        return;
+    std::set<App::DocumentObject*> inSet;
+    _inListRecursive.clear();
+    getInListEx(inSet,true,&_inListRecursive);
+    _inListRecursiveSorted.assign(inSet.begin(),inSet.end());
+    _inListRecursiveGeneration = generation;
+}
+
+void DocumentObject::_updateOutListRecursive() const
+{
+    unsigned long generation = _DependencyGeneration;
+    if(_outListRecursiveGeneration == generation)
+        return;
     // number of objects in document is a good estimate in result size
     int maxDepth = GetApplication().checkLinkDepth(0);
     std::set<App::DocumentObject*> result;
@@ -485,44 +518,17 @@ std::vector<App::DocumentObject*> DocumentObject::getOutListRecursive(void) cons
     // using a recursive helper to collect all OutLists
     _getOutListRecursive(result, this, this, maxDepth);
 
-    std::vector<App::DocumentObject*> array;
-    array.insert(array.begin(), result.begin(), result.end());
-    return array;
-}
-
-// helper for isInInListRecursive()
-bool _isInInListRecursive(const DocumentObject* act,
-                          const DocumentObject* checkObj, int depth)
-{
-#ifndef  USE_OLD_DAG
-    for (auto obj : act->getInList()) {
-        if (obj == checkObj)
-            return true;
-        // if we reach the depth limit we have a cycle!
-        if (depth <= 0) {
-            throw Base::BadGraphError("DocumentObject::isInInListRecursive(): cyclic dependency detected!");
-        }
-
-        if (_isInInListRecursive(obj, checkObj, depth - 1))
-            return true;
-    }
-#else
-    (void)act;
-    (void)checkObj;
-    (void)depth;
-#endif
-
-    return false;
+    _outListRecursive.assign(result.begin(), result.end());
+    _outListRecursiveGeneration = generation;
 }
 
 bool DocumentObject::isInInListRecursive(DocumentObject *linkTo) const
 {
-#if 0
-    int maxDepth = getDocument()->countObjects() + 2;
-    return _isInInListRecursive(this, linkTo, maxDepth);
-#else
-    return this==linkTo || getInListEx(true).count(linkTo);
-#endif
+    if(this==linkTo)
+        return true;
+    std::lock_guard<std::mutex> lock(_RecursiveListMutex);
+    _updateInListRecursive();
+    return std::binary_search(_inListRecursiveSorted.begin(),_inListRecursiveSorted.end(),linkTo);
 }
 
 bool DocumentObject::isInInList(DocumentObject *linkTo) const
@@ -538,35 +544,11 @@ bool DocumentObject::isInInList(DocumentObject *linkTo) const
 #endif
 }
 
-// helper for isInOutListRecursive()
-bool _isInOutListRecursive(const DocumentObject* act,
-                           const DocumentObject* checkObj, int depth)
-{
-#ifndef  USE_OLD_DAG
-    for (auto obj : act->getOutList()) {
-        if (obj == checkObj)
-            return true;
-        // if we reach the depth limit we have a cycle!
-        if (depth <= 0) {
-            throw Base::BadGraphError("DocumentObject::isInOutListRecursive(): cyclic dependency detected!");
-        }
-
-        if (_isInOutListRecursive(obj, checkObj, depth - 1))
-            return true;
-    }
-#else
-    (void)act;
-    (void)checkObj;
-    (void)depth;
-#endif
-
-    return false;
-}
-
 bool DocumentObject::isInOutListRecursive(DocumentObject *linkTo) const
 {
-    int maxDepth = getDocument()->countObjects() + 2;
-    return _isInOutListRecursive(this, linkTo, maxDepth);
+    std::lock_guard<std::mutex> lock(_RecursiveListMutex);
+    _updateOutListRecursive();
+    return std::binary_search(_outListRecursive.begin(),_outListRecursive.end(),linkTo);
 }
 
 std::vector<std::list<App::DocumentObject*> >
@@ -747,6 +729,15 @@ void DocumentObject::clearOutListCache() const {
     _outList.clear();
     _outListMap.clear();
     _outListCached = false;
+    _invalidateDependencies();
+}
+
+unsigned long DocumentObject::getDependencyGeneration() {
+    return _DependencyGeneration;
+}
+
+void DocumentObject::_invalidateDependencies() {
+    ++_DependencyGeneration;
 }
 
 PyObject *DocumentObject::getPyObject(void)
@@ -973,6 +964,7 @@ void App::DocumentObject::_removeBackLink(DocumentObject* rmvObj)
     auto it = std::find(_inList.begin(), _inList.end(), rmvObj);
     if(it != _inList.end())
         _inList.erase(it);
+    _invalidateDependencies();
 #else
     (void)rmvObj;
 #endif
@@ -986,6 +978,7 @@ void App::DocumentObject::_addBackLink(DocumentObject* newObj)
     //this removal would clear the object from the inlist, even though there may be other link properties 
     //from this object that link to us.
     _inList.push_back(newObj);
+    _invalidateDependencies();
 #else
     (void)newObj;
 #endif //USE_OLD_DAG    
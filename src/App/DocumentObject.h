@@ -229,6 +229,15 @@ public:
     std::vector<App::DocumentObject*> getOutListRecursive(void) const;
     /// clear internal out list cache
     void clearOutListCache() const;
+    /** Return a number that changes whenever a link between any objects
+     * changes, or objects are added to or removed from a document. It is used
+     * to validate cached dependency information, e.g. the dependency list of a
+     * document, see Document::getDependingObjects(), or the recursive in and
+     * out lists of an object.
+     */
+    static unsigned long getDependencyGeneration();
+    /// internal, invalidate all cached dependency information
+    static void _invalidateDependencies();
     /// get all possible paths from this to another object following the OutList
     std::vector<std::list<App::DocumentObject*> > getPathsByOutList(App::DocumentObject* to) const;
 #ifdef USE_OLD_DAG
@@ -631,6 +640,16 @@ private:
     mutable std::vector<App::DocumentObject *> _outList;
     mutable std::unordered_map<const char *, App::DocumentObject*, CStringHasher, CStringHasher> _outListMap;
     mutable bool _outListCached = false;
+
+    // recursive lists, cached until getDependencyGeneration() changes
+    mutable std::vector<App::DocumentObject*> _inListRecursive;
+    mutable std::vector<App::DocumentObject*> _inListRecursiveSorted;
+    mutable std::vector<App::DocumentObject*> _outListRecursive;
+    mutable unsigned long _inListRecursiveGeneration = 0;
+    mutable unsigned long _outListRecursiveGeneration = 0;
+
+    void _updateInListRecursive() const;
+    void _updateOutListRecursive() const;
 };
 
 } //namespace App
@@ -767,7 +767,7 @@ int DocumentObjectPy::setCustomAttributes(const char* attr, PyObject *obj)
     }
 
     // search in PropertyList
-    Property *prop = getDocumentObjectPtr()->getPropertyByName(attr);
+    Property *prop = getDocumentObjectPtr()->getPropertyByName(PropertyAtom(attr));
     if (prop) {
         // Read-only attributes must not be set over its Python interface
         if(prop->testStatus(Property::Immutable) ||
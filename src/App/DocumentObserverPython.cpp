@@ -98,6 +98,7 @@ DocumentObserverPython::DocumentObserverPython(const Py::Object& obj) : inst(obj
     FC_PY_ELEMENT_ARG1(DeletedObject, DeletedObject)
     FC_PY_ELEMENT_ARG2(BeforeChangeObject, BeforeChangeObject)
     FC_PY_ELEMENT_ARG2(ChangedObject, ChangedObject)
+    FC_PY_ELEMENT_ARG2(ChangedObjects, ChangedObjects)
     FC_PY_ELEMENT_ARG1(RecomputedObject, ObjectRecomputed)
     FC_PY_ELEMENT_ARG1(BeforeRecomputeDocument, BeforeRecomputeDocument)
     FC_PY_ELEMENT_ARG1(RecomputedDocument, Recomputed)
@@ -350,6 +351,13 @@ void DocumentObserverPython::slotBeforeChangeObject(const App::DocumentObject& O
 void DocumentObserverPython::slotChangedObject(const App::DocumentObject& Obj,
                                                const App::Property& Prop)
 {
+    // an observer handling whole batches gets their changes only once
+    if (!pyChangedObjects.py.isNone()) {
+        auto doc = Obj.getDocument();
+        if (doc && doc->isDeliveringChangeBatch())
+            return;
+    }
+
     Base::PyGILStateLocker lock;
     try {
         Py::Tuple args(2);
@@ -368,6 +376,35 @@ void DocumentObserverPython::slotChangedObject(const App::DocumentObject& Obj,
     }
 }
 
+void DocumentObserverPython::slotChangedObjects(const App::Document& Doc,
+        const std::vector<std::pair<const App::DocumentObject*, const App::Property*> >& Changes)
+{
+    Base::PyGILStateLocker lock;
+    try {
+        Py::List changes;
+        for (auto &v : Changes) {
+            // same as slotChangedObject(), skip properties without a name
+            const char* prop_name = v.first->getPropertyName(v.second);
+            if (!prop_name)
+                continue;
+            Py::Tuple change(2);
+            change.setItem(0, Py::Object(const_cast<App::DocumentObject*>(v.first)->getPyObject(), true));
+            change.setItem(1, Py::String(prop_name));
+            changes.append(change);
+        }
+        if (changes.size()) {
+            Py::Tuple args(2);
+            args.setItem(0, Py::Object(const_cast<App::Document&>(Doc).getPyObject(), true));
+            args.setItem(1, changes);
+            Base::pyCall(pyChangedObjects.ptr(),args.ptr());
+        }
+    }
+    catch (Py::Exception&) {
+        Base::PyException e; // extract the Python error text
+        e.ReportException();
+    }
+}
+
 void DocumentObserverPython::slotRecomputedObject(const App::DocumentObject& Obj)
 {
     Base::PyGILStateLocker lock;
@@ -73,6 +73,9 @@ private:
     void slotBeforeChangeObject(const App::DocumentObject& Obj, const App::Property& Prop);
     /** The property of an observed object has changed */
     void slotChangedObject(const App::DocumentObject& Obj, const App::Property& Prop);
+    /** The properties of observed objects have changed, once per change batch */
+    void slotChangedObjects(const App::Document& Doc,
+            const std::vector<std::pair<const App::DocumentObject*, const App::Property*> >& Changes);
     /** Undoes the last transaction of the document */
     void slotUndoDocument(const App::Document& Doc);
     /** Redoes the last undone transaction of the document */
@@ -137,6 +140,7 @@ private:
     Connection pyDeletedObject;
     Connection pyBeforeChangeObject;
     Connection pyChangedObject;
+    Connection pyChangedObjects;
     Connection pyRecomputedObject;
     Connection pyBeforeRecomputeDocument;
     Connection pyRecomputedDocument;
@@ -439,6 +439,24 @@ PyObject*  DocumentPy::commitTransaction(PyObject * args)
     Py_Return;
 }
 
+PyObject*  DocumentPy::openChangeBatch(PyObject * args)
+{
+    if (!PyArg_ParseTuple(args, ""))
+        return NULL;
+    getDocumentPtr()->openChangeBatch();
+    Py_Return;
+}
+
+PyObject*  DocumentPy::closeChangeBatch(PyObject * args)
+{
+    if (!PyArg_ParseTuple(args, ""))
+        return NULL;
+    PY_TRY {
+        getDocumentPtr()->closeChangeBatch();
+        Py_Return;
+    } PY_CATCH;
+}
+
 Py::Boolean DocumentPy::getHasPendingTransaction() const {
     return Py::Boolean(getDocumentPtr()->hasPendingTransaction());
 }
@@ -512,6 +530,62 @@ PyObject*  DocumentPy::recompute(PyObject * args)
     } PY_CATCH;
 }
 
+PyObject*  DocumentPy::recomputeAsync(PyObject * args)
+{
+    PyObject *pyobjs = Py_None;
+    PyObject *force = Py_False;
+    PyObject *checkCycle = Py_False;
+    if (!PyArg_ParseTuple(args, "|OO!O!",&pyobjs,
+                &PyBool_Type,&force,&PyBool_Type,&checkCycle))
+        return nullptr;
+
+    PY_TRY {
+        std::vector<App::DocumentObject *> objs;
+        if (pyobjs!=Py_None) {
+            if (!PySequence_Check(pyobjs)) {
+                PyErr_SetString(PyExc_TypeError, "expect input of sequence of document objects");
+                return nullptr;
+            }
+
+            Py::Sequence seq(pyobjs);
+            for (size_t i=0;i<seq.size();++i) {
+                if (!PyObject_TypeCheck(seq[i].ptr(), &DocumentObjectPy::Type)) {
+                    PyErr_SetString(PyExc_TypeError, "Expect element in sequence to be of type document object");
+                    return nullptr;
+                }
+                objs.push_back(static_cast<DocumentObjectPy*>(seq[i].ptr())->getDocumentObjectPtr());
+            }
+        }
+
+        int options = 0;
+        if (PyObject_IsTrue(checkCycle))
+            options = Document::DepNoCycle;
+
+        bool started = getDocumentPtr()->recomputeAsync(objs, PyObject_IsTrue(force), options);
+        return Py::new_reference_to(Py::Boolean(started));
+    } PY_CATCH;
+}
+
+PyObject*  DocumentPy::processAsyncRecompute(PyObject * args)
+{
+    int timeout = 0;
+    if (!PyArg_ParseTuple(args, "|i", &timeout))
+        return nullptr;
+
+    PY_TRY {
+        bool running = getDocumentPtr()->processAsyncRecompute(timeout);
+        return Py::new_reference_to(Py::Boolean(running));
+    } PY_CATCH;
+}
+
+PyObject*  DocumentPy::cancelRecompute(PyObject * args)
+{
+    if (!PyArg_ParseTuple(args, ""))
+        return nullptr;
+    getDocumentPtr()->cancelRecompute();
+    Py_Return;
+}
+
 PyObject*  DocumentPy::getObject(PyObject *args)
 {
     long id = -1;
@@ -651,7 +725,7 @@ void  DocumentPy::setUndoMode(Py::Int arg)
 
 Py::Int DocumentPy::getUndoRedoMemSize(void) const
 {
-    return Py::Int((long)getDocumentPtr()->getUndoMemSize());
+    return Py::Int(static_cast<unsigned PY_LONG_LONG>(getDocumentPtr()->getUndoMemSize()));
 }
 
 Py::Int DocumentPy::getUndoCount(void) const
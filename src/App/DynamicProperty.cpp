@@ -80,6 +80,17 @@ Property *DynamicProperty::getDynamicPropertyByName(const char* name) const
     return 0;
 }
 
+Property *DynamicProperty::getDynamicPropertyByName(const PropertyAtom &name) const
+{
+    if (props.empty())
+        return 0;
+    auto &index = props.get<0>();
+    auto it = index.find(name, PropertyAtom::Hasher(), PropertyAtom::Hasher());
+    if (it != index.end())
+        return it->property;
+    return 0;
+}
+
 std::vector<std::string> DynamicProperty::getDynamicPropertyNames() const
 {
     std::vector<std::string> names;
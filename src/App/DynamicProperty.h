@@ -61,6 +61,59 @@ struct CStringHasher {
     }
 };
 
+/** A property name together with its hash
+ *
+ * The name is hashed once when the atom is created. Looking up a property by
+ * an atom in the dynamic, static and extension property tables doesn't hash
+ * the name again. Nothing is stored for the name, the registered names are
+ * only kept by the property tables, so the atom refers to the passed string
+ * and must not outlive it.
+ */
+class AppExport PropertyAtom
+{
+public:
+    PropertyAtom() : name(0), hash(0) {}
+    explicit PropertyAtom(const char *name)
+        : name(name), hash(CStringHasher()(name)) {}
+    explicit PropertyAtom(const std::string &name)
+        : PropertyAtom(name.c_str()) {}
+    explicit PropertyAtom(std::string &&) = delete;
+
+    const char *getName() const {
+        return name;
+    }
+    /// the hash of the name, equal to the one of CStringHasher
+    std::size_t getHash() const {
+        return hash;
+    }
+    bool isNull() const {
+        return !name;
+    }
+    bool operator==(const PropertyAtom &other) const {
+        return hash == other.hash && CStringHasher()(name, other.name);
+    }
+    bool operator!=(const PropertyAtom &other) const {
+        return !(*this == other);
+    }
+
+    /// hash and equality functor to search C string keys by an atom
+    struct Hasher {
+        inline std::size_t operator()(const PropertyAtom &atom) const {
+            return atom.getHash();
+        }
+        inline bool operator()(const PropertyAtom &atom, const char *s) const {
+            return CStringHasher()(atom.getName(), s);
+        }
+        inline bool operator()(const char *s, const PropertyAtom &atom) const {
+            return CStringHasher()(s, atom.getName());
+        }
+    };
+
+private:
+    const char *name;
+    std::size_t hash;
+};
+
 /** This class implements an interface to add properties at run-time to an object
  * derived from PropertyContainer. The additional properties are made persistent.
  * @author Werner Mayer
@@ -79,6 +132,8 @@ public:
     void getPropertyMap(std::map<std::string,Property*> &Map) const;
     /// Find a dynamic property by its name
     Property *getDynamicPropertyByName(const char* name) const;
+    /// Find a dynamic property by its name and precomputed hash
+    Property *getDynamicPropertyByName(const PropertyAtom &name) const;
     /*!
       Add a dynamic property of the type @a type and with the name @a name.
       @a Group gives the grouping name which appears in the property editor and
@@ -126,6 +126,12 @@ Property* Extension::extensionGetPropertyByName(const char* name) const {
     return extensionGetPropertyData().getPropertyByName(this, name);
 }
 
+Property* Extension::extensionGetPropertyByName(const PropertyAtom &name) const {
+
+    // go through the name lookup, which subclasses may override alone
+    return extensionGetPropertyByName(name.getName());
+}
+
 short int Extension::extensionGetPropertyType(const Property* prop) const {
     
     return extensionGetPropertyData().getType(this, prop);
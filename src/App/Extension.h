@@ -251,6 +251,9 @@ public:
     //@{
     /// find a property by its name
     virtual Property *extensionGetPropertyByName(const char* name) const;
+    /// find a property by its name and precomputed hash, by default the same
+    /// as extensionGetPropertyByName(name.getName())
+    virtual Property *extensionGetPropertyByName(const PropertyAtom &name) const;
     /// get the name of a property
     virtual const char* extensionGetPropertyName(const Property* prop) const;
     /// get all properties of the class (including properties of the parent)
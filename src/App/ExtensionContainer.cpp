@@ -156,12 +156,13 @@ void ExtensionContainer::getPropertyMap(std::map< std::string, Property* >& Map)
 }
 
 Property* ExtensionContainer::getPropertyByName(const char* name) const {
-    auto prop = App::PropertyContainer::getPropertyByName(name);
+    PropertyAtom atom(name);
+    auto prop = findOwnProperty(atom);
     if(prop)
         return prop;
     
     for(auto entry : _extensions) {            
-        auto prop = entry.second->extensionGetPropertyByName(name);
+        auto prop = entry.second->extensionGetPropertyByName(atom);
         if(prop)
             return prop;
     }
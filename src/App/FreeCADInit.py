@@ -130,12 +130,15 @@ def InitApplications():
 	# proper python modules this can eventuelly be removed.
 	sys.path = [ModDir] + libpaths + [ExtDir] + sys.path
 
+	Profiler = FreeCAD.__startup_profiler__
+
 	for Dir in ModDict.values():
 		if ((Dir != '') & (Dir != 'CVS') & (Dir != '__init__.py')):
 			sys.path.insert(0,Dir)
 			PathExtension.append(Dir)
 			InstallFile = os.path.join(Dir,"Init.py")
 			if (os.path.exists(InstallFile)):
+				if Profiler: Start = Profiler.timer()
 				try:
 					# XXX: This looks scary securitywise...
 
@@ -148,8 +151,10 @@ def InitApplications():
 					Log('-'*100+'\n')
 					Err('During initialization the error "' + str(inst) + '" occurred in ' + InstallFile + '\n')
 					Err('Please look into the log file for further information\n')
+					if Profiler: Profiler.add('Init.py', Dir, Profiler.timer() - Start, 'failed')
 				else:
 					Log('Init:      Initializing ' + Dir + '... done\n')
+					if Profiler: Profiler.add('Init.py', Dir, Profiler.timer() - Start, 'exec')
 			else:
 				Log('Init:      Initializing ' + Dir + '(Init.py not found)... ignore\n')
 
@@ -162,6 +167,7 @@ def InitApplications():
 		for _, freecad_module_name, freecad_module_ispkg in pkgutil.iter_modules(freecad.__path__, "freecad."):
 			if freecad_module_ispkg:
 				Log('Init: Initializing ' + freecad_module_name + '\n')
+				if Profiler: Start = Profiler.timer()
 				try:
 					freecad_module = importlib.import_module(freecad_module_name)
 					extension_modules += [freecad_module_name]
@@ -170,7 +176,9 @@ def InitApplications():
 						Log('Init: Initializing ' + freecad_module_name + '... done\n')
 					else:
 						Log('Init: No init module found in ' + freecad_module_name + ', skipping\n')
+					if Profiler: Profiler.add('Init.py', freecad_module_name, Profiler.timer() - Start, 'exec')
 				except Exception as inst:
+					if Profiler: Profiler.add('Init.py', freecad_module_name, Profiler.timer() - Start, 'failed')
 					Err('During initialization the error "' + str(inst) + '" occurred in ' + freecad_module_name + '\n')
 					Err('-'*80+'\n')
 					Err(traceback.format_exc())
@@ -618,6 +626,85 @@ class FCADLogger(object):
 
 FreeCAD.Logger = FCADLogger
 
+class ChangeBatch(object):
+    '''Context manager to batch property change notifications of a document
+
+        with FreeCAD.ChangeBatch(doc):
+            for obj in objs:
+                obj.Placement = placement
+
+    Observers are notified once per changed property when the block is left,
+    see Document.openChangeBatch().
+    '''
+
+    def __init__(self, doc=None):
+        self.doc = doc if doc else FreeCAD.ActiveDocument
+
+    def __enter__(self):
+        self.doc.openChangeBatch()
+        return self.doc
+
+    def __exit__(self, tp, value, tb):
+        self.doc.closeChangeBatch()
+
+FreeCAD.ChangeBatch = ChangeBatch
+
+class StartupProfiler(object):
+    '''Collects the time spent to initialize each module during start-up.
+
+       The profiler is only created when the application is started with
+       --profile-startup. Each phase (App Init.py, Gui InitGui.py) adds one
+       entry per module and the report is rewritten after each phase, so
+       that it is complete even if the GUI is never started.
+
+       Every Init.py and InitGui.py is still executed eagerly. There is no
+       lazy initialization of the modules yet; use the report to find the
+       modules it would pay off for.
+    '''
+
+    def __init__(self, filename):
+        from timeit import default_timer
+        self.timer = default_timer
+        self.filename = filename
+        self.entries = []
+        self.started = self.timer()
+
+    @classmethod
+    def create(cls):
+        filename = FreeCAD.ConfigGet("ProfileStartup")
+        if not filename:
+            return None
+        return cls(filename)
+
+    def add(self, phase, module, seconds, how):
+        '''Add a timing entry, how is 'exec' or 'failed'.'''
+        self.entries.append((phase, module, seconds, how))
+
+    def write(self):
+        phases = []
+        for entry in self.entries:
+            if entry[0] not in phases:
+                phases.append(entry[0])
+        lines = ['FreeCAD start-up profile, {:.3f} s since App init\n'.format(
+                    self.timer() - self.started)]
+        for phase in phases:
+            entries = sorted([e for e in self.entries if e[0] == phase],
+                             key=lambda e: e[2], reverse=True)
+            lines.append('\n[{}] {} modules, {:.3f} s\n'.format(
+                phase, len(entries), sum(e[2] for e in entries)))
+            for _, module, seconds, how in entries:
+                lines.append('  {:10.3f} ms  {:<7} {}\n'.format(seconds*1000.0, how, module))
+        try:
+            with open(self.filename, 'w') as f:
+                f.writelines(lines)
+        except (IOError, OSError) as e:
+            Wrn('Cannot write start-up profile ' + self.filename + ': ' + str(e) + '\n')
+        else:
+            Log('Init: Start-up profile written to ' + self.filename + '\n')
+
+
+FreeCAD.__startup_profiler__ = StartupProfiler.create()
+
 # init every application by importing Init.py
 try:
 	import traceback
@@ -845,8 +932,12 @@ class Scheme(IntEnum):
 
 App.Units.Scheme = Scheme
 
+if FreeCAD.__startup_profiler__:
+    FreeCAD.__startup_profiler__.write()
+
 # clean up namespace
 del(InitApplications)
+del(StartupProfiler)
 del(test_ascii)
 
 Log ('Init: App::FreeCADInit.py done\n')
@@ -1271,7 +1271,9 @@ Property *ObjectIdentifier::resolveProperty(const App::DocumentObject *obj,
         return &const_cast<App::DocumentObject*>(obj)->Label; //fake the property
     }
 
-    auto prop = obj->getPropertyByName(propertyName);
+    // the name may be looked up a second time in the linked object
+    PropertyAtom name(propertyName);
+    auto prop = obj->getPropertyByName(name);
     if(prop && !prop->testStatus(Property::Hidden) && !(prop->getType() & PropertyType::Prop_Hidden))
         return prop;
 
@@ -1285,7 +1287,7 @@ Property *ObjectIdentifier::resolveProperty(const App::DocumentObject *obj,
             return prop;
     }
 
-    auto linkedProp = linked->getPropertyByName(propertyName);
+    auto linkedProp = linked->getPropertyByName(name);
     return linkedProp?linkedProp:prop;
 }
 
@@ -231,6 +231,16 @@ public:
     virtual Property *Copy(void) const = 0;
     /// Paste the value from the property (mainly for Undo/Redo and transactions)
     virtual void Paste(const Property &from) = 0;
+    /** Returns the copy of the property kept by a transaction. Unlike Copy()
+     * it may share the data with this property, as long as neither of them
+     * changes the shared data in place. The default is a Copy().
+     */
+    virtual Property *copyForTransaction(void) const { return Copy(); }
+    /** Returns the memory that is freed together with this property. Data
+     * that is still referenced elsewhere, e.g. by the property a copy for a
+     * transaction was made from, isn't counted. The default is getMemSize().
+     */
+    virtual unsigned int getUnsharedMemSize(void) const { return getMemSize(); }
 
     /// Called when a child property has changed value
     virtual void hasSetChildValue(Property &) {}
@@ -83,6 +83,17 @@ App::Property* PropertyContainer::addDynamicProperty(
 }
 
 Property *PropertyContainer::getPropertyByName(const char* name) const
+{
+    return findOwnProperty(PropertyAtom(name));
+}
+
+Property *PropertyContainer::getPropertyByName(const PropertyAtom &name) const
+{
+    // go through the name lookup, which subclasses may override alone
+    return getPropertyByName(name.getName());
+}
+
+Property *PropertyContainer::findOwnProperty(const PropertyAtom &name) const
 {
     auto prop = dynamicProps.getDynamicPropertyByName(name);
     if(prop) return prop;
@@ -334,7 +345,7 @@ void PropertyContainer::Restore(Base::XMLReader &reader)
         std::string TypeName = reader.getAttribute("type");
         auto prop = dynamicProps.restore(*this,PropName.c_str(),TypeName.c_str(),reader);
         if(!prop)
-            prop = getPropertyByName(PropName.c_str());
+            prop = getPropertyByName(PropertyAtom(PropName));
 
         decltype(Property::StatusBits) status;
         if(reader.hasAttribute("status")) {
@@ -475,6 +486,17 @@ const PropertyData::PropertySpec *PropertyData::findProperty(OffsetBase offsetBa
     return 0;
 }
 
+const PropertyData::PropertySpec *PropertyData::findProperty(OffsetBase offsetBase,const PropertyAtom &PropName) const
+{
+    (void)offsetBase;
+    merge();
+    auto &index = propertyData.get<1>();
+    auto it = index.find(PropName, PropertyAtom::Hasher(), PropertyAtom::Hasher());
+    if(it != index.end())
+        return &(*it);
+    return 0;
+}
+
 const PropertyData::PropertySpec *PropertyData::findProperty(OffsetBase offsetBase,const Property* prop) const
 {
     merge();
@@ -570,6 +592,16 @@ Property *PropertyData::getPropertyByName(OffsetBase offsetBase,const char* name
     return 0;
 }
 
+Property *PropertyData::getPropertyByName(OffsetBase offsetBase,const PropertyAtom &name) const
+{
+  const PropertyData::PropertySpec* Spec = findProperty(offsetBase,name);
+
+  if(Spec)
+    return (Property *) (Spec->Offset + offsetBase.getOffset());
+  else
+    return 0;
+}
+
 void PropertyData::getPropertyMap(OffsetBase offsetBase,std::map<std::string,Property*> &Map) const
 {
     merge();
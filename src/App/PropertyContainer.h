@@ -117,6 +117,7 @@ struct AppExport PropertyData
   void addProperty(OffsetBase offsetBase,const char* PropName, Property *Prop, const char* PropertyGroup= 0, PropertyType = Prop_None, const char* PropertyDocu= 0 );
   
   const PropertySpec *findProperty(OffsetBase offsetBase,const char* PropName) const;
+  const PropertySpec *findProperty(OffsetBase offsetBase,const PropertyAtom &PropName) const;
   const PropertySpec *findProperty(OffsetBase offsetBase,const Property* prop) const;
   
   const char* getName         (OffsetBase offsetBase,const Property* prop) const;
@@ -128,6 +129,7 @@ struct AppExport PropertyData
   const char* getDocumentation(OffsetBase offsetBase,const Property* prop) const;
 
   Property *getPropertyByName(OffsetBase offsetBase,const char* name) const;
+  Property *getPropertyByName(OffsetBase offsetBase,const PropertyAtom &name) const;
   void getPropertyMap(OffsetBase offsetBase,std::map<std::string,Property*> &Map) const;
   void getPropertyList(OffsetBase offsetBase,std::vector<Property*> &List) const;
 
@@ -162,6 +164,9 @@ public:
 
   /// find a property by its name
   virtual Property *getPropertyByName(const char* name) const;
+  /// find a property by its name and precomputed hash, by default the same
+  /// as getPropertyByName(name.getName())
+  virtual Property *getPropertyByName(const PropertyAtom &name) const;
   /// get the name of a property
   virtual const char* getPropertyName(const Property* prop) const;
   /// get all properties of the class (including properties of the parent)
@@ -240,6 +245,9 @@ protected:
   virtual void handleChangedPropertyName(Base::XMLReader &reader, const char * TypeName, const char *PropName);
   virtual void handleChangedPropertyType(Base::XMLReader &reader, const char * TypeName, Property * prop);
 
+  /// find a dynamic or static property of this container only
+  Property *findOwnProperty(const PropertyAtom &name) const;
+
 private:
   // forbidden
   PropertyContainer(const PropertyContainer&);
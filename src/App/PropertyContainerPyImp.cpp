@@ -480,7 +480,7 @@ PyObject *PropertyContainerPy::getCustomAttributes(const char* attr) const
     if(FC_LOG_INSTANCE.level()>FC_LOGLEVEL_TRACE) {
         FC_TRACE("Get property " << attr);
     }
-    Property *prop = getPropertyContainerPtr()->getPropertyByName(attr);
+    Property *prop = getPropertyContainerPtr()->getPropertyByName(PropertyAtom(attr));
     if (prop) {
         PyObject* pyobj = prop->getPyObject();
         if (!pyobj && PyErr_Occurred()) {
@@ -546,7 +546,7 @@ PyObject *PropertyContainerPy::getCustomAttributes(const char* attr) const
 int PropertyContainerPy::setCustomAttributes(const char* attr, PyObject *obj)
 {
     // search in PropertyList
-    Property *prop = getPropertyContainerPtr()->getPropertyByName(attr);
+    Property *prop = getPropertyContainerPtr()->getPropertyByName(PropertyAtom(attr));
     if (prop) {
         // Read-only attributes must not be set over its Python interface
         if(prop->testStatus(Property::Immutable)) {
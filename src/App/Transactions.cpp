@@ -26,6 +26,8 @@
 
 #ifndef _PreComp_
 # include <cassert>
+# include <algorithm>
+# include <limits>
 #endif
 
 #include <atomic>
@@ -112,7 +114,21 @@ int Transaction::getLastID() {
 
 unsigned int Transaction::getMemSize (void) const
 {
-    return 0;
+    return static_cast<unsigned int>(std::min<std::size_t>(getUndoMemSize(),
+                std::numeric_limits<unsigned int>::max()));
+}
+
+std::size_t Transaction::getUndoMemSize (void) const
+{
+    std::size_t size = 0;
+    auto &index = _Objects.get<0>();
+    for (auto It= index.begin();It!=index.end();++It) {
+        size += It->second->getUndoMemSize();
+        // a removed object is owned by the transaction, see ~Transaction()
+        if (It->second->status == TransactionObject::New && !It->first->isAttachedToDocument())
+            size += It->first->getMemSize();
+    }
+    return size;
 }
 
 void Transaction::Save (Base::Writer &/*writer*/) const
@@ -367,7 +383,7 @@ void TransactionObject::setProperty(const Property* pcProp)
     if(!data.property && data.name.empty()) {
         static_cast<DynamicProperty::PropData&>(data) = 
             pcProp->getContainer()->getDynamicPropertyData(pcProp);
-        data.property = pcProp->Copy();
+        data.property = pcProp->copyForTransaction();
         data.propertyType = pcProp->getTypeId();
         data.property->setStatusValue(pcProp->getStatus());
     }
@@ -398,7 +414,7 @@ void TransactionObject::addOrRemoveProperty(const Property* pcProp, bool add)
     if(add) 
         data.property = 0;
     else {
-        data.property = pcProp->Copy();
+        data.property = pcProp->copyForTransaction();
         data.propertyType = pcProp->getTypeId();
         data.property->setStatusValue(pcProp->getStatus());
     }
@@ -406,7 +422,20 @@ void TransactionObject::addOrRemoveProperty(const Property* pcProp, bool add)
 
 unsigned int TransactionObject::getMemSize (void) const
 {
-    return 0;
+    return static_cast<unsigned int>(std::min<std::size_t>(getUndoMemSize(),
+                std::numeric_limits<unsigned int>::max()));
+}
+
+std::size_t TransactionObject::getUndoMemSize (void) const
+{
+    // data still shared with the document or another transaction is not
+    // owned by this one and would be counted twice
+    std::size_t size = 0;
+    for (auto &v : _PropChangeMap) {
+        if (v.second.property)
+            size += v.second.property->getUnsharedMemSize();
+    }
+    return size;
 }
 
 void TransactionObject::Save (Base::Writer &/*writer*/) const
@@ -66,6 +66,8 @@ public:
     std::string Name;
 
     virtual unsigned int getMemSize (void) const;
+    /// Returns the memory of the data owned by the transaction
+    std::size_t getUndoMemSize (void) const;
     virtual void Save (Base::Writer &writer) const;
     /// This method is used to restore properties from an XML document.
     virtual void Restore(Base::XMLReader &reader);
@@ -121,6 +123,8 @@ public:
     void addOrRemoveProperty(const Property* pcProp, bool add);
 
     virtual unsigned int getMemSize (void) const;
+    /// Returns the memory of the stored data not shared with other properties
+    std::size_t getUndoMemSize (void) const;
     virtual void Save (Base::Writer &writer) const;
     /// This method is used to restore properties from an XML document.
     virtual void Restore(Base::XMLReader &reader);
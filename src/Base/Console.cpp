@@ -40,6 +40,10 @@
 #include "PyObjectBase.h"
 #include <QCoreApplication>
 #include <frameobject.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 using namespace Base;
 
@@ -110,6 +114,278 @@ private:
 
 ConsoleOutput* ConsoleOutput::instance = 0;
 
+/** Bounded multi-producer single-consumer queue of console messages
+ *  Producers claim a slot with a single CAS on the enqueue position and
+ *  publish it through the per-slot sequence number, so posting never takes
+ *  a lock. A single drain thread delivers the messages to the observers.
+ */
+class ConsoleQueue
+{
+public:
+    /** Keeps the queue alive while a thread uses it
+     *  The user count is raised before the instance is read, and destruct()
+     *  clears the instance before it waits for the count to drop to zero. So
+     *  either the user sees no queue or the queue is deleted after the user
+     *  is done with it.
+     */
+    class Access
+    {
+    public:
+        Access() {
+            users.fetch_add(1, std::memory_order_seq_cst);
+            queue = instance.load(std::memory_order_seq_cst);
+        }
+        ~Access() {
+            users.fetch_sub(1, std::memory_order_release);
+        }
+        ConsoleQueue* operator->() const {
+            return queue;
+        }
+        explicit operator bool() const {
+            return queue != 0;
+        }
+
+    private:
+        Access(const Access&) = delete;
+        Access& operator=(const Access&) = delete;
+        ConsoleQueue* queue;
+    };
+
+    static void create() {
+        if (!instance.load())
+            instance.store(new ConsoleQueue);
+    }
+    static void destruct() {
+        ConsoleQueue* queue = instance.exchange(0, std::memory_order_seq_cst);
+        if (!queue)
+            return;
+        // wait for the threads that are still posting or flushing
+        while (users.load(std::memory_order_acquire))
+            std::this_thread::yield();
+        delete queue;
+    }
+
+    /// Returns false if the message must be delivered directly
+    static bool post(ConsoleSingleton::FreeCAD_ConsoleMsgType type, const char *msg) {
+        Access queue;
+        if (!queue || queue->isDrainThread())
+            return false;
+        // log messages may be dropped, everything else waits for a free slot
+        queue->push(type, msg, type != ConsoleSingleton::MsgType_Log);
+        return true;
+    }
+
+    bool isDrainThread() const {
+        return std::this_thread::get_id() == worker.get_id();
+    }
+
+    /** Changes the observer list after the message the drain thread is
+     *  currently delivering. An observer attaching or detaching from within
+     *  SendLog() would otherwise wait for the dispatch lock held by itself.
+     */
+    void defer(ILogger *observer, bool attach) {
+        deferred.emplace_back(observer, attach);
+    }
+
+    bool flush(int msecs) {
+        if (isDrainThread())
+            return false;
+        std::size_t target = enqueuePos.load(std::memory_order_acquire);
+        if (msecs < 0) {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (delivered.load(std::memory_order_acquire) < target) {
+                wakeup.notify_one();
+                idle.wait_for(lock, std::chrono::milliseconds(10));
+            }
+            return true;
+        }
+
+        // The calling thread may have crashed while holding the queue lock or
+        // before publishing a claimed slot, so only poll until the deadline.
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(msecs);
+        while (delivered.load(std::memory_order_acquire) < target) {
+            if (std::chrono::steady_clock::now() >= deadline)
+                return false;
+            wakeup.notify_one();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    /// Guards the observer list against the drain thread
+    std::mutex dispatchMutex;
+
+private:
+    static const std::size_t Capacity = 4096;
+
+    struct Slot {
+        std::atomic<std::size_t> seq;
+        ConsoleSingleton::FreeCAD_ConsoleMsgType type;
+        std::string msg;
+    };
+
+    ConsoleQueue()
+        : ring(Capacity), enqueuePos(0), dequeuePos(0), delivered(0)
+        , dropped(0), sleeping(false), stop(false)
+    {
+        for (std::size_t i=0; i<Capacity; ++i)
+            ring[i].seq.store(i, std::memory_order_relaxed);
+        worker = std::thread(&ConsoleQueue::run, this);
+    }
+    ~ConsoleQueue()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wakeup.notify_one();
+        worker.join();
+    }
+
+    void push(ConsoleSingleton::FreeCAD_ConsoleMsgType type, const char *msg, bool wait) {
+        Slot* slot;
+        std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            slot = &ring[pos & (Capacity-1)];
+            std::size_t seq = slot->seq.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0) {
+                // queue is full
+                if (!wait) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                notify();
+                std::this_thread::yield();
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+            else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->type = type;
+        slot->msg.assign(msg);
+        slot->seq.store(pos+1, std::memory_order_release);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_relaxed))
+            notify();
+    }
+
+    bool pop(ConsoleSingleton::FreeCAD_ConsoleMsgType &type, std::string &msg) {
+        Slot& slot = ring[dequeuePos & (Capacity-1)];
+        std::size_t seq = slot.seq.load(std::memory_order_acquire);
+        if (seq != dequeuePos+1)
+            return false;
+        type = slot.type;
+        // swap so that the string buffers get recycled between the ring
+        msg.swap(slot.msg);
+        slot.msg.clear();
+        slot.seq.store(dequeuePos+Capacity, std::memory_order_release);
+        ++dequeuePos;
+        return true;
+    }
+
+    bool empty() const {
+        const Slot& slot = ring[dequeuePos & (Capacity-1)];
+        return slot.seq.load(std::memory_order_acquire) != dequeuePos+1;
+    }
+
+    void notify() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+        }
+        wakeup.notify_one();
+    }
+
+    void run() {
+        ConsoleSingleton::FreeCAD_ConsoleMsgType type;
+        std::string msg;
+        for (;;) {
+            {
+                std::lock_guard<std::mutex> lock(dispatchMutex);
+                std::size_t count = 0;
+                while (pop(type, msg)) {
+                    deliver(type, msg.c_str());
+                    if (!deferred.empty())
+                        applyDeferred();
+                    ++count;
+                }
+                unsigned long lost = dropped.exchange(0, std::memory_order_relaxed);
+                if (lost) {
+                    char buf[128];
+                    snprintf(buf, sizeof(buf), "%lu log messages dropped by the console queue\n", lost);
+                    deliver(ConsoleSingleton::MsgType_Wrn, buf);
+                }
+                delivered.fetch_add(count, std::memory_order_release);
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            idle.notify_all();
+            if (stop && empty())
+                break;
+            sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (empty() && !stop)
+                wakeup.wait_for(lock, std::chrono::milliseconds(100));
+            sleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    void deliver(ConsoleSingleton::FreeCAD_ConsoleMsgType type, const char *msg) {
+        switch (type) {
+        case ConsoleSingleton::MsgType_Txt:
+            Console().NotifyMessage(msg);
+            break;
+        case ConsoleSingleton::MsgType_Log:
+            Console().NotifyLog(msg);
+            break;
+        case ConsoleSingleton::MsgType_Wrn:
+            Console().NotifyWarning(msg);
+            break;
+        case ConsoleSingleton::MsgType_Err:
+            Console().NotifyError(msg);
+            break;
+        }
+    }
+
+    void applyDeferred() {
+        std::set<ILogger*> &observers = Console()._aclObservers;
+        for (auto &change : deferred) {
+            if (change.second)
+                observers.insert(change.first);
+            else
+                observers.erase(change.first);
+        }
+        deferred.clear();
+    }
+
+    std::vector<Slot> ring;
+    std::atomic<std::size_t> enqueuePos;
+    std::size_t dequeuePos;
+    std::atomic<std::size_t> delivered;
+    std::atomic<unsigned long> dropped;
+    std::atomic<bool> sleeping;
+    bool stop;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::condition_variable idle;
+    std::thread worker;
+    /// observer changes requested by the drain thread, only used by it
+    std::vector<std::pair<ILogger*, bool> > deferred;
+
+    static std::atomic<ConsoleQueue*> instance;
+    static std::atomic<int> users;
+};
+
+std::atomic<ConsoleQueue*> ConsoleQueue::instance(nullptr);
+std::atomic<int> ConsoleQueue::users(0);
+
 }
 
 //**************************************************************************
@@ -130,6 +406,7 @@ ConsoleSingleton::ConsoleSingleton(void)
 
 ConsoleSingleton::~ConsoleSingleton()
 {
+    ConsoleQueue::destruct();
     ConsoleOutput::destruct();
     for (std::set<ILogger * >::iterator Iter=_aclObservers.begin();Iter!=_aclObservers.end();++Iter)
         delete (*Iter);
@@ -230,12 +507,27 @@ bool ConsoleSingleton::IsMsgTypeEnabled(const char* sObs, FreeCAD_ConsoleMsgType
 
 void ConsoleSingleton::SetConnectionMode(ConnectionMode mode)
 {
+    // deliver everything that is still pending before leaving async mode
+    if (connectionMode == Async && mode != Async)
+        ConsoleQueue::destruct();
+
     connectionMode = mode;
 
     // make sure this method gets called from the main thread
     if (connectionMode == Queued) {
         ConsoleOutput::getInstance();
     }
+    else if (connectionMode == Async) {
+        ConsoleQueue::create();
+    }
+}
+
+bool ConsoleSingleton::Flush(int msecs)
+{
+    ConsoleQueue::Access queue;
+    if (queue)
+        return queue->flush(msecs);
+    return true;
 }
 
 /** Prints a Message
@@ -266,10 +558,10 @@ void ConsoleSingleton::Message( const char *pMsg, ... )
     vsnprintf(format, format_len, pMsg, namelessVars);\
     format[sizeof(format)-5] = '.';\
     va_end(namelessVars);\
-    if (connectionMode == Direct)\
-        Notify##_type(format);\
+    if (connectionMode == Queued)\
+        QCoreApplication::postEvent(ConsoleOutput::getInstance(), new ConsoleEvent(MsgType_##_type2, format));\
     else\
-        QCoreApplication::postEvent(ConsoleOutput::getInstance(), new ConsoleEvent(MsgType_##_type2, format));
+        Notify##_type(format);
 
     FC_CONSOLE_FMT(Message,Txt);
 }
@@ -371,7 +663,17 @@ void ConsoleSingleton::AttachObserver(ILogger *pcObserver)
     // double insert !!
     assert(_aclObservers.find(pcObserver) == _aclObservers.end() );
 
-    _aclObservers.insert(pcObserver);
+    ConsoleQueue::Access queue;
+    if (queue && queue->isDrainThread()) {
+        queue->defer(pcObserver, true);
+    }
+    else if (queue) {
+        std::lock_guard<std::mutex> lock(queue->dispatchMutex);
+        _aclObservers.insert(pcObserver);
+    }
+    else {
+        _aclObservers.insert(pcObserver);
+    }
 }
 
 /** Detaches an Observer from Console
@@ -381,11 +683,25 @@ void ConsoleSingleton::AttachObserver(ILogger *pcObserver)
  */
 void ConsoleSingleton::DetachObserver(ILogger *pcObserver)
 {
-    _aclObservers.erase(pcObserver);
+    ConsoleQueue::Access queue;
+    if (queue && queue->isDrainThread()) {
+        queue->defer(pcObserver, false);
+    }
+    else if (queue) {
+        // let the observer see the messages posted before it was detached
+        queue->flush(-1);
+        std::lock_guard<std::mutex> lock(queue->dispatchMutex);
+        _aclObservers.erase(pcObserver);
+    }
+    else {
+        _aclObservers.erase(pcObserver);
+    }
 }
 
 void ConsoleSingleton::NotifyMessage(const char *sMsg)
 {
+    if (connectionMode == Async && ConsoleQueue::post(MsgType_Txt, sMsg))
+        return;
     for (std::set<ILogger * >::iterator Iter=_aclObservers.begin();Iter!=_aclObservers.end();++Iter) {
         if ((*Iter)->bMsg)
             (*Iter)->SendLog(sMsg, LogStyle::Message);   // send string to the listener
@@ -394,6 +710,8 @@ void ConsoleSingleton::NotifyMessage(const char *sMsg)
 
 void ConsoleSingleton::NotifyWarning(const char *sMsg)
 {
+    if (connectionMode == Async && ConsoleQueue::post(MsgType_Wrn, sMsg))
+        return;
     for (std::set<ILogger * >::iterator Iter=_aclObservers.begin();Iter!=_aclObservers.end();++Iter) {
         if ((*Iter)->bWrn)
             (*Iter)->SendLog(sMsg, LogStyle::Warning);   // send string to the listener
@@ -402,6 +720,8 @@ void ConsoleSingleton::NotifyWarning(const char *sMsg)
 
 void ConsoleSingleton::NotifyError(const char *sMsg)
 {
+    if (connectionMode == Async && ConsoleQueue::post(MsgType_Err, sMsg))
+        return;
     for (std::set<ILogger * >::iterator Iter=_aclObservers.begin();Iter!=_aclObservers.end();++Iter) {
         if ((*Iter)->bErr)
             (*Iter)->SendLog(sMsg, LogStyle::Error);   // send string to the listener
@@ -410,6 +730,8 @@ void ConsoleSingleton::NotifyError(const char *sMsg)
 
 void ConsoleSingleton::NotifyLog(const char *sMsg)
 {
+    if (connectionMode == Async && ConsoleQueue::post(MsgType_Log, sMsg))
+        return;
     for (std::set<ILogger * >::iterator Iter=_aclObservers.begin();Iter!=_aclObservers.end();++Iter) {
         if ((*Iter)->bLog)
             (*Iter)->SendLog(sMsg, LogStyle::Log);   // send string to the listener
@@ -437,6 +759,15 @@ int *ConsoleSingleton::GetLogLevel(const char *tag, bool create) {
     return &ret;
 }
 
+LogRateLimit *ConsoleSingleton::GetLogRateLimit(const char *tag) {
+    if (!tag) tag = "";
+    return &_logRates[tag];
+}
+
+void ConsoleSingleton::SetLogRateLimit(const char *tag, int count) {
+    GetLogRateLimit(tag)->limit = count;
+}
+
 void ConsoleSingleton::Refresh() {
     if (_bCanRefresh)
         qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
@@ -983,3 +1314,23 @@ std::stringstream &LogLevel::prefix(std::stringstream &str, const char *src, int
     }
     return str;
 }
+
+bool LogLevel::acquire()
+{
+    long long now = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    long long last = rate.window.load(std::memory_order_relaxed);
+    if (now != last && rate.window.compare_exchange_strong(last, now)) {
+        rate.count = 0;
+        int suppressed = rate.suppressed.exchange(0);
+        if (suppressed > 0) {
+            std::stringstream str;
+            str << '<' << tag << "> " << suppressed << " messages suppressed by rate limit" << std::endl;
+            Console().NotifyLog(str.str().c_str());
+        }
+    }
+    if (rate.count.fetch_add(1, std::memory_order_relaxed) < rate.limit.load(std::memory_order_relaxed))
+        return true;
+    rate.suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
@@ -34,6 +34,7 @@
 #include <cstring>
 #include <sstream>
 #include <chrono>
+#include <atomic>
 
 //FIXME: ISO C++11 requires at least one argument for the "..." in a variadic macro
 #if defined(__clang__)
@@ -335,6 +336,15 @@
  * \c FC_LOG_INSTANCE), and \c _l is the log level constant to be checked,
  * \c _func is the Base::Console() function to print the log.
  *
+ * \section RateLimit Rate limiting
+ *
+ * Logging from tight loops can be throttled per tag with
+ * Base::Console().SetLogRateLimit(tag, count). The macros then print at most
+ * \c count messages of that tag per second and report the number of
+ * suppressed messages once the next second starts. Errors are never
+ * suppressed. The limits can also be set by the user through the parameter
+ * group \c BaseApp/LogRates.
+ *
  */
 
 #define FC_LOGLEVEL_DEFAULT -1
@@ -355,7 +365,7 @@
     _FC_LOG_LEVEL_INIT(FC_LOG_INSTANCE, _tag, ## __VA_ARGS__)
 
 #define __FC_PRINT(_instance,_l,_func,_msg,_file,_line) do{\
-    if(_instance.isEnabled(_l)) {\
+    if(_instance.isEnabled(_l) && _instance.isAllowed(_l)) {\
         std::stringstream _str;\
         _instance.prefix(_str,_file,_line) << _msg;\
         if(_instance.add_eol) \
@@ -494,6 +504,20 @@ namespace Base {
             bool bErr,bMsg,bLog,bWrn;
     };
 
+    /** Per tag message budget
+     *  Shared by all LogLevel instances of the same tag, see \ref RateLimit.
+     */
+    struct LogRateLimit
+    {
+        LogRateLimit():limit(0),window(0),count(0),suppressed(0){}
+
+        /// maximum number of messages per second, 0 for no limit
+        std::atomic<int> limit;
+        std::atomic<long long> window;
+        std::atomic<int> count;
+        std::atomic<int> suppressed;
+    };
+
 
     /** The console class
      *  This class manage all the stdio stuff. This includes
@@ -543,9 +567,20 @@ namespace Base {
             enum ConsoleMode{
                 Verbose = 1,	// suppress Log messages
             };
+            /** Delivery of messages to the observers
+             *  \a Direct calls the observers on the calling thread, \a Queued posts
+             *  the messages to the main thread's event loop and \a Async hands them
+             *  to a bounded lock-free queue that is drained by a dedicated thread.
+             *  In \a Async mode the observers are called from the drain thread, so
+             *  only use it with thread-safe observers. When the queue is full log
+             *  messages are dropped and counted, all other messages wait for space.
+             *  Observers attached or detached from the drain thread take effect
+             *  after the message being delivered.
+             */
             enum ConnectionMode {
                 Direct = 0,
-                Queued =1
+                Queued =1,
+                Async = 2
             };
 
             enum FreeCAD_ConsoleMsgType {
@@ -564,9 +599,23 @@ namespace Base {
             /// Enables or disables message types of a certain console observer
             bool IsMsgTypeEnabled(const char* sObs, FreeCAD_ConsoleMsgType type) const;
             void SetConnectionMode(ConnectionMode mode);
+            ConnectionMode GetConnectionMode() const {
+                return connectionMode;
+            }
+            /** Blocks until all messages queued so far in \a Async mode are
+             *  delivered to the observers. Does nothing in the other modes.
+             *  With a non-negative \a msecs it gives up after that many
+             *  milliseconds and doesn't take any lock, so it can be used from
+             *  the crash handlers. Returns false if messages are left.
+             */
+            bool Flush(int msecs=-1);
 
             int *GetLogLevel(const char *tag, bool create=true);
 
+            LogRateLimit *GetLogRateLimit(const char *tag);
+            /// Limits the tag based log macros of \a tag to \a count messages per second
+            void SetLogRateLimit(const char *tag, int count);
+
             void SetDefaultLogLevel(int level) {
                 _defaultLogLevel = level;
             }
@@ -598,7 +647,8 @@ namespace Base {
 
             bool _bVerbose;
             bool _bCanRefresh;
-            ConnectionMode connectionMode;
+            // read by every producer thread while the main thread switches it
+            std::atomic<ConnectionMode> connectionMode;
 
             // Singleton!
             ConsoleSingleton(void);
@@ -613,9 +663,11 @@ namespace Base {
             std::set<ILogger * > _aclObservers;
 
             std::map<std::string, int> _logLevels;
+            std::map<std::string, LogRateLimit> _logRates;
             int _defaultLogLevel;
 
             friend class ConsoleOutput;
+            friend class ConsoleQueue;
     };
 
     /** Access to the Console
@@ -648,23 +700,35 @@ namespace Base {
             bool print_time;
             bool add_eol;
             bool refresh;
+            LogRateLimit &rate;
 
             LogLevel(const char *tag, bool print_tag=true, int print_src=0,
                     bool print_time=false, bool add_eol=true, bool refresh=false)
                 :tag(tag),lvl(*Console().GetLogLevel(tag))
                  ,print_tag(print_tag),print_src(print_src),print_time(print_time)
                  ,add_eol(add_eol),refresh(refresh)
+                 ,rate(*Console().GetLogRateLimit(tag))
         {}
 
             bool isEnabled(int l) {
                 return l<=level();
             }
 
+            /// Checks the rate limit of the tag, errors always pass
+            bool isAllowed(int l) {
+                if(l<=FC_LOGLEVEL_ERR || rate.limit.load(std::memory_order_relaxed)<=0)
+                    return true;
+                return acquire();
+            }
+
             int level() const {
                 return Console().LogLevel(lvl);
             }
 
             std::stringstream &prefix(std::stringstream &str, const char *src, int line);
+
+        private:
+            bool acquire();
     };
 
 
@@ -54,6 +54,7 @@
 #   endif
 #   include <sstream>
 #   include <stdio.h>
+#   include <unordered_map>
 #endif
 
 
@@ -66,6 +67,7 @@
 #include "Parameter.inl"
 #include "Exception.h"
 #include "Console.h"
+#include "Stream.h"
 
 
 //#ifdef XERCES_HAS_CPP_NAMESPACE
@@ -214,6 +216,193 @@ inline bool DOMTreeErrorReporter::getSawErrors() const
     return fSawErrors;
 }
 
+//**************************************************************************
+// Value index and journal helpers
+
+namespace {
+
+enum ParamType {
+    ParamBool,
+    ParamInt,
+    ParamUInt,
+    ParamFloat,
+    ParamText,
+    ParamGroup
+};
+
+// the element names of the types above
+const char *ParamTypeNames[] = {"FCBool","FCInt","FCUInt","FCFloat","FCText","FCParamGroup"};
+
+int GetParamType(const char *Type)
+{
+    for (int i=ParamBool; i<=ParamText; ++i) {
+        if (strcmp(Type, ParamTypeNames[i]) == 0)
+            return i;
+    }
+    return -1;
+}
+
+struct ParamNameHasher
+{
+    std::size_t operator()(const char *s) const {
+        std::size_t hash = 0;
+        for (; *s; ++s)
+            hash = hash * 31 + static_cast<unsigned char>(*s);
+        return hash;
+    }
+    bool operator()(const char *a, const char *b) const {
+        return strcmp(a, b) == 0;
+    }
+};
+
+// the journal needs a tab separated entry per line
+void AppendEscaped(std::string &out, const char *s)
+{
+    for (; *s; ++s) {
+        switch (*s) {
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        default:
+            out += *s;
+            break;
+        }
+    }
+}
+
+std::vector<std::string> SplitEscaped(const std::string &line)
+{
+    std::vector<std::string> fields(1);
+    for (std::size_t i=0; i<line.size(); ++i) {
+        char c = line[i];
+        if (c == '\t') {
+            fields.emplace_back();
+        }
+        else if (c == '\\' && i+1 < line.size()) {
+            c = line[++i];
+            fields.back() += (c == 't' ? '\t' : (c == 'n' ? '\n' : (c == 'r' ? '\r' : c)));
+        }
+        else {
+            fields.back() += c;
+        }
+    }
+    return fields;
+}
+
+// rewrite the file instead of appending to the journal above this size
+const std::size_t MaxJournalSize = 256 * 1024;
+
+// merge the journal into the file after this many seconds
+const float MaxJournalAge = 300.0f;
+
+// The first line of a journal identifies the version of the XML file it
+// belongs to. If the file was rewritten afterwards, e.g. when saving was
+// interrupted before the journal got removed, replaying would override the
+// newer values with the older ones of the journal. The modification time
+// has only a resolution of seconds on some file systems, so two rewrites
+// of the same size in a row are told apart by a hash (FNV-1a) of the content.
+std::string JournalStamp(const char *sDocument)
+{
+    Base::FileInfo file(sDocument);
+    if (!file.exists())
+        return std::string();
+    Base::ifstream in(file, std::ios::in | std::ios::binary);
+    if (!in)
+        return std::string();
+
+    uint64_t hash = 14695981039346656037ULL;
+    uint64_t size = 0;
+    char buf[4096];
+    for (;;) {
+        in.read(buf, sizeof(buf));
+        std::streamsize count = in.gcount();
+        if (count <= 0)
+            break;
+        for (std::streamsize i=0; i<count; ++i) {
+            hash ^= static_cast<unsigned char>(buf[i]);
+            hash *= 1099511628211ULL;
+        }
+        size += static_cast<uint64_t>(count);
+    }
+
+    std::stringstream str;
+    str << "#\t" << size << '\t' << std::hex << hash;
+    return str.str();
+}
+
+}
+
+struct ParameterGrp::ParameterValue
+{
+    ParameterValue() : elem(0), l(0), hasText(false) {}
+
+    /// owns the key of the hash table
+    std::unique_ptr<char[]> name;
+    DOMElement *elem;
+    union {
+        bool b;
+        long l;
+        unsigned long u;
+        double d;
+    };
+    std::string text;
+    bool hasText;
+};
+
+struct ParameterGrp::ParameterIndex
+{
+    typedef std::unordered_map<const char*, ParameterValue,
+                               ParamNameHasher, ParamNameHasher> ValueMap;
+    ValueMap values[ParamText+1];
+
+    ParameterValue &insert(int Type, const char *Name, DOMElement *elem) {
+        std::size_t len = strlen(Name);
+        std::unique_ptr<char[]> name(new char[len+1]);
+        memcpy(name.get(), Name, len+1);
+        // the key points to the buffer owned by the value
+        ParameterValue &value = values[Type][name.get()];
+        value.name = std::move(name);
+        value.elem = elem;
+        return value;
+    }
+
+    static void read(int Type, ParameterValue &value) {
+        DOMElement *pcElem = value.elem;
+        if (Type == ParamText) {
+            DOMNode *pcElem2 = pcElem->getFirstChild();
+            value.hasText = pcElem2 != 0;
+            if (pcElem2)
+                value.text = StrXUTF8(pcElem2->getNodeValue()).c_str();
+            return;
+        }
+
+        std::string str = StrX(pcElem->getAttribute(XStr("Value").unicodeForm())).c_str();
+        switch (Type) {
+        case ParamBool:
+            value.b = str == "1";
+            break;
+        case ParamInt:
+            value.l = atol(str.c_str());
+            break;
+        case ParamUInt:
+            value.u = strtoul(str.c_str(),0,10);
+            break;
+        case ParamFloat:
+            value.d = atof(str.c_str());
+            break;
+        }
+    }
+};
+
 
 //**************************************************************************
 //**************************************************************************
@@ -228,9 +417,10 @@ inline bool DOMTreeErrorReporter::getSawErrors() const
 /** Default construction
   */
 ParameterGrp::ParameterGrp(XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *GroupNode,const char* sName)
-        : Base::Handled(), Subject<const char*>(),_pGroupNode(GroupNode)
+        : Base::Handled(), Subject<const char*>(),_pGroupNode(GroupNode), _Manager(0)
 {
     if (sName) _cName=sName;
+    BuildIndex();
 }
 
 
@@ -371,10 +561,16 @@ Base::Reference<ParameterGrp> ParameterGrp::_GetGroup(const char* Name)
     }
 
     // search if Group node already there
-    pcTemp = FindOrCreateElement(_pGroupNode,"FCParamGroup",Name);
+    pcTemp = FindElement(_pGroupNode,"FCParamGroup",Name);
+    if (!pcTemp) {
+        pcTemp = FindOrCreateElement(_pGroupNode,"FCParamGroup",Name);
+        if (pcTemp)
+            AddJournal('G',ParamGroup,Name,0);
+    }
 
     // create and register handle
     rParamGrp = Base::Reference<ParameterGrp> (new ParameterGrp(pcTemp,Name));
+    rParamGrp->_Manager = _Manager;
     _GroupMap[Name] = rParamGrp;
 
     return rParamGrp;
@@ -394,6 +590,7 @@ std::vector<Base::Reference<ParameterGrp> > ParameterGrp::GetGroups(void)
         // already created?
         if (!(rParamGrp=_GroupMap[Name]).isValid()) {
             rParamGrp = Base::Reference<ParameterGrp> (new ParameterGrp(static_cast<DOMElement*>(pcTemp),Name.c_str()));
+            rParamGrp->_Manager = _Manager;
             _GroupMap[Name] = rParamGrp;
         }
         vrParamGrp.push_back( rParamGrp );
@@ -428,23 +625,22 @@ bool ParameterGrp::HasGroup(const char* Name) const
 bool ParameterGrp::GetBool(const char* Name, bool bPreset) const
 {
     // check if Element in group
-    DOMElement *pcElem = FindElement(_pGroupNode,"FCBool",Name);
+    const ParameterValue *pcValue = FindValue(ParamBool,Name);
     // if not return preset
-    if (!pcElem) return bPreset;
-    // if yes check the value and return
-    if (strcmp(StrX(pcElem->getAttribute(XStr("Value").unicodeForm())).c_str(),"1"))
-        return false;
-    else
-        return true;
+    if (!pcValue) return bPreset;
+    // if yes return the value
+    return pcValue->b;
 }
 
 void  ParameterGrp::SetBool(const char* Name, bool bValue)
 {
     // find or create the Element
-    DOMElement *pcElem = FindOrCreateElement(_pGroupNode,"FCBool",Name);
-    if (pcElem) {
+    ParameterValue *pcValue = FindOrCreateValue(ParamBool,Name);
+    if (pcValue) {
         // and set the value
-        pcElem->setAttribute(XStr("Value").unicodeForm(), XStr(bValue?"1":"0").unicodeForm());
+        pcValue->elem->setAttribute(XStr("Value").unicodeForm(), XStr(bValue?"1":"0").unicodeForm());
+        pcValue->b = bValue;
+        AddJournal('S',ParamBool,Name,bValue?"1":"0");
         // trigger observer
         Notify(Name);
     }
@@ -497,22 +693,24 @@ std::vector<std::pair<std::string,bool> > ParameterGrp::GetBoolMap(const char *
 long ParameterGrp::GetInt(const char* Name, long lPreset) const
 {
     // check if Element in group
-    DOMElement *pcElem = FindElement(_pGroupNode,"FCInt",Name);
+    const ParameterValue *pcValue = FindValue(ParamInt,Name);
     // if not return preset
-    if (!pcElem) return lPreset;
-    // if yes check the value and return
-    return atol (StrX(pcElem->getAttribute(XStr("Value").unicodeForm())).c_str());
+    if (!pcValue) return lPreset;
+    // if yes return the value
+    return pcValue->l;
 }
 
 void  ParameterGrp::SetInt(const char* Name, long lValue)
 {
     char cBuf[256];
     // find or create the Element
-    DOMElement *pcElem = FindOrCreateElement(_pGroupNode,"FCInt",Name);
-    if (pcElem) {
+    ParameterValue *pcValue = FindOrCreateValue(ParamInt,Name);
+    if (pcValue) {
         // and set the value
         sprintf(cBuf,"%li",lValue);
-        pcElem->setAttribute(XStr("Value").unicodeForm(), XStr(cBuf).unicodeForm());
+        pcValue->elem->setAttribute(XStr("Value").unicodeForm(), XStr(cBuf).unicodeForm());
+        pcValue->l = lValue;
+        AddJournal('S',ParamInt,Name,cBuf);
         // trigger observer
         Notify(Name);
     }
@@ -560,22 +758,24 @@ std::vector<std::pair<std::string,long> > ParameterGrp::GetIntMap(const char * s
 unsigned long ParameterGrp::GetUnsigned(const char* Name, unsigned long lPreset) const
 {
     // check if Element in group
-    DOMElement *pcElem = FindElement(_pGroupNode,"FCUInt",Name);
+    const ParameterValue *pcValue = FindValue(ParamUInt,Name);
     // if not return preset
-    if (!pcElem) return lPreset;
-    // if yes check the value and return
-    return strtoul (StrX(pcElem->getAttribute(XStr("Value").unicodeForm())).c_str(),0,10);
+    if (!pcValue) return lPreset;
+    // if yes return the value
+    return pcValue->u;
 }
 
 void  ParameterGrp::SetUnsigned(const char* Name, unsigned long lValue)
 {
     char cBuf[256];
     // find or create the Element
-    DOMElement *pcElem = FindOrCreateElement(_pGroupNode,"FCUInt",Name);
-    if (pcElem) {
+    ParameterValue *pcValue = FindOrCreateValue(ParamUInt,Name);
+    if (pcValue) {
         // and set the value
         sprintf(cBuf,"%lu",lValue);
-        pcElem->setAttribute(XStr("Value").unicodeForm(), XStr(cBuf).unicodeForm());
+        pcValue->elem->setAttribute(XStr("Value").unicodeForm(), XStr(cBuf).unicodeForm());
+        pcValue->u = lValue;
+        AddJournal('S',ParamUInt,Name,cBuf);
         // trigger observer
         Notify(Name);
     }
@@ -623,22 +823,25 @@ std::vector<std::pair<std::string,unsigned long> > ParameterGrp::GetUnsignedMap(
 double ParameterGrp::GetFloat(const char* Name, double dPreset) const
 {
     // check if Element in group
-    DOMElement *pcElem = FindElement(_pGroupNode,"FCFloat",Name);
+    const ParameterValue *pcValue = FindValue(ParamFloat,Name);
     // if not return preset
-    if (!pcElem) return dPreset;
-    // if yes check the value and return
-    return atof (StrX(pcElem->getAttribute(XStr("Value").unicodeForm())).c_str());
+    if (!pcValue) return dPreset;
+    // if yes return the value
+    return pcValue->d;
 }
 
 void  ParameterGrp::SetFloat(const char* Name, double dValue)
 {
     char cBuf[256];
     // find or create the Element
-    DOMElement *pcElem = FindOrCreateElement(_pGroupNode,"FCFloat",Name);
-    if (pcElem) {
+    ParameterValue *pcValue = FindOrCreateValue(ParamFloat,Name);
+    if (pcValue) {
         // and set the value
         sprintf(cBuf,"%.12f",dValue); // use %.12f instead of %f to handle values < 1.0e-6
-        pcElem->setAttribute(XStr("Value").unicodeForm(), XStr(cBuf).unicodeForm());
+        pcValue->elem->setAttribute(XStr("Value").unicodeForm(), XStr(cBuf).unicodeForm());
+        // keep the precision of the stored value
+        pcValue->d = atof(cBuf);
+        AddJournal('S',ParamFloat,Name,cBuf);
         // trigger observer
         Notify(Name);
     }
@@ -700,9 +903,10 @@ void ParameterGrp::GetBlob(const char* /*Name*/, void* /*pBuf*/, long /*lMaxLeng
 void  ParameterGrp::SetASCII(const char* Name, const char *sValue)
 {
     // find or create the Element
-    DOMElement *pcElem = FindOrCreateElement(_pGroupNode,"FCText",Name);
-    if (pcElem) {
+    ParameterValue *pcValue = FindOrCreateValue(ParamText,Name);
+    if (pcValue) {
         // and set the value
+        DOMElement *pcElem = pcValue->elem;
         DOMNode *pcElem2 = pcElem->getFirstChild();
         if (!pcElem2) {
             XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument *pDocument = _pGroupNode->getOwnerDocument();
@@ -712,6 +916,9 @@ void  ParameterGrp::SetASCII(const char* Name, const char *sValue)
         else {
             pcElem2->setNodeValue(XUTF8Str(sValue).unicodeForm());
         }
+        pcValue->text = sValue;
+        pcValue->hasText = true;
+        AddJournal('S',ParamText,Name,sValue);
         // trigger observer
         Notify(Name);
     }
@@ -720,18 +927,17 @@ void  ParameterGrp::SetASCII(const char* Name, const char *sValue)
 std::string ParameterGrp::GetASCII(const char* Name, const char * pPreset) const
 {
     // check if Element in group
-    DOMElement *pcElem = FindElement(_pGroupNode,"FCText",Name);
+    const ParameterValue *pcValue = FindValue(ParamText,Name);
     // if not return preset
-    if (!pcElem) {
+    if (!pcValue) {
         if (pPreset==0)
             return std::string("");
         else
             return std::string(pPreset);
     }
     // if yes check the value and return
-    DOMNode *pcElem2 = pcElem->getFirstChild();
-    if (pcElem2)
-        return std::string(StrXUTF8(pcElem2->getNodeValue()).c_str());
+    if (pcValue->hasText)
+        return pcValue->text;
     else if (pPreset==0)
         return std::string("");
 
@@ -788,30 +994,20 @@ std::vector<std::pair<std::string,std::string> > ParameterGrp::GetASCIIMap(const
 
 void ParameterGrp::RemoveASCII(const char* Name)
 {
-    // check if Element in group
-    DOMElement *pcElem = FindElement(_pGroupNode,"FCText",Name);
-    // if not return
-    if (!pcElem)
+    // check if Element in group and remove it
+    if (!RemoveValue(ParamText,Name))
         return;
 
-    DOMNode* node = _pGroupNode->removeChild(pcElem);
-    node->release();
-
     // trigger observer
     Notify(Name);
 }
 
 void ParameterGrp::RemoveBool(const char* Name)
 {
-    // check if Element in group
-    DOMElement *pcElem = FindElement(_pGroupNode,"FCBool",Name);
-    // if not return
-    if (!pcElem)
+    // check if Element in group and remove it
+    if (!RemoveValue(ParamBool,Name))
         return;
 
-    DOMNode* node = _pGroupNode->removeChild(pcElem);
-    node->release();
-
     // trigger observer
     Notify(Name);
 }
@@ -831,45 +1027,30 @@ void ParameterGrp::RemoveBlob(const char* /*Name*/)
 
 void ParameterGrp::RemoveFloat(const char* Name)
 {
-    // check if Element in group
-    DOMElement *pcElem = FindElement(_pGroupNode,"FCFloat",Name);
-    // if not return
-    if (!pcElem)
+    // check if Element in group and remove it
+    if (!RemoveValue(ParamFloat,Name))
         return;
 
-    DOMNode* node = _pGroupNode->removeChild(pcElem);
-    node->release();
-
     // trigger observer
     Notify(Name);
 }
 
 void ParameterGrp::RemoveInt(const char* Name)
 {
-    // check if Element in group
-    DOMElement *pcElem = FindElement(_pGroupNode,"FCInt",Name);
-    // if not return
-    if (!pcElem)
+    // check if Element in group and remove it
+    if (!RemoveValue(ParamInt,Name))
         return;
 
-    DOMNode* node = _pGroupNode->removeChild(pcElem);
-    node->release();
-
     // trigger observer
     Notify(Name);
 }
 
 void ParameterGrp::RemoveUnsigned(const char* Name)
 {
-    // check if Element in group
-    DOMElement *pcElem = FindElement(_pGroupNode,"FCUInt",Name);
-    // if not return
-    if (!pcElem)
+    // check if Element in group and remove it
+    if (!RemoveValue(ParamUInt,Name))
         return;
 
-    DOMNode* node = _pGroupNode->removeChild(pcElem);
-    node->release();
-
     // trigger observer
     Notify(Name);
 }
@@ -880,6 +1061,10 @@ void ParameterGrp::RemoveGrp(const char* Name)
     if (it == _GroupMap.end())
         return;
 
+    // the journal cannot express this
+    if (_Manager)
+        _Manager->_JournalFull = true;
+
     // if this or any of its children is referenced by an observer
     // it cannot be deleted
 #if 1
@@ -916,6 +1101,10 @@ bool ParameterGrp::RenameGrp(const char* OldName, const char* NewName)
     if (jt != _GroupMap.end())
         return false;
 
+    // the journal cannot express this
+    if (_Manager)
+        _Manager->_JournalFull = true;
+
     // rename group handle
     _GroupMap[NewName] = _GroupMap[OldName];
     _GroupMap.erase(OldName);
@@ -964,6 +1153,11 @@ void ParameterGrp::Clear(void)
         DOMNode *child = _pGroupNode->removeChild(*it);
         child->release();
     }
+    BuildIndex();
+
+    // the journal cannot express this
+    if (_Manager)
+        _Manager->_JournalFull = true;
 
     // trigger observer
     Notify("");
@@ -1049,6 +1243,100 @@ XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *ParameterGrp::FindOrCreateElement(XER
     return pcElem;
 }
 
+void ParameterGrp::BuildIndex()
+{
+    _Index.reset(new ParameterIndex);
+    if (!_pGroupNode)
+        return;
+
+    for (DOMNode *clChild = _pGroupNode->getFirstChild(); clChild != 0;  clChild = clChild->getNextSibling()) {
+        if (clChild->getNodeType() != DOMNode::ELEMENT_NODE)
+            continue;
+        int type = GetParamType(StrX(clChild->getNodeName()).c_str());
+        if (type < 0)
+            continue;
+        DOMNode *pcName = clChild->getAttributes()->getNamedItem(XStr("Name").unicodeForm());
+        if (!pcName)
+            continue;
+        std::string name = StrX(pcName->getNodeValue()).c_str();
+        // like FindElement() the first element of a name wins
+        if (_Index->values[type].count(name.c_str()))
+            continue;
+        ParameterValue &value = _Index->insert(type, name.c_str(), static_cast<DOMElement*>(clChild));
+        ParameterIndex::read(type, value);
+    }
+}
+
+const ParameterGrp::ParameterValue *ParameterGrp::FindValue(int Type, const char* Name) const
+{
+    const ParameterIndex::ValueMap &values = _Index->values[Type];
+    auto it = values.find(Name);
+    if (it == values.end())
+        return nullptr;
+    return &it->second;
+}
+
+ParameterGrp::ParameterValue *ParameterGrp::FindOrCreateValue(int Type, const char* Name)
+{
+    ParameterIndex::ValueMap &values = _Index->values[Type];
+    auto it = values.find(Name);
+    if (it != values.end())
+        return &it->second;
+
+    DOMElement *pcElem = FindOrCreateElement(_pGroupNode,ParamTypeNames[Type],Name);
+    if (!pcElem)
+        return nullptr;
+    ParameterValue &value = _Index->insert(Type, Name, pcElem);
+    ParameterIndex::read(Type, value);
+    return &value;
+}
+
+bool ParameterGrp::RemoveValue(int Type, const char* Name)
+{
+    ParameterIndex::ValueMap &values = _Index->values[Type];
+    auto it = values.find(Name);
+    if (it == values.end())
+        return false;
+
+    DOMNode* node = _pGroupNode->removeChild(it->second.elem);
+    node->release();
+    values.erase(it);
+
+    AddJournal('R',Type,Name,0);
+    return true;
+}
+
+void ParameterGrp::AddJournal(char Op, int Type, const char* Name, const char* Value) const
+{
+    if (!_Manager || !_Manager->paramSerializer || _Manager->_JournalFull || _Manager->_JournalReplay)
+        return;
+
+    // the path of this group relative to the root group
+    std::string path;
+    for (DOMNode *node = _pGroupNode; node && node != _Manager->_pGroupNode; node = node->getParentNode()) {
+        if (node->getNodeType() != DOMNode::ELEMENT_NODE) {
+            _Manager->_JournalFull = true;
+            return;
+        }
+        std::string name = StrXUTF8(static_cast<DOMElement*>(node)->getAttribute(XStr("Name").unicodeForm())).c_str();
+        path = path.empty() ? name : name + "/" + path;
+    }
+
+    std::string &journal = _Manager->_Journal;
+    journal += Op;
+    journal += '\t';
+    journal += ParamTypeNames[Type];
+    journal += '\t';
+    AppendEscaped(journal, path.c_str());
+    journal += '\t';
+    AppendEscaped(journal, Name);
+    if (Value) {
+        journal += '\t';
+        AppendEscaped(journal, Value);
+    }
+    journal += '\n';
+}
+
 void ParameterGrp::NotifyAll()
 {
     // get all ints and notify
@@ -1091,18 +1379,36 @@ ParameterSerializer::~ParameterSerializer()
 }
 
 void ParameterSerializer::SaveDocument(const ParameterManager& mgr)
+{
+    // an old journal is merged so that it doesn't collect a whole session
+    std::string journal = filename + ".journal";
+    if (TimeInfo::diffTimeF(lastMerge) < MaxJournalAge
+            && mgr.SaveJournal(journal.c_str(), filename.c_str()))
+        return;
+    MergeJournal(mgr);
+}
+
+void ParameterSerializer::MergeJournal(const ParameterManager& mgr)
 {
     mgr.SaveDocument(filename.c_str());
+    mgr.ClearJournal((filename + ".journal").c_str());
+    lastMerge.setCurrent();
 }
 
 int ParameterSerializer::LoadDocument(ParameterManager& mgr)
 {
-    return mgr.LoadDocument(filename.c_str());
+    int ret = mgr.LoadDocument(filename.c_str());
+    if (ret == 1)
+        mgr.LoadJournal((filename + ".journal").c_str(), filename.c_str());
+    return ret;
 }
 
 bool ParameterSerializer::LoadOrCreateDocument(ParameterManager& mgr)
 {
-    return mgr.LoadOrCreateDocument(filename.c_str());
+    bool created = mgr.LoadOrCreateDocument(filename.c_str());
+    if (!created)
+        mgr.LoadJournal((filename + ".journal").c_str(), filename.c_str());
+    return created;
 }
 
 //**************************************************************************
@@ -1119,7 +1425,10 @@ static XercesDOMParser::ValSchemes    gValScheme       = XercesDOMParser::Val_Au
   */
 ParameterManager::ParameterManager()
   : ParameterGrp(), _pDocument(0), paramSerializer(0)
+  , _JournalFull(true), _JournalReplay(false)
 {
+    _Manager = this;
+
     // initialize the XML system
     Init();
 
@@ -1233,6 +1542,128 @@ bool ParameterManager::HasSerializer() const
     return (paramSerializer != 0);
 }
 
+bool ParameterManager::SaveJournal(const char* sFileName, const char* sDocument) const
+{
+    if (_JournalFull)
+        return false;
+    std::string stamp = JournalStamp(sDocument);
+    if (stamp.empty())
+        return false;
+    if (_Journal.empty())
+        return true;
+
+    Base::FileInfo file(sFileName);
+    bool create = !file.exists();
+    if (!create) {
+        Base::ifstream old(file, std::ios::in | std::ios::binary);
+        std::string line;
+        // the document was rewritten since the journal was started
+        if (!std::getline(old, line) || line != stamp)
+            return false;
+        old.seekg(0, std::ios::end);
+        if (static_cast<std::size_t>(old.tellg()) + _Journal.size() > MaxJournalSize)
+            return false;
+    }
+
+    Base::ofstream str(file, std::ios::out | std::ios::app | std::ios::binary);
+    if (!str)
+        return false;
+    if (create)
+        str << stamp << '\n';
+    str << _Journal;
+    str.close();
+    if (str.fail())
+        return false;
+
+    _Journal.clear();
+    return true;
+}
+
+void ParameterManager::LoadJournal(const char* sFileName, const char* sDocument)
+{
+    Base::FileInfo file(sFileName);
+    if (!_pGroupNode || !file.exists())
+        return;
+
+    Base::ifstream str(file, std::ios::in | std::ios::binary);
+    std::string line;
+    if (!std::getline(str, line) || line != JournalStamp(sDocument)) {
+        // the journal belongs to another version of the document, keep it
+        // aside so that the changes can still be recovered by hand
+        str.close();
+        std::string backup = std::string(sFileName) + ".stale";
+        Base::FileInfo old(backup);
+        if (old.exists())
+            old.deleteFile();
+        if (file.renameFile(backup.c_str()))
+            Base::Console().Warning("Parameter journal %s doesn't match %s and was not applied, "
+                                    "it was moved to %s\n", sFileName, sDocument, backup.c_str());
+        else
+            Base::Console().Warning("Parameter journal %s doesn't match %s and was not applied\n",
+                                    sFileName, sDocument);
+        return;
+    }
+    _JournalReplay = true;
+    while (std::getline(str, line)) {
+        // ignore an incomplete last entry
+        if (str.eof()) {
+            Base::Console().Warning("Parameter journal %s ends with an incomplete entry, "
+                                    "it was ignored\n", sFileName);
+            break;
+        }
+        std::vector<std::string> fields = SplitEscaped(line);
+        if (fields.size() < 4)
+            continue;
+
+        ParameterGrp *pGrp = this;
+        Base::Reference<ParameterGrp> hGrp;
+        if (!fields[2].empty()) {
+            hGrp = GetGroup(fields[2].c_str());
+            pGrp = hGrp;
+        }
+
+        const char *name = fields[3].c_str();
+        const char *value = fields.size() > 4 ? fields[4].c_str() : "";
+        int type = fields[1] == ParamTypeNames[ParamGroup] ? ParamGroup : GetParamType(fields[1].c_str());
+        if (fields[0] == "G" && type == ParamGroup) {
+            pGrp->GetGroup(name);
+        }
+        else if (fields[0] == "S") {
+            switch (type) {
+            case ParamBool:
+                pGrp->SetBool(name, strcmp(value, "1") == 0);
+                break;
+            case ParamInt:
+                pGrp->SetInt(name, atol(value));
+                break;
+            case ParamUInt:
+                pGrp->SetUnsigned(name, strtoul(value,0,10));
+                break;
+            case ParamFloat:
+                pGrp->SetFloat(name, atof(value));
+                break;
+            case ParamText:
+                pGrp->SetASCII(name, value);
+                break;
+            }
+        }
+        else if (fields[0] == "R" && type >= 0 && type <= ParamText) {
+            pGrp->RemoveValue(type, name);
+        }
+    }
+    _JournalReplay = false;
+}
+
+void ParameterManager::ClearJournal(const char* sFileName) const
+{
+    _Journal.clear();
+    _JournalFull = false;
+
+    Base::FileInfo file(sFileName);
+    if (file.exists())
+        file.deleteFile();
+}
+
 int ParameterManager::LoadDocument()
 {
     if (paramSerializer)
@@ -1255,6 +1686,12 @@ void ParameterManager::SaveDocument() const
         paramSerializer->SaveDocument(*this);
 }
 
+void ParameterManager::MergeJournal() const
+{
+    if (paramSerializer)
+        paramSerializer->MergeJournal(*this);
+}
+
 //**************************************************************************
 // Document handling
 
@@ -1358,6 +1795,10 @@ int ParameterManager::LoadDocument(const XERCES_CPP_NAMESPACE_QUALIFIER InputSou
     if (!_pGroupNode)
         throw XMLBaseException("Malformed Parameter document: Root group not found");
 
+    BuildIndex();
+    _Journal.clear();
+    _JournalFull = false;
+
     return 1;
 }
 
@@ -1533,6 +1974,11 @@ void  ParameterManager::CreateDocument(void)
     _pGroupNode = _pDocument->createElement(XStr("FCParamGroup").unicodeForm());
     static_cast<DOMElement*>(_pGroupNode)->setAttribute(XStr("Name").unicodeForm(), XStr("Root").unicodeForm());
     rootElem->appendChild(_pGroupNode);
+
+    BuildIndex();
+    // there is nothing on disk the journal could refer to
+    _Journal.clear();
+    _JournalFull = true;
 }
 
 void  ParameterManager::CheckDocument() const
@@ -58,12 +58,14 @@
 #endif
 
 #include <map>
+#include <memory>
 #include <vector>
 #include <xercesc/util/XercesDefs.hpp>
 
 // Std. configurations
 #include "Handle.h"
 #include "Observer.h"
+#include "TimeInfo.h"
 
 #ifdef _MSC_VER
 #	pragma warning( disable : 4251 )
@@ -246,6 +248,28 @@ protected:
     Base::Reference<ParameterGrp> _GetGroup(const char* Name);
     bool ShouldRemove() const;
 
+    /** @name Value index
+     *  All values of the group are kept in a hash table per type together with
+     *  their DOM element, so that the lookups don't need to walk and transcode
+     *  the DOM. The index is built when the group node is set and kept in sync
+     *  by all methods that modify values.
+     */
+    //@{
+    struct ParameterValue;
+    struct ParameterIndex;
+    /// rebuilds the index from the DOM node of this group
+    void BuildIndex();
+    /// returns the value of given type or null if it doesn't exist
+    const ParameterValue *FindValue(int Type, const char* Name) const;
+    /// returns the value of given type and creates its DOM element if needed
+    ParameterValue *FindOrCreateValue(int Type, const char* Name);
+    /// removes the value of given type from the DOM and the index
+    bool RemoveValue(int Type, const char* Name);
+    //@}
+
+    /// records a change in the journal of the owning parameter manager
+    void AddJournal(char Op, int Type, const char* Name, const char* Value) const;
+
     XERCES_CPP_NAMESPACE_QUALIFIER DOMElement *FindNextElement(XERCES_CPP_NAMESPACE_QUALIFIER DOMNode *Prev, const char* Type) const;
 
     /** Find an element specified by Type and Name
@@ -270,6 +294,10 @@ protected:
     std::string _cName;
     /// map of already exported groups
     std::map <std::string ,Base::Reference<ParameterGrp> > _GroupMap;
+    /// hashed values of this group
+    std::unique_ptr<ParameterIndex> _Index;
+    /// the manager of the document this group belongs to
+    ParameterManager *_Manager;
 
 };
 
@@ -278,6 +306,16 @@ protected:
  *  Does loading and saving the DOM document from and to files.
  *  In sub-classes the load and saving of XML documents can be
  *  customized.
+ *  \par
+ *  The default implementation doesn't rewrite the XML file on each save
+ *  but appends the changes since the last save to a journal file next to
+ *  it, which is replayed when the document is loaded. The journal is stamped
+ *  with the size and a hash of the content of the XML file. A journal whose
+ *  stamp doesn't match any more is renamed to a backup with a warning. The
+ *  journal is merged into the XML file, i.e. the file is rewritten and the
+ *  journal removed, by MergeJournal(), once the journal is older than a few
+ *  minutes or grows too large, and once a group was removed, renamed or
+ *  cleared.
  *  @see ParameterManager
  */
 class BaseExport ParameterSerializer
@@ -287,11 +325,15 @@ public:
     virtual ~ParameterSerializer();
 
     virtual void SaveDocument(const ParameterManager&);
+    /// Rewrites the whole document and removes its journal
+    virtual void MergeJournal(const ParameterManager&);
     virtual int LoadDocument(ParameterManager&);
     virtual bool LoadOrCreateDocument(ParameterManager&);
 
 protected:
     std::string filename;
+    /// when the document file was last rewritten
+    Base::TimeInfo lastMerge;
 };
 
 /** The parameter manager class
@@ -327,9 +369,37 @@ public:
     bool  LoadOrCreateDocument();
     /// Saves an XML document by calling the serializer's save method.
     void  SaveDocument() const;
+    /// Saves the whole XML document and removes its journal, e.g. on exit.
+    void  MergeJournal() const;
+    //@}
+
+    /** @name Change journal */
+    //@{
+    /** Appends the changes since the last save to the journal \a sFileName
+     *  of the document file \a sDocument. A new journal starts with the size
+     *  and a hash of the content of the document file. Returns false if the whole
+     *  document must be saved instead, e.g. because the document file was
+     *  rewritten since the journal was started.
+     */
+    bool  SaveJournal(const char* sFileName, const char* sDocument) const;
+    /** Applies the changes recorded in the journal \a sFileName. A journal
+     *  that wasn't started for the current version of the document file
+     *  \a sDocument isn't applied but renamed to \a sFileName with the
+     *  suffix ".stale", and a warning is printed.
+     */
+    void  LoadJournal(const char* sFileName, const char* sDocument);
+    /// Forgets the recorded changes and removes the journal \a sFileName
+    void  ClearJournal(const char* sFileName) const;
     //@}
 
 private:
+    friend class ParameterGrp;
+
+    /// pending journal entries since the last save
+    mutable std::string _Journal;
+    /// set if a change cannot be expressed in the journal
+    mutable bool _JournalFull;
+    bool _JournalReplay;
 
     XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument   *_pDocument;
     ParameterSerializer * paramSerializer;
@@ -191,6 +191,7 @@ bool SequencerBase::wasCanceled() const
 
 void SequencerBase::tryToCancel()
 {
+    QMutexLocker locker(&SequencerP::mutex);
     this->_bCanceled = true;
 }
 
@@ -152,6 +152,12 @@ public:
 
     /// Check if the  operation is aborted by user
     virtual void checkAbort() {}
+    /**
+     * Try to cancel the pending operation(s).
+     * E.g. @ref Gui::ProgressBar calls this method after the ESC button was pressed,
+     * App::Document::cancelRecompute() to stop lengthy algorithms of a recompute.
+     */
+    void tryToCancel();
 
 protected:
     /**
@@ -191,11 +197,6 @@ protected:
      * @see pause(), @see Gui::ProgressBar.
      */
     virtual void resume();
-    /**
-     * Try to cancel the pending operation(s).
-     * E.g. @ref Gui::ProgressBar calls this method after the ESC button was pressed.
-     */
-    void tryToCancel();
     /**
      * If you tried to cancel but then decided to continue the operation.
      * E.g. in @ref Gui::ProgressBar a dialog appears asking if you really want to
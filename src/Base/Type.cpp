@@ -24,6 +24,8 @@
 
 #ifndef _PreComp_
 # include <assert.h>
+# include <cstring>
+# include <unordered_map>
 #endif
 
 /// Here the FreeCAD includes sorted by Base,App,Gui......
@@ -49,9 +51,31 @@ struct Base::TypeData
   Type parent;
   Type type;
   Type::instantiationMethod instMethod;
+  /// keys of the ancestors indexed by their depth, ending with the type itself
+  std::vector<unsigned int> ancestors;
 };
 
-map<string,unsigned int> Type::typemap;
+namespace {
+struct TypeNameHasher
+{
+  std::size_t operator()(const char *s) const {
+    std::size_t hash = 0;
+    for (; *s; ++s)
+      hash = hash * 31 + static_cast<unsigned char>(*s);
+    return hash;
+  }
+  bool operator()(const char *a, const char *b) const {
+    return strcmp(a, b) == 0;
+  }
+};
+}
+
+// The keys point to the names owned by TypeData
+struct Base::Type::TypeMap : std::unordered_map<const char*, unsigned int, TypeNameHasher, TypeNameHasher>
+{
+};
+
+Type::TypeMap            Type::typemap;
 vector<TypeData*>        Type::typedata;
 set<string>              Type::loadModuleSet;
 
@@ -144,10 +168,13 @@ const Type Type::createType(const Type parent, const char *name, instantiationMe
   Type newType;
   newType.index = Type::typedata.size();
   TypeData * typeData = new TypeData(name, newType, parent,method);
+  if (!parent.isBad() && parent.index < Type::typedata.size())
+    typeData->ancestors = Type::typedata[parent.index]->ancestors;
+  typeData->ancestors.push_back(newType.index);
   Type::typedata.push_back(typeData);
 
   // add to dictionary for fast lookup
-  Type::typemap[name] = newType.getKey();
+  Type::typemap[typeData->name.c_str()] = newType.getKey();
 
   return newType;
 }
@@ -158,26 +185,27 @@ void Type::init(void)
   assert(Type::typedata.size() == 0);
 
 
-  Type::typedata.push_back(new TypeData("BadType"));
-  Type::typemap["BadType"] = 0;
+  TypeData * typeData = new TypeData("BadType");
+  typeData->ancestors.push_back(0);
+  Type::typedata.push_back(typeData);
+  Type::typemap[typeData->name.c_str()] = 0;
 
 
 }
 
 void Type::destruct(void)
 {
+  // clear the map first as its keys point into the type data
+  typemap.clear();
   for(std::vector<TypeData*>::const_iterator it = typedata.begin();it!= typedata.end();++it)
     delete *it;
   typedata.clear();
-  typemap.clear();
   loadModuleSet.clear();
 }
 
 Type Type::fromName(const char *name)
 {
-  std::map<std::string,unsigned int>::const_iterator pos;
-  
-  pos = typemap.find(name);
+  TypeMap::const_iterator pos = typemap.find(name);
   if (pos != typemap.end())
     return typedata[pos->second]->type;
   else
@@ -204,15 +232,10 @@ const Type Type::getParent(void) const
 
 bool Type::isDerivedFrom(const Type type) const
 {
-  
-  Type temp(*this);
-  do {
-    if (temp == type)
-      return true;
-    temp = temp.getParent();
-  } while (temp != badType());
-
-  return false;
+  // a type derives from 'type' if its ancestor at the depth of 'type' is 'type'
+  const std::vector<unsigned int> &ancestors = typedata[index]->ancestors;
+  std::size_t depth = typedata[type.index]->ancestors.size() - 1;
+  return depth < ancestors.size() && ancestors[depth] == type.index;
 }
 
 int Type::getAllDerivedFrom(const Type type, std::vector<Type> & List)
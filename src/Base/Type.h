@@ -73,6 +73,11 @@ struct TypeData;
   One important note about the use of Type to register class
   information: super classes must be registered before any of their
   derived classes are.
+
+  Each type keeps the list of its ancestors indexed by their depth in the
+  hierarchy. isDerivedFrom() therefore only compares the ancestor at the
+  depth of the other type and doesn't walk the parent chain. Type names
+  are looked up through a hash table.
 */
 class BaseExport Type
 {
@@ -128,8 +133,9 @@ private:
 
   unsigned int index;
 
+  struct TypeMap;
 
-  static std::map<std::string,unsigned int> typemap;
+  static TypeMap                    typemap;
   static std::vector<TypeData*>     typedata;
 
   static std::set<std::string>  loadModuleSet;
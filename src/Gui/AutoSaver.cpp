@@ -228,6 +228,10 @@ void AutoSaver::timerEvent(QTimerEvent * event)
     int id = event->timerId();
     for (std::map<std::string, AutoSaveProperty*>::iterator it = saverMap.begin(); it != saverMap.end(); ++it) {
         if (it->second->timerId == id) {
+            // locked while it is recomputed asynchronously, try again next time
+            App::Document* doc = App::GetApplication().getDocument(it->first.c_str());
+            if (doc && doc->hasAsyncRecompute())
+                break;
             try {
                 saveDocument(it->first, *it->second);
                 it->second->touched.clear();
@@ -1305,10 +1305,18 @@ StdCmdRefresh::StdCmdRefresh()
 void StdCmdRefresh::activated(int iMsg)
 {
     Q_UNUSED(iMsg);
-    if (getActiveGuiDocument()) {
+    Gui::Document *doc = getActiveGuiDocument();
+    if (doc) {
         App::AutoTransaction trans((eType & NoTransaction) ? nullptr : "Recompute");
+        // Recompute on a worker thread to keep the GUI responsive
+        ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath(
+                "User parameter:BaseApp/Preferences/Document");
+        bool async = hGrp->GetBool("AsyncRecompute", false);
         try {
-            doCommand(Doc,"App.activeDocument().recompute(None,True,True)");
+            if (async)
+                doc->recomputeAsync({}, true, App::Document::DepNoCycle);
+            else
+                doCommand(Doc,"App.activeDocument().recompute(None,True,True)");
         }
         catch (Base::Exception& /*e*/) {
             int ret = QMessageBox::warning(getMainWindow(), QObject::tr("Dependency error"),
@@ -1318,7 +1326,10 @@ void StdCmdRefresh::activated(int iMsg)
                     QMessageBox::Yes, QMessageBox::No);
             if(ret == QMessageBox::No)
                 return;
-            doCommand(Doc,"App.activeDocument().recompute(None,True)");
+            if (async)
+                doc->recomputeAsync({}, true);
+            else
+                doCommand(Doc,"App.activeDocument().recompute(None,True)");
         }
     }
 }
@@ -28,11 +28,13 @@
 # include <QAbstractButton>
 # include <qapplication.h>
 # include <qdir.h>
+# include <QEventLoop>
 # include <qfileinfo.h>
 # include <QKeySequence>
 # include <QTextStream>
 # include <qmessagebox.h>
 # include <qstatusbar.h>
+# include <QTimer>
 # include <boost/signals2.hpp>
 # include <boost_bind_bind.hpp>
 # include <Inventor/actions/SoSearchAction.h>
@@ -43,9 +45,11 @@
 
 #include <Base/Console.h>
 #include <Base/Exception.h>
+#include <Base/Interpreter.h>
 #include <Base/Matrix.h>
 #include <Base/Reader.h>
 #include <Base/Writer.h>
+#include <Base/Sequencer.h>
 #include <Base/Tools.h>
 
 #include <App/Document.h>
@@ -225,6 +229,9 @@ Document::Document(App::Document* pcDocument,Application * app)
         d->_pcDocument->setUndoMode(1);
         // set the maximum stack size
         d->_pcDocument->setMaxUndoStackSize(hGrp->GetInt("MaxUndoSize",20));
+        // and the memory budget in MB, zero means unlimited
+        std::size_t undoMemory = hGrp->GetUnsigned("MaxUndoMemory",0);
+        d->_pcDocument->setUndoLimit(undoMemory * 1024 * 1024);
     }
 
     d->_changeViewTouchDocument = hGrp->GetBool("ChangeViewProviderTouchDocument", true);
@@ -1037,6 +1044,56 @@ App::Document* Document::getDocument(void) const
     return d->_pcDocument;
 }
 
+bool Document::recomputeAsync(const std::vector<App::DocumentObject*> &objs, bool force, int options)
+{
+    App::Document *doc = getDocument();
+
+    // This launcher owns the progress bar for the whole recompute, which
+    // blocks user input except ESC. The one of the worker thread is nested.
+    Base::SequencerLauncher seq("Recompute...", 0);
+    if (!doc->recomputeAsync(objs, force, options))
+        return false;
+
+    QEventLoop loop;
+    QTimer timer;
+    QObject::connect(&timer, SIGNAL(timeout()), &loop, SLOT(quit()));
+    timer.start(100);
+
+    // emitted from the worker thread
+    boost::signals2::scoped_connection conn = doc->signalAsyncRecomputeReady.connect(
+        [&loop](const App::Document&) {
+            QMetaObject::invokeMethod(&loop, "quit", Qt::QueuedConnection);
+        });
+
+    for (;;) {
+        bool running;
+        try {
+            // updates the view providers of the objects done so far
+            running = doc->processAsyncRecompute();
+        }
+        catch (const Base::Exception& e) {
+            e.ReportException();
+            running = doc->hasAsyncRecompute();
+        }
+        if (!running)
+            break;
+
+        if (Base::Sequencer().wasCanceled())
+            doc->cancelRecompute();
+        seq.next();
+
+        // the worker may need the GIL to execute Python features
+        std::unique_ptr<Base::PyGILStateRelease> release;
+#if PY_MAJOR_VERSION >= 3
+        if (PyGILState_Check())
+            release.reset(new Base::PyGILStateRelease);
+#endif
+        loop.exec();
+    }
+
+    return true;
+}
+
 static bool checkCanonicalPath(const std::map<App::Document*, bool> &docs)
 {
     std::map<QString, std::vector<App::Document*> > paths;
@@ -170,6 +170,17 @@ public:
     /// Getter for the App Document
     App::Document*  getDocument(void) const;
 
+    /** Recompute the document on a worker thread
+     *
+     * Starts App::Document::recomputeAsync() and keeps the GUI responsive
+     * until it is finished. The view providers are updated as the objects
+     * are done, pressing ESC cancels the recompute.
+     *
+     * @return false if the recompute was not started
+     */
+    bool recomputeAsync(const std::vector<App::DocumentObject*> &objs={},
+            bool force=false, int options=0);
+
     /** @name methods for View handling */
     //@{
     /// Getter for the active view
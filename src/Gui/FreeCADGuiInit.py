@@ -117,10 +117,12 @@ def InitApplications():
     ModDirs = FreeCAD.__ModDirs__
     #print ModDirs
     Log('Init:   Searching modules...\n')
+    Profiler = FreeCAD.__startup_profiler__
     for Dir in ModDirs:
         if ((Dir != '') & (Dir != 'CVS') & (Dir != '__init__.py')):
             InstallFile = os.path.join(Dir,"InitGui.py")
             if (os.path.exists(InstallFile)):
+                if Profiler: Start = Profiler.timer()
                 try:
                     # XXX: This looks scary securitywise...
                     with open(InstallFile) as f:
@@ -132,8 +134,10 @@ def InitApplications():
                     Log('-'*100+'\n')
                     Err('During initialization the error "' + str(inst) + '" occurred in ' + InstallFile + '\n')
                     Err('Please look into the log file for further information\n')
+                    if Profiler: Profiler.add('InitGui.py', Dir, Profiler.timer() - Start, 'failed')
                 else:
                     Log('Init:      Initializing ' + Dir + '... done\n')
+                    if Profiler: Profiler.add('InitGui.py', Dir, Profiler.timer() - Start, 'exec')
             else:
                 Log('Init:      Initializing ' + Dir + '(InitGui.py not found)... ignore\n')
 
@@ -146,6 +150,7 @@ def InitApplications():
         for _, freecad_module_name, freecad_module_ispkg in pkgutil.iter_modules(freecad.__path__, "freecad."):
             if freecad_module_ispkg:
                 Log('Init: Initializing ' + freecad_module_name + '\n')
+                if Profiler: Start = Profiler.timer()
                 try:
                     freecad_module = importlib.import_module(freecad_module_name)
                     if any (module_name == 'init_gui' for _, module_name, ispkg in pkgutil.iter_modules(freecad_module.__path__)):
@@ -153,7 +158,9 @@ def InitApplications():
                         Log('Init: Initializing ' + freecad_module_name + '... done\n')
                     else:
                         Log('Init: No init_gui module found in ' + freecad_module_name + ', skipping\n')
+                    if Profiler: Profiler.add('InitGui.py', freecad_module_name, Profiler.timer() - Start, 'exec')
                 except Exception as inst:
+                    if Profiler: Profiler.add('InitGui.py', freecad_module_name, Profiler.timer() - Start, 'failed')
                     Err('During initialization the error "' + str(inst) + '" occurred in ' + freecad_module_name + '\n')
                     Err('-'*80+'\n')
                     Err(traceback.format_exc())
@@ -211,6 +218,9 @@ FreeCAD.addExportType("WebGL/X3D (*.xhtml)","FreeCADGui")
 #FreeCAD.addExportType("3D View (*.svg)","FreeCADGui")
 FreeCAD.addExportType("Portable Document Format (*.pdf)","FreeCADGui")
 
+if FreeCAD.__startup_profiler__:
+    FreeCAD.__startup_profiler__.write()
+
 del(InitApplications)
 del(NoneWorkbench)
 del(StandardWorkbench)
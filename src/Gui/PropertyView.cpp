@@ -113,6 +113,9 @@ PropertyView::PropertyView(QWidget *parent)
     this->connectPropData =
     App::GetApplication().signalChangedObject.connect(boost::bind
         (&PropertyView::slotChangePropertyData, this, bp::_1, bp::_2));
+    this->connectPropsData =
+    App::GetApplication().signalChangedObjects.connect(boost::bind
+        (&PropertyView::slotChangePropertiesData, this, bp::_1, bp::_2));
     this->connectPropView =
     Gui::Application::Instance->signalChangedObject.connect(boost::bind
         (&PropertyView::slotChangePropertyView, this, bp::_1, bp::_2));
@@ -148,6 +151,7 @@ PropertyView::PropertyView(QWidget *parent)
 PropertyView::~PropertyView()
 {
     this->connectPropData.disconnect();
+    this->connectPropsData.disconnect();
     this->connectPropView.disconnect();
     this->connectPropAppend.disconnect();
     this->connectPropRemove.disconnect();
@@ -210,11 +214,24 @@ void PropertyView::slotRollback() {
     clearPropertyItemSelection();
 }
 
-void PropertyView::slotChangePropertyData(const App::DocumentObject&, const App::Property& prop)
+void PropertyView::slotChangePropertyData(const App::DocumentObject& obj, const App::Property& prop)
 {
+    // the changes of a batch are handled by slotChangePropertiesData()
+    auto doc = obj.getDocument();
+    if (doc && doc->isDeliveringChangeBatch())
+        return;
     propertyEditorData->updateProperty(prop);
 }
 
+void PropertyView::slotChangePropertiesData(const App::Document&,
+        const std::vector<std::pair<const App::DocumentObject*, const App::Property*> >& changes)
+{
+    std::unordered_set<const App::Property*> props;
+    for (auto &v : changes)
+        props.insert(v.second);
+    propertyEditorData->updateProperties(props);
+}
+
 void PropertyView::slotChangePropertyView(const Gui::ViewProvider&, const App::Property& prop)
 {
     propertyEditorView->updateProperty(prop);
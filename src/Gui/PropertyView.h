@@ -82,6 +82,8 @@ protected:
 private:
     void onSelectionChanged(const SelectionChanges& msg) override;
     void slotChangePropertyData(const App::DocumentObject&, const App::Property&);
+    void slotChangePropertiesData(const App::Document&,
+            const std::vector<std::pair<const App::DocumentObject*, const App::Property*> >&);
     void slotChangePropertyView(const Gui::ViewProvider&, const App::Property&);
     void slotAppendDynamicProperty(const App::Property&);
     void slotRemoveDynamicProperty(const App::Property&);
@@ -99,6 +101,7 @@ private:
     struct PropFind;
     typedef boost::signals2::connection Connection;
     Connection connectPropData;
+    Connection connectPropsData;
     Connection connectPropView;
     Connection connectPropAppend;
     Connection connectPropRemove;
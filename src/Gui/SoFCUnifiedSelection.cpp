@@ -1022,6 +1022,9 @@ bool SoFCSelectionRoot::StackComp::operator()(const Stack &a, const Stack &b) co
 }
 // ---------------------------------------------------------------------------------
 SoSeparator::CacheEnabled SoFCSeparator::CacheMode = SoSeparator::AUTO;
+SoSeparator::CacheEnabled SoFCSeparator::CullingMode = SoSeparator::OFF;
+int *SoFCSeparator::RenderedCount;
+int *SoFCSeparator::CulledCount;
 SO_NODE_SOURCE(SoFCSeparator)
 
 SoFCSeparator::SoFCSeparator(bool trackCacheMode)
@@ -1035,9 +1038,32 @@ SoFCSeparator::SoFCSeparator(bool trackCacheMode)
 }
 
 void SoFCSeparator::GLRenderBelowPath(SoGLRenderAction * action) {
-    if(trackCacheMode && renderCaching.getValue()!=CacheMode) {
-        renderCaching = CacheMode;
-        boundingBoxCaching = CacheMode;
+    if(trackCacheMode) {
+        if(renderCaching.getValue()!=CacheMode)
+            renderCaching = CacheMode;
+        // Culling tests the cached bounding box, so keep the bounding box
+        // cache alive when render caching is switched off.
+        CacheEnabled bboxMode = CacheMode;
+        if(CullingMode!=SoSeparator::OFF && bboxMode==SoSeparator::OFF)
+            bboxMode = SoSeparator::AUTO;
+        if(boundingBoxCaching.getValue()!=bboxMode)
+            boundingBoxCaching = bboxMode;
+
+        // View provider roots are separators of this type. With culling on Coin
+        // skips the whole sub graph if its cached bounding box is outside of the
+        // view volume, and nested separators are tested hierarchically.
+        if(renderCulling.getValue()!=CullingMode)
+            renderCulling = CullingMode;
+
+        // Only counted if a viewer asked for statistics. A culled node is
+        // skipped right here, so only visible nodes are tested again below.
+        if(CulledCount && CullingMode!=SoSeparator::OFF) {
+            if(cullTestNoPush(action->getState())) {
+                ++(*CulledCount);
+                return;
+            }
+            ++(*RenderedCount);
+        }
     }
     inherited::GLRenderBelowPath(action);
 }
@@ -177,9 +177,30 @@ public:
         return CacheMode;
     }
 
+    /// Frustum culling mode, uses the bounding box cache of the node
+    static void setCullingMode(CacheEnabled mode) {
+        CullingMode = mode;
+    }
+    static CacheEnabled getCullingMode() {
+        return CullingMode;
+    }
+    /** Counters for rendered and culled separators
+     *
+     * Set by a viewer around its own traversal and reset to null afterwards.
+     * Counting costs an extra cull test for each visible separator, so it is
+     * only done while the counters are set.
+     */
+    static void setCullingStatistics(int *rendered, int *culled) {
+        RenderedCount = rendered;
+        CulledCount = rendered ? culled : nullptr;
+    }
+
 private:
     bool trackCacheMode;
     static CacheEnabled CacheMode;
+    static CacheEnabled CullingMode;
+    static int *RenderedCount;
+    static int *CulledCount;
 };
 
 class GuiExport SoFCSelectionRoot : public SoFCSeparator {
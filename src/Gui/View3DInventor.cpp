@@ -174,6 +174,7 @@ View3DInventor::View3DInventor(Gui::Document* pcDocument, QWidget* parent,
     OnChange(*hGrp,"CornerNaviCube");
     OnChange(*hGrp,"UseVBO");
     OnChange(*hGrp,"RenderCache");
+    OnChange(*hGrp,"RenderCulling");
     OnChange(*hGrp,"Orthographic");
     OnChange(*hGrp,"HeadlightColor");
     OnChange(*hGrp,"HeadlightDirection");
@@ -391,6 +392,9 @@ void View3DInventor::OnChange(ParameterGrp::SubjectType &rCaller,ParameterGrp::M
     else if (strcmp(Reason,"RenderCache") == 0) {
         _viewer->setRenderCache(rGrp.GetInt("RenderCache",0));
     }
+    else if (strcmp(Reason,"RenderCulling") == 0) {
+        _viewer->setRenderCulling(rGrp.GetBool("RenderCulling",false));
+    }
     else if (strcmp(Reason,"Orthographic") == 0) {
         // check whether a perspective or orthogrphic camera should be set
         if (rGrp.GetBool("Orthographic", true))
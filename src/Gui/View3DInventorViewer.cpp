@@ -383,6 +383,8 @@ void View3DInventorViewer::init()
     shading = true;
     fpsEnabled = false;
     vboEnabled = false;
+    renderedCount = 0;
+    culledCount = 0;
 
     attachSelection();
 
@@ -1406,6 +1408,18 @@ void View3DInventorViewer::setRenderCache(int mode)
     SoFCSeparator::setCacheMode(caching);
 }
 
+void View3DInventorViewer::setRenderCulling(bool on)
+{
+    SoFCSeparator::setCullingMode(on ? SoSeparator::ON : SoSeparator::OFF);
+}
+
+void View3DInventorViewer::getCullingStatistics(int &rendered, int &culled) const
+{
+    // counted by the separators while this viewer rendered its last frame
+    rendered = renderedCount;
+    culled = culledCount;
+}
+
 void View3DInventorViewer::setEnabledNaviCube(bool on)
 {
     naviCubeEnabled = on;
@@ -2378,6 +2392,14 @@ void View3DInventorViewer::renderScene(void)
         SoOverrideElement::setLightModelOverride(state, selectionRoot, true);
     }
 
+    // the statistics are only shown, and therefore only counted, with the fps counter
+    struct CullingStatisticsGuard {
+        ~CullingStatisticsGuard() { SoFCSeparator::setCullingStatistics(nullptr, nullptr); }
+    } cullingStatisticsGuard;
+    culledCount = renderedCount = 0;
+    if (fpsEnabled)
+        SoFCSeparator::setCullingStatistics(&renderedCount, &culledCount);
+
     try {
         // Render normal scenegraph.
         inherited::actualRedraw();
@@ -2391,6 +2413,7 @@ void View3DInventorViewer::renderScene(void)
         QMessageBox::warning(parentWidget(), QObject::tr("Out of memory"),
                              QObject::tr("Not enough memory available to display the data."));
     }
+    SoFCSeparator::setCullingStatistics(nullptr, nullptr);
 
     if (!this->shading) {
         state->pop();
@@ -2435,6 +2458,11 @@ void View3DInventorViewer::renderScene(void)
         stream.precision(1);
         stream.setf(std::ios::fixed | std::ios::showpoint);
         stream << framesPerSecond[0] << " ms / " << framesPerSecond[1] << " fps";
+        if (SoFCSeparator::getCullingMode() != SoSeparator::OFF) {
+            int rendered, culled;
+            getCullingStatistics(rendered, culled);
+            stream << " / " << rendered << " rendered, " << culled << " culled";
+        }
         draw2DString(stream.str().c_str(), SbVec2s(10,10), SbVec2f(0.1f,0.1f));
     }
 
@@ -375,6 +375,9 @@ public:
     void setEnabledVBO(bool b);
     bool isEnabledVBO() const;
     void setRenderCache(int);
+    void setRenderCulling(bool);
+    /// Number of separators rendered and culled in the last frame
+    void getCullingStatistics(int &rendered, int &culled) const;
 
     NavigationStyle* navigationStyle() const;
 
@@ -471,6 +474,8 @@ private:
     //stuff needed to draw the fps counter
     bool fpsEnabled;
     bool vboEnabled;
+    int renderedCount;
+    int culledCount;
     SbBool naviCubeEnabled;
 
     SbBool editing;
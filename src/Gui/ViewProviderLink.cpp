@@ -1120,9 +1120,16 @@ void LinkView::setSize(int _size) {
             nodeMap.erase(nodeArray[i]->pcSwitch);
         nodeArray.resize(size);
     }
+
+    // Large arrays would otherwise trigger one scene graph notification per
+    // added element. Notify only once after all elements are in place.
+    SbBool autonotify = pcLinkRoot->enableNotify(FALSE);
+
     for(auto &info : nodeArray)
         pcLinkRoot->addChild(info->pcSwitch);
 
+    nodeArray.reserve(size);
+    nodeMap.reserve(size);
     while(nodeArray.size()<size) {
         nodeArray.push_back(std::unique_ptr<Element>(new Element(*this)));
         auto &info = *nodeArray.back();
@@ -1132,6 +1139,9 @@ void LinkView::setSize(int _size) {
         pcLinkRoot->addChild(info.pcSwitch);
         nodeMap.emplace(info.pcSwitch,(int)nodeArray.size()-1);
     }
+
+    pcLinkRoot->enableNotify(autonotify);
+    pcLinkRoot->touch();
 }
 
 void LinkView::resetRoot() {
@@ -1190,6 +1200,8 @@ void LinkView::setChildren(const std::vector<App::DocumentObject*> &children,
         }
     }
     nodeMap.clear();
+    nodeMap.reserve(nodeArray.size());
+    SbBool autonotify = pcLinkRoot->enableNotify(FALSE);
     for(size_t i=0;i<nodeArray.size();++i) {
         auto &info = *nodeArray[i];
         nodeMap.emplace(info.pcSwitch,i);
@@ -1205,6 +1217,8 @@ void LinkView::setChildren(const std::vector<App::DocumentObject*> &children,
         }
         pcLinkRoot->addChild(info.pcSwitch);
     }
+    pcLinkRoot->enableNotify(autonotify);
+    pcLinkRoot->touch();
 }
 
 std::vector<ViewProviderDocumentObject*> LinkView::getChildren() const {
@@ -1230,6 +1244,23 @@ void LinkView::setTransform(int index, const Base::Matrix4D &mat) {
     setTransform(nodeArray[index]->pcTransform,mat);
 }
 
+void LinkView::setTransforms(const std::vector<Base::Matrix4D> &mats) {
+    // The element transforms are still touched to invalidate the caches of
+    // their own element, but the notification stops at the link root, which
+    // then notifies the rest of the scene once.
+    SbBool rootnotify = pcLinkRoot->enableNotify(FALSE);
+    for(size_t i=0;i<nodeArray.size();++i) {
+        auto &info = *nodeArray[i];
+        // SoTransform::setMatrix() touches five fields, collapse them into one
+        SbBool autonotify = info.pcTransform->enableNotify(FALSE);
+        setTransform(info.pcTransform,i<mats.size()?mats[i]:Base::Matrix4D());
+        info.pcTransform->enableNotify(autonotify);
+        info.pcTransform->touch();
+    }
+    pcLinkRoot->enableNotify(rootnotify);
+    pcLinkRoot->touch();
+}
+
 void LinkView::setElementVisible(int idx, bool visible) {
     if(idx>=0 && idx<(int)nodeArray.size())
         nodeArray[idx]->pcSwitch->whichChild = visible?0:-1;
@@ -1921,8 +1952,9 @@ void ViewProviderLink::updateDataPrivate(App::LinkBaseExtension *ext, const App:
                 const auto &touched = 
                     prop==propScales?propScales->getTouchList():propPlacements->getTouchList();
                 if(touched.empty()) {
+                    std::vector<Base::Matrix4D> mats(linkView->getSize());
                     for(int i=0;i<linkView->getSize();++i) {
-                        Base::Matrix4D mat;
+                        Base::Matrix4D &mat = mats[i];
                         if(propPlacements->getSize()>i) 
                             mat = (*propPlacements)[i].toMatrix();
                         if(propScales && propScales->getSize()>i) {
@@ -1930,8 +1962,8 @@ void ViewProviderLink::updateDataPrivate(App::LinkBaseExtension *ext, const App:
                             s.scale((*propScales)[i]);
                             mat *= s;
                         }
-                        linkView->setTransform(i,mat);
                     }
+                    linkView->setTransforms(mats);
                 }else{
                     for(int i : touched) {
                         if(i<0 || i>=linkView->getSize())
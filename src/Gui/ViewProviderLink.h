@@ -104,6 +104,8 @@ public:
     void setMaterial(int index, const App::Material *material);
     void setDrawStyle(int linePattern, double lineWidth=0, double pointSize=0);
     void setTransform(int index, const Base::Matrix4D &mat);
+    /// Set the transformation of all array elements at once, missing entries reset to identity
+    void setTransforms(const std::vector<Base::Matrix4D> &mats);
     void renderDoubleSide(bool);
     void setSize(int size);
 
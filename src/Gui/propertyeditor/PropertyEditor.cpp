@@ -362,6 +362,12 @@ void PropertyEditor::updateProperty(const App::Property& prop)
         propertyModel->updateProperty(prop);
 }
 
+void PropertyEditor::updateProperties(const std::unordered_set<const App::Property*>& props)
+{
+    if (!committing && !props.empty())
+        propertyModel->updateProperties(props);
+}
+
 void PropertyEditor::setEditorMode(const QModelIndex & parent, int start, int end)
 {
     int column = 1;
@@ -74,6 +74,7 @@ public:
     /** Builds up the list view with the properties. */
     void buildUp(PropertyModel::PropertyList &&props = PropertyModel::PropertyList(), bool checkDocument=false);
     void updateProperty(const App::Property&);
+    void updateProperties(const std::unordered_set<const App::Property*>&);
     void updateEditorMode(const App::Property&);
     bool appendProperty(const App::Property&);
     void removeProperty(const App::Property&);
@@ -303,6 +303,27 @@ void PropertyModel::updateProperty(const App::Property& prop)
     }
 }
 
+void PropertyModel::updateProperties(const std::unordered_set<const App::Property*>& props)
+{
+    int column = 1;
+    int numChild = rootItem->childCount();
+    for (int row=0; row<numChild; row++) {
+        PropertyItem* child = rootItem->child(row);
+        for (auto prop : child->getPropertyData()) {
+            if (!props.count(prop))
+                continue;
+            child->updateData();
+            QModelIndex data = this->index(row, column, QModelIndex());
+            if (data.isValid()) {
+                child->assignProperty(prop);
+                dataChanged(data, data);
+                updateChildren(child, column, data);
+            }
+            break;
+        }
+    }
+}
+
 void PropertyModel::appendProperty(const App::Property& prop)
 {
     std::string editor(prop.getEditorName());
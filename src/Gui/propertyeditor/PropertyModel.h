@@ -28,6 +28,7 @@
 #include <QStringList>
 #include <vector>
 #include <map>
+#include <unordered_set>
 
 namespace App {
 class Property;
@@ -61,6 +62,8 @@ public:
     bool removeRows(int row, int count, const QModelIndex & parent = QModelIndex());
 
     void updateProperty(const App::Property&);
+    /// Update all items of the given properties with a single pass over the rows
+    void updateProperties(const std::unordered_set<const App::Property*>&);
     void appendProperty(const App::Property&);
     void removeProperty(const App::Property&);
 
@@ -0,0 +1,603 @@
+/***************************************************************************
+ *   Copyright (c) 2020 FreeCAD developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Library General Public License (LGPL)   *
+ *   as published by the Free Software Foundation; either version 2 of     *
+ *   the License, or (at your option) any later version.                   *
+ *   for detail see the LICENCE text file.                                 *
+ *                                                                         *
+ *   FreeCAD is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with FreeCAD; if not, write to the Free Software        *
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+ *   USA                                                                   *
+ *                                                                         *
+ ***************************************************************************/
+#include "../FCConfig.h"
+
+#ifdef _PreComp_
+# undef _PreComp_
+#endif
+
+#if HAVE_CONFIG_H
+# include <config.h>
+#endif // HAVE_CONFIG_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// FreeCAD Base header
+#include <Base/Console.h>
+#include <Base/Exception.h>
+#include <Base/FileInfo.h>
+#include <Base/Interpreter.h>
+#include <Base/Parameter.h>
+#include <Base/Stream.h>
+#include <Base/Type.h>
+
+// FreeCAD doc header
+#include <App/Application.h>
+#include <App/Document.h>
+#include <App/FeatureTest.h>
+
+
+using Base::Console;
+using App::Application;
+
+/** @file MainBench.cpp
+ *  The FreeCADBench executable runs the benchmarks of the core libraries and
+ *  then the module benchmarks of Mod/Test/Benchmark.py. It writes one JSON
+ *  report of both.
+ *
+ *  Options, all other arguments are passed on to FreeCAD:
+ *  \code
+ *  --bench-output <file>   write the report to file instead of stdout
+ *  --bench-repeat <n>      timed runs of each benchmark (default 3)
+ *  --bench-scale <f>       scale factor of the generated inputs (default 1)
+ *  --bench-filter <text>   only run benchmarks whose name contains text
+ *  --bench-core-only       skip the module benchmarks
+ *  \endcode
+ */
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+/** Measures one run of a benchmark
+ *  The runner starts it before and stops it after the benchmark function,
+ *  which can exclude setup or cleanup code with pause() and resume().
+ */
+class Timer
+{
+public:
+    void resume() {
+        start = Clock::now();
+    }
+    void pause() {
+        elapsed += Clock::now() - start;
+    }
+    double seconds() const {
+        return std::chrono::duration<double>(elapsed).count();
+    }
+
+private:
+    Clock::time_point start;
+    Clock::duration elapsed = Clock::duration::zero();
+};
+
+struct Result
+{
+    std::string group;
+    std::string name;
+    std::size_t size;
+    std::vector<double> times;
+    std::string error;
+};
+
+class Runner
+{
+public:
+    typedef std::function<void(Timer&)> Function;
+
+    Runner(int repeat, double scale, const std::string &filter)
+        : repeat(repeat), scale(scale), filter(filter)
+    {
+    }
+
+    std::size_t size(std::size_t n) const {
+        return std::max<std::size_t>(1, static_cast<std::size_t>(std::lround(n * scale)));
+    }
+
+    bool selected(const std::string &group) const {
+        // a group is selected if any of its benchmarks could match
+        return filter.empty()
+            || group.find(filter) != std::string::npos
+            || filter.find(group) != std::string::npos;
+    }
+
+    void run(const char *group, const char *name, std::size_t size, const Function &func) {
+        std::string full = std::string(group) + "/" + name;
+        if (!filter.empty() && full.find(filter) == std::string::npos)
+            return;
+
+        Result res;
+        res.group = group;
+        res.name = name;
+        res.size = size;
+        try {
+            for (int i=0; i<repeat; ++i) {
+                Timer timer;
+                timer.resume();
+                func(timer);
+                timer.pause();
+                res.times.push_back(timer.seconds());
+            }
+        }
+        catch (const Base::Exception &e) {
+            res.error = e.what();
+        }
+        catch (const std::exception &e) {
+            res.error = e.what();
+        }
+        catch (...) {
+            res.error = "Unknown exception";
+        }
+
+        if (!res.error.empty())
+            Console().Error("Benchmark %s failed: %s\n", full.c_str(), res.error.c_str());
+        results.push_back(res);
+    }
+
+    const std::vector<Result> &getResults() const {
+        return results;
+    }
+
+private:
+    int repeat;
+    double scale;
+    std::string filter;
+    std::vector<Result> results;
+};
+
+/// Counts the messages, the observers of the console must be thread-safe in async mode
+class CountingLogger : public Base::ILogger
+{
+public:
+    CountingLogger() : count(0) {
+        bErr = bWrn = bLog = false;
+    }
+    virtual void SendLog(const std::string &, Base::LogStyle) {
+        ++count;
+    }
+    virtual const char *Name(void) {
+        return "Bench";
+    }
+    std::atomic<long> count;
+};
+
+/// Disables the messages of the standard observers while the console is measured
+class ConsoleSilencer
+{
+public:
+    ConsoleSilencer() {
+        for (const char *name : {"Console", "File"})
+            flags.emplace_back(name, Console().SetEnabledMsgType(name, Base::ConsoleSingleton::MsgType_Txt, false));
+    }
+    ~ConsoleSilencer() {
+        for (auto &v : flags) {
+            if (v.second)
+                Console().SetEnabledMsgType(v.first, v.second, true);
+        }
+    }
+
+private:
+    std::vector<std::pair<const char*, ConsoleMsgFlags> > flags;
+};
+
+//---------------------------------------------------------------------------
+// the benchmarks of the core libraries
+//---------------------------------------------------------------------------
+
+void benchConsole(Runner &runner)
+{
+    if (!runner.selected("console"))
+        return;
+
+    std::size_t count = runner.size(200000);
+    CountingLogger logger;
+    ConsoleSilencer silencer;
+    Console().AttachObserver(&logger);
+    auto mode = Console().GetConnectionMode();
+
+    runner.run("console", "message_direct", count, [&](Timer &) {
+        for (std::size_t i=0; i<count; ++i)
+            Console().Message("Benchmark message %d of %s\n", static_cast<int>(i), "console");
+    });
+
+    Console().SetConnectionMode(Base::ConsoleSingleton::Async);
+    runner.run("console", "message_async", count, [&](Timer &) {
+        for (std::size_t i=0; i<count; ++i)
+            Console().Message("Benchmark message %d of %s\n", static_cast<int>(i), "console");
+        Console().Flush();
+    });
+    Console().SetConnectionMode(mode);
+
+    Console().DetachObserver(&logger);
+}
+
+void benchParameter(Runner &runner)
+{
+    if (!runner.selected("parameter"))
+        return;
+
+    const char *path = "User parameter:BaseApp/Preferences/Bench";
+    std::size_t entries = runner.size(1000);
+    std::size_t lookups = runner.size(1000000);
+    std::vector<std::string> names;
+    for (std::size_t i=0; i<entries; ++i) {
+        std::stringstream str;
+        str << "Value" << i;
+        names.push_back(str.str());
+    }
+
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath(path);
+    runner.run("parameter", "set_int", entries, [&](Timer &) {
+        for (std::size_t i=0; i<entries; ++i)
+            hGrp->SetInt(names[i].c_str(), static_cast<long>(i));
+    });
+
+    runner.run("parameter", "get_int", lookups, [&](Timer &) {
+        long sum = 0;
+        for (std::size_t i=0; i<lookups; ++i)
+            sum += hGrp->GetInt(names[i % entries].c_str());
+        (void)sum;
+    });
+
+    runner.run("parameter", "group_by_path", lookups, [&](Timer &) {
+        for (std::size_t i=0; i<lookups; ++i)
+            App::GetApplication().GetParameterGroupByPath(path);
+    });
+
+    App::GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences")->RemoveGrp("Bench");
+}
+
+void benchType(Runner &runner)
+{
+    if (!runner.selected("type"))
+        return;
+
+    std::vector<Base::Type> types;
+    Base::Type::getAllDerivedFrom(Base::BaseClass::getClassTypeId(), types);
+    std::vector<std::string> names;
+    for (auto &type : types)
+        names.push_back(type.getName());
+
+    std::size_t lookups = runner.size(1000000);
+    runner.run("type", "from_name", lookups, [&](Timer &) {
+        std::size_t found = 0;
+        for (std::size_t i=0; i<lookups; ++i) {
+            if (!Base::Type::fromName(names[i % names.size()].c_str()).isBad())
+                ++found;
+        }
+        (void)found;
+    });
+
+    Base::Type bases[] = {
+        Base::Persistence::getClassTypeId(),
+        App::Property::getClassTypeId(),
+        App::DocumentObject::getClassTypeId(),
+        App::FeatureTest::getClassTypeId(),
+    };
+    runner.run("type", "is_derived_from", lookups, [&](Timer &) {
+        std::size_t derived = 0;
+        for (std::size_t i=0; i<lookups; ++i) {
+            if (types[i % types.size()].isDerivedFrom(bases[i % 4]))
+                ++derived;
+        }
+        (void)derived;
+    });
+}
+
+App::Document *newDocument(const char *name)
+{
+    App::Document *doc = App::GetApplication().newDocument(name, name, false);
+    doc->setUndoMode(0);
+    return doc;
+}
+
+void closeDocument(App::Document *doc)
+{
+    App::GetApplication().closeDocument(doc->getName());
+}
+
+/// Adds count test features, each linking to its predecessor if \a chain is set
+std::vector<App::FeatureTest*> addFeatures(App::Document *doc, std::size_t count, bool chain)
+{
+    std::vector<App::FeatureTest*> objs;
+    objs.reserve(count);
+    App::FeatureTest *prev = 0;
+    for (std::size_t i=0; i<count; ++i) {
+        auto obj = static_cast<App::FeatureTest*>(doc->addObject("App::FeatureTest", "Feature"));
+        obj->Integer.setValue(static_cast<long>(i));
+        if (chain)
+            obj->Source1.setValue(prev);
+        objs.push_back(obj);
+        prev = obj;
+    }
+    return objs;
+}
+
+void benchDocument(Runner &runner)
+{
+    if (!runner.selected("core_document"))
+        return;
+
+    std::size_t count = runner.size(50000);
+    runner.run("core_document", "add_objects", count, [&](Timer &timer) {
+        timer.pause();
+        App::Document *doc = newDocument("BenchCreate");
+        timer.resume();
+        addFeatures(doc, count, false);
+        timer.pause();
+        closeDocument(doc);
+        timer.resume();
+    });
+
+    App::Document *doc = newDocument("BenchSave");
+    addFeatures(doc, count, true);
+    doc->recompute();
+    std::string tmp = Base::FileInfo::getTempFileName("FreeCADBench");
+    std::string copy = tmp + "Copy.FCStd";
+    std::string file = tmp + ".FCStd";
+
+    runner.run("core_document", "save", count, [&](Timer &timer) {
+        doc->saveAs(copy.c_str());
+        timer.pause();
+        Base::FileInfo(copy).deleteFile();
+        timer.resume();
+    });
+
+    doc->saveAs(file.c_str());
+    closeDocument(doc);
+
+    runner.run("core_document", "restore", count, [&](Timer &timer) {
+        App::Document *opened = App::GetApplication().openDocument(file.c_str());
+        timer.pause();
+        if (opened)
+            closeDocument(opened);
+        timer.resume();
+    });
+    Base::FileInfo(file).deleteFile();
+}
+
+void benchProperties(Runner &runner)
+{
+    if (!runner.selected("core_properties"))
+        return;
+
+    std::size_t objects = runner.size(10000);
+    std::size_t changes = runner.size(100000);
+    App::Document *doc = newDocument("BenchProperties");
+    auto objs = addFeatures(doc, objects, false);
+
+    runner.run("core_properties", "set_value", changes, [&](Timer &) {
+        for (std::size_t i=0; i<changes; ++i)
+            objs[i % objects]->Integer.setValue(static_cast<long>(i));
+    });
+
+    runner.run("core_properties", "set_value_batch", changes, [&](Timer &) {
+        App::ChangeBatchLocker batch(doc);
+        for (std::size_t i=0; i<changes; ++i)
+            objs[i % objects]->Integer.setValue(static_cast<long>(i));
+    });
+
+    closeDocument(doc);
+}
+
+void benchRecompute(Runner &runner)
+{
+    if (!runner.selected("core_recompute"))
+        return;
+
+    std::size_t count = runner.size(20000);
+    App::Document *doc = newDocument("BenchRecompute");
+    auto objs = addFeatures(doc, count, true);
+    doc->recompute();
+
+    // the features are trivial, this is dominated by sorting and signalling
+    runner.run("core_recompute", "chain", count, [&](Timer &timer) {
+        timer.pause();
+        objs.front()->touch();
+        timer.resume();
+        doc->recompute();
+    });
+
+    runner.run("core_recompute", "chain_async", count, [&](Timer &timer) {
+        timer.pause();
+        objs.front()->touch();
+        timer.resume();
+        if (doc->recomputeAsync()) {
+            while (doc->processAsyncRecompute(10)) {
+            }
+        }
+    });
+
+    closeDocument(doc);
+}
+
+//---------------------------------------------------------------------------
+
+struct Options
+{
+    Options() : repeat(3), scale(1.0), coreOnly(false) {}
+    std::string output;
+    std::string filter;
+    int repeat;
+    double scale;
+    bool coreOnly;
+};
+
+/// Removes the options of the benchmark from the arguments passed to FreeCAD
+Options parseOptions(int &argc, char **argv)
+{
+    Options options;
+    int j = 1;
+    for (int i=1; i<argc; ++i) {
+        const char *arg = argv[i];
+        bool hasValue = i+1 < argc;
+        if (std::strcmp(arg, "--bench-output") == 0 && hasValue)
+            options.output = argv[++i];
+        else if (std::strcmp(arg, "--bench-filter") == 0 && hasValue)
+            options.filter = argv[++i];
+        else if (std::strcmp(arg, "--bench-repeat") == 0 && hasValue)
+            options.repeat = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(arg, "--bench-scale") == 0 && hasValue)
+            options.scale = std::atof(argv[++i]);
+        else if (std::strcmp(arg, "--bench-core-only") == 0)
+            options.coreOnly = true;
+        else
+            argv[j++] = argv[i];
+    }
+    argc = j;
+    argv[argc] = 0;
+    if (options.scale <= 0.0)
+        options.scale = 1.0;
+    return options;
+}
+
+/// Runs the module benchmarks and returns the report of all results
+std::string writeReport(const Runner &runner, const Options &options)
+{
+    Base::PyGILStateLocker lock;
+    PyObject *module = PyImport_ImportModule("Benchmark");
+    if (!module)
+        throw Base::PyException();
+    Py::Module bench(module, true);
+
+    Py::Callable makeResult(bench.getAttr("makeResult"));
+    Py::List results;
+    for (auto &res : runner.getResults()) {
+        Py::List times;
+        for (double t : res.times)
+            times.append(Py::Float(t));
+        Py::Object error = res.error.empty() ? Py::None() : Py::Object(Py::String(res.error));
+        results.append(makeResult.apply(Py::TupleN(Py::String(res.group), Py::String(res.name),
+                                                   Py::Long(static_cast<long>(res.size)), times, error)));
+    }
+
+    Py::Float scale(options.scale);
+    Py::Long repeat(options.repeat);
+    if (!options.coreOnly) {
+        Py::Callable run(bench.getAttr("run"));
+        Py::Object filter = options.filter.empty() ? Py::None() : Py::Object(Py::String(options.filter));
+        Py::List modules(run.apply(Py::TupleN(repeat, scale, filter)));
+        for (Py::List::size_type i=0; i<modules.size(); ++i)
+            results.append(modules[i]);
+    }
+
+    Py::Callable report(bench.getAttr("report"));
+    return Py::String(report.apply(Py::TupleN(results, repeat, scale))).as_std_string("utf-8");
+}
+
+} // namespace
+
+int main( int argc, char ** argv )
+{
+    // Make sure that we use '.' as decimal point
+    setlocale(LC_ALL, "");
+    setlocale(LC_NUMERIC, "C");
+
+    Options options = parseOptions(argc, argv);
+
+    // Name and Version of the Application
+    App::Application::Config()["ExeName"] = "FreeCAD";
+    App::Application::Config()["ExeVendor"] = "FreeCAD";
+    App::Application::Config()["AppDataSkipVendor"] = "true";
+
+    try {
+        App::Application::Config()["RunMode"] = "Exit";
+        App::Application::Config()["LoggingConsole"] = "1";
+        App::Application::init(argc,argv);
+    }
+    catch (const Base::UnknownProgramOption& e) {
+        std::cerr << e.what();
+        exit(1);
+    }
+    catch (const Base::ProgramInformation& e) {
+        std::cout << e.what();
+        exit(0);
+    }
+    catch (const Base::Exception& e) {
+        std::cerr << "Initialization of FreeCADBench failed: " << e.what() << std::endl;
+        exit(100);
+    }
+    catch (...) {
+        std::cerr << "Initialization of FreeCADBench failed" << std::endl;
+        exit(101);
+    }
+
+    int ret = 0;
+    try {
+        Runner runner(options.repeat, options.scale, options.filter);
+        benchConsole(runner);
+        benchParameter(runner);
+        benchType(runner);
+        benchDocument(runner);
+        benchProperties(runner);
+        benchRecompute(runner);
+
+        std::string report = writeReport(runner, options);
+        if (options.output.empty()) {
+            std::cout << report << std::endl;
+        }
+        else {
+            Base::FileInfo fi(options.output);
+            Base::ofstream str(fi, std::ios::out | std::ios::binary);
+            str << report << std::endl;
+            if (!str) {
+                Console().Error("Cannot write benchmark report to %s\n", options.output.c_str());
+                ret = 1;
+            }
+        }
+    }
+    catch (const Base::Exception& e) {
+        e.ReportException();
+        ret = 1;
+    }
+    catch (Py::Exception&) {
+        Base::PyGILStateLocker lock;
+        Base::PyException e; // extract the Python error text
+        e.ReportException();
+        ret = 1;
+    }
+    catch (...) {
+        Console().Error("Benchmark unexpectedly terminated\n");
+        ret = 1;
+    }
+
+    try {
+        App::GetApplication().closeAllDocuments();
+    }
+    catch(...) {
+    }
+
+    Application::destruct();
+
+    return ret;
+}
@@ -48,6 +48,7 @@
 #include <Mod/Mesh/App/Mesh.h>
 #include <Mod/Mesh/App/MeshFeature.h>
 #include <Mod/Mesh/App/Core/Algorithm.h>
+#include <Mod/Mesh/App/Core/BVH.h>
 #include <Mod/Mesh/App/Core/Grid.h>
 #include <Mod/Mesh/App/Core/Iterator.h>
 #include <Mod/Mesh/App/Core/MeshKernel.h>
@@ -257,15 +258,25 @@ namespace Inspection {
     };
 }
 
-InspectNominalMesh::InspectNominalMesh(const Mesh::MeshObject& rMesh, float offset) : _mesh(rMesh.getKernel())
+InspectNominalMesh::InspectNominalMesh(const Mesh::MeshObject& rMesh, float offset)
+  : _mesh(rMesh.getKernel()), _pGrid(0), _pBVH(0)
 {
     Base::Matrix4D tmp;
     _clTrf = rMesh.getTransform();
     _bApply = _clTrf != tmp;
 
+    Base::BoundBox3f box = _mesh.GetBoundBox().Transformed(rMesh.getTransform());
+    _box = box;
+    _box.Enlarge(offset);
+
+    // The hierarchy adapts to the facet density and gives the exact nearest facet
+    if (MeshCore::MeshDefinitions::_bUseFacetBVH) {
+        _pBVH = new MeshCore::MeshFacetBVH(_mesh, _clTrf);
+        return;
+    }
+
     // Max. limit of grid elements
     float fMaxGridElements=8000000.0f;
-    Base::BoundBox3f box = _mesh.GetBoundBox().Transformed(rMesh.getTransform());
 
     // estimate the minimum allowed grid length
     float fMinGridLen = (float)pow((box.LengthX()*box.LengthY()*box.LengthZ()/fMaxGridElements), 0.3333f);
@@ -279,13 +290,12 @@ InspectNominalMesh::InspectNominalMesh(const Mesh::MeshObject& rMesh, float offs
 
     // build up grid structure to speed up algorithms
     _pGrid = new MeshInspectGrid(_mesh, fGridLen, rMesh.getTransform());
-    _box = box;
-    _box.Enlarge(offset);
 }
 
 InspectNominalMesh::~InspectNominalMesh()
 {
     delete this->_pGrid;
+    delete this->_pBVH;
 }
 
 float InspectNominalMesh::getDistance(const Base::Vector3f& point) const
@@ -293,6 +303,21 @@ float InspectNominalMesh::getDistance(const Base::Vector3f& point) const
     if (!_box.IsInBox(point))
         return FLT_MAX; // must be inside bbox
 
+    if (_pBVH) {
+        unsigned long index;
+        float fDist;
+        if (!_pBVH->SearchNearestFacet(point, index, fDist))
+            return FLT_MAX;
+
+        MeshCore::MeshGeomFacet geomFace = _mesh.GetFacet(index);
+        if (_bApply) {
+            geomFace.Transform(_clTrf);
+        }
+        if (point.DistanceToPlane(geomFace._aclPoints[0], geomFace.GetNormal()) > 0)
+            return fDist;
+        return -fDist;
+    }
+
     std::vector<unsigned long> indices;
     //_pGrid->GetElements(point, indices);
     if (indices.empty()) {
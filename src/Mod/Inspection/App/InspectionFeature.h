@@ -37,6 +37,7 @@ class BRepExtrema_DistShapeShape;
 namespace MeshCore {
 class MeshKernel;
 class MeshGrid;
+class MeshFacetBVH;
 }
 
 namespace Mesh   { class MeshObject; }
@@ -113,6 +114,7 @@ public:
 private:
     const MeshCore::MeshKernel& _mesh;
     MeshCore::MeshGrid* _pGrid;
+    MeshCore::MeshFacetBVH* _pBVH;
     Base::BoundBox3f _box;
     bool _bApply;
     Base::Matrix4D _clTrf;
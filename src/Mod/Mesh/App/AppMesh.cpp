@@ -63,6 +63,7 @@ PyMOD_INIT_FUNC(Mesh)
     ParameterGrp::handle asy = handle->GetGroup("Asymptote");
     MeshCore::MeshOutput::SetAsymptoteSize(asy->GetASCII("Width", "500"),
                                            asy->GetASCII("Height"));
+    MeshCore::MeshDefinitions::_bUseFacetBVH = handle->GetBool("UseFacetBVH", false);
 
     // add mesh elements
     Base::Interpreter().addType(&Mesh::MeshPointPy  ::Type,meshModule,"MeshPoint");
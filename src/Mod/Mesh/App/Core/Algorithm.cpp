@@ -29,7 +29,9 @@
 
 #include "Algorithm.h"
 #include "Approximation.h"
+#include "BVH.h"
 #include "Elements.h"
+#include "Functional.h"
 #include "Iterator.h"
 #include "Grid.h"
 #include "Triangulation.h"
@@ -119,6 +121,12 @@ bool MeshAlgorithm::NearestFacetOnRay (const Base::Vector3f &rclPt, const Base::
     return false;
 }
 
+bool MeshAlgorithm::NearestFacetOnRay (const Base::Vector3f &rclPt, const Base::Vector3f &rclDir, const MeshFacetBVH &rclBVH,
+                                       Base::Vector3f &rclRes, unsigned long &rulFacet) const
+{
+    return rclBVH.NearestFacetOnRay(rclPt, rclDir, rclRes, rulFacet, true);
+}
+
 bool MeshAlgorithm::NearestFacetOnRay (const Base::Vector3f &rclPt, const Base::Vector3f &rclDir, float fMaxSearchArea,
                                        const MeshFacetGrid &rclGrid, Base::Vector3f &rclRes, unsigned long &rulFacet) const
 {
@@ -1982,6 +1990,219 @@ void MeshRefPointToPoints::RemoveNeighbour(unsigned long pos, unsigned long face
 
 //----------------------------------------------------------------------------
 
+std::vector<unsigned long>
+MeshAdjacency::GetIndices(unsigned long pos1, unsigned long pos2) const
+{
+    std::vector<unsigned long> intersection;
+    std::back_insert_iterator<std::vector<unsigned long> > result(intersection);
+    Range set1 = (*this)[pos1];
+    Range set2 = (*this)[pos2];
+    std::set_intersection(set1.begin(), set1.end(), set2.begin(), set2.end(), result);
+    return intersection;
+}
+
+std::size_t MeshAdjacency::GetMemSize() const
+{
+    return sizeof(*this) + (_offsets.capacity() + _indices.capacity()) * sizeof(unsigned long);
+}
+
+void MeshAdjacency::BuildRows(std::size_t numRows,
+                              const std::function<void(unsigned long, std::vector<unsigned long>&)>& collect)
+{
+    _offsets.assign(numRows + 1, 0);
+    _indices.clear();
+    if (numRows == 0)
+        return;
+
+    // first pass: count the entries of each row
+    parallel_blocks(numRows, [this, &collect](std::size_t begin, std::size_t end) {
+        std::vector<unsigned long> row;
+        for (std::size_t i = begin; i < end; i++) {
+            row.clear();
+            collect(static_cast<unsigned long>(i), row);
+            std::sort(row.begin(), row.end());
+            _offsets[i + 1] = static_cast<unsigned long>(std::unique(row.begin(), row.end()) - row.begin());
+        }
+    });
+
+    for (std::size_t i = 0; i < numRows; i++)
+        _offsets[i + 1] += _offsets[i];
+    _indices.resize(_offsets[numRows]);
+
+    // second pass: fill in the entries at their final position
+    parallel_blocks(numRows, [this, &collect](std::size_t begin, std::size_t end) {
+        std::vector<unsigned long> row;
+        for (std::size_t i = begin; i < end; i++) {
+            row.clear();
+            collect(static_cast<unsigned long>(i), row);
+            std::sort(row.begin(), row.end());
+            std::vector<unsigned long>::iterator last = std::unique(row.begin(), row.end());
+            std::copy(row.begin(), last, _indices.begin() + _offsets[i]);
+        }
+    });
+}
+
+//----------------------------------------------------------------------------
+
+void MeshCompactPointToFacets::Rebuild (void)
+{
+    const MeshFacetArray& rFacets = _rclMesh.GetFacets();
+    std::size_t numPoints = _rclMesh.CountPoints();
+    _offsets.assign(numPoints + 1, 0);
+
+    // Scattering facets to their points would need atomics to be done in parallel.
+    // A sequential count and fill is memory bound anyway and keeps the rows sorted
+    // because the facets are visited in ascending order.
+    for (MeshFacetArray::_TConstIterator pFIter = rFacets.begin(); pFIter != rFacets.end(); ++pFIter) {
+        const unsigned long* p = pFIter->_aulPoints;
+        _offsets[p[0] + 1]++;
+        if (p[1] != p[0])
+            _offsets[p[1] + 1]++;
+        if (p[2] != p[0] && p[2] != p[1])
+            _offsets[p[2] + 1]++;
+    }
+
+    for (std::size_t i = 0; i < numPoints; i++)
+        _offsets[i + 1] += _offsets[i];
+
+    _indices.resize(_offsets[numPoints]);
+    std::vector<unsigned long> fill(_offsets.begin(), _offsets.end() - 1);
+    MeshFacetArray::_TConstIterator pFBegin = rFacets.begin();
+    for (MeshFacetArray::_TConstIterator pFIter = pFBegin; pFIter != rFacets.end(); ++pFIter) {
+        const unsigned long* p = pFIter->_aulPoints;
+        unsigned long index = pFIter - pFBegin;
+        _indices[fill[p[0]]++] = index;
+        if (p[1] != p[0])
+            _indices[fill[p[1]]++] = index;
+        if (p[2] != p[0] && p[2] != p[1])
+            _indices[fill[p[2]]++] = index;
+    }
+}
+
+Base::Vector3f MeshCompactPointToFacets::GetNormal(unsigned long pos) const
+{
+    Range n = (*this)[pos];
+    Base::Vector3f normal;
+    MeshGeomFacet f;
+    for (Range::const_iterator it = n.begin(); it != n.end(); ++it) {
+        f = _rclMesh.GetFacet(*it);
+        normal += f.Area() * f.GetNormal();
+    }
+
+    normal.Normalize();
+    return normal;
+}
+
+std::vector<unsigned long> MeshCompactPointToFacets::NeighbourPoints(unsigned long pos) const
+{
+    std::vector<unsigned long> p;
+    const MeshFacetArray& rFacets = _rclMesh.GetFacets();
+    Range vf = (*this)[pos];
+    p.reserve(2 * vf.size());
+    for (Range::const_iterator it = vf.begin(); it != vf.end(); ++it) {
+        const MeshFacet& face = rFacets[*it];
+        for (int i = 0; i < 3; i++) {
+            if (face._aulPoints[i] != pos)
+                p.push_back(face._aulPoints[i]);
+        }
+    }
+
+    std::sort(p.begin(), p.end());
+    p.erase(std::unique(p.begin(), p.end()), p.end());
+    return p;
+}
+
+void MeshCompactPointToFacets::Neighbours (unsigned long ulFacetInd, float fMaxDist, MeshCollector& collect) const
+{
+    const MeshFacetArray& rFacets = _rclMesh.GetFacets();
+    Base::Vector3f clCenter = _rclMesh.GetFacet(ulFacetInd).GetGravityPoint();
+    float fMaxDist2 = fMaxDist * fMaxDist;
+
+    // breadth-first instead of recursion so that large radii cannot overflow the stack
+    std::set<unsigned long> visited;
+    std::vector<unsigned long> front;
+    front.push_back(ulFacetInd);
+    visited.insert(ulFacetInd);
+    while (!front.empty()) {
+        unsigned long index = front.back();
+        front.pop_back();
+
+        const MeshFacet& face = rFacets[index];
+        if (Base::DistanceP2(clCenter, _rclMesh.GetFacet(face).GetGravityPoint()) > fMaxDist2)
+            continue;
+
+        collect.Append(_rclMesh, index);
+        for (int i = 0; i < 3; i++) {
+            Range f = (*this)[face._aulPoints[i]];
+            for (Range::const_iterator j = f.begin(); j != f.end(); ++j) {
+                if (visited.insert(*j).second)
+                    front.push_back(*j);
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+
+void MeshCompactFacetToFacets::Rebuild (const MeshCompactPointToFacets& vf)
+{
+    const MeshFacetArray& rFacets = _rclMesh.GetFacets();
+    BuildRows(rFacets.size(), [&rFacets, &vf](unsigned long index, std::vector<unsigned long>& row) {
+        for (int i = 0; i < 3; i++) {
+            MeshAdjacency::Range faces = vf[rFacets[index]._aulPoints[i]];
+            row.insert(row.end(), faces.begin(), faces.end());
+        }
+    });
+}
+
+//----------------------------------------------------------------------------
+
+void MeshCompactPointToPoints::Rebuild (const MeshCompactPointToFacets& vf)
+{
+    const MeshFacetArray& rFacets = _rclMesh.GetFacets();
+    BuildRows(_rclMesh.CountPoints(), [&rFacets, &vf](unsigned long pos, std::vector<unsigned long>& row) {
+        MeshAdjacency::Range faces = vf[pos];
+        for (MeshAdjacency::Range::const_iterator it = faces.begin(); it != faces.end(); ++it) {
+            const MeshFacet& face = rFacets[*it];
+            for (int i = 0; i < 3; i++) {
+                if (face._aulPoints[i] != pos)
+                    row.push_back(face._aulPoints[i]);
+            }
+        }
+    });
+}
+
+Base::Vector3f MeshCompactPointToPoints::GetNormal(unsigned long pos) const
+{
+    const MeshPointArray& rPoints = _rclMesh.GetPoints();
+    MeshCore::PlaneFit pf;
+    pf.AddPoint(rPoints[pos]);
+    Range cv = (*this)[pos];
+    for (Range::const_iterator cv_it = cv.begin(); cv_it != cv.end(); ++cv_it) {
+        pf.AddPoint(rPoints[*cv_it]);
+    }
+
+    pf.Fit();
+
+    Base::Vector3f normal = pf.GetNormal();
+    normal.Normalize();
+    return normal;
+}
+
+float MeshCompactPointToPoints::GetAverageEdgeLength(unsigned long index) const
+{
+    const MeshPointArray& rPoints = _rclMesh.GetPoints();
+    float len=0.0f;
+    Range n = (*this)[index];
+    const Base::Vector3f& p = rPoints[index];
+    for (Range::const_iterator it = n.begin(); it != n.end(); ++it) {
+        len += Base::Distance(p, rPoints[*it]);
+    }
+    return (len/n.size());
+}
+
+//----------------------------------------------------------------------------
+
 void MeshRefEdgeToFacets::Rebuild (void)
 {
     _map.clear();
@@ -24,6 +24,8 @@
 #ifndef MESHALGORITHM_H
 #define MESHALGORITHM_H
 
+#include <algorithm>
+#include <functional>
 #include <set>
 #include <vector>
 #include <map>
@@ -45,6 +47,7 @@ class MeshGeomFacet;
 class MeshGeomEdge;
 class MeshKernel;
 class MeshFacetGrid;
+class MeshFacetBVH;
 class MeshFacetArray;
 class MeshRefPointToFacets;
 class AbstractPolygonTriangulator;
@@ -81,6 +84,17 @@ public:
    */
   bool NearestFacetOnRay (const Base::Vector3f &rclPt, const Base::Vector3f &rclDir, const MeshFacetGrid &rclGrid,
                           Base::Vector3f &rclRes, unsigned long &rulFacet) const;
+  /**
+   * Searches for the nearest facet to the ray defined by
+   * (\a rclPt, \a rclDir).
+   * The point \a rclRes holds the intersection point with the ray and the
+   * nearest facet with index \a rulFacet.
+   * \note This method uses a bounding volume hierarchy which in contrast to
+   * the grid also works well for meshes with a very uneven facet density.
+   * Like the grid version it only searches in direction of \a rclDir.
+   */
+  bool NearestFacetOnRay (const Base::Vector3f &rclPt, const Base::Vector3f &rclDir, const MeshFacetBVH &rclBVH,
+                          Base::Vector3f &rclRes, unsigned long &rulFacet) const;
   /**
    * Searches for the nearest facet to the ray defined by
    * (\a rclPt, \a rclDir).
@@ -459,6 +473,132 @@ protected:
     std::vector<std::set<unsigned long> > _map;
 };
 
+/**
+ * The MeshAdjacency class is the common base of the compact topology structures.
+ * The relation is stored in compressed sparse row layout: the neighbours of element
+ * \a i are the entries in the range [offsets[i], offsets[i+1]) of one flat index
+ * array. Each row is sorted and free of duplicates so it can be iterated in the
+ * same order as the std::set of the MeshRef* classes, but it needs two allocations
+ * in total instead of one tree node per entry.
+ * \note The compact structures are read-only. If the underlying mesh kernel gets
+ * changed they become invalid and must be rebuilt.
+ */
+class MeshExport MeshAdjacency
+{
+public:
+    /// A read-only view onto the neighbours of one element.
+    class Range
+    {
+    public:
+        typedef const unsigned long* const_iterator;
+
+        Range(const_iterator b, const_iterator e) : _begin(b), _end(e)
+        { }
+        const_iterator begin() const
+        { return _begin; }
+        const_iterator end() const
+        { return _end; }
+        std::size_t size() const
+        { return static_cast<std::size_t>(_end - _begin); }
+        bool empty() const
+        { return _begin == _end; }
+        /// Checks whether \a index is in the range.
+        bool contains(unsigned long index) const
+        { return std::binary_search(_begin, _end, index); }
+
+    private:
+        const_iterator _begin;
+        const_iterator _end;
+    };
+
+    /// Returns the number of rows.
+    std::size_t size() const
+    { return _offsets.empty() ? 0 : _offsets.size() - 1; }
+    /// Returns the neighbours of the element with index \a pos.
+    Range operator[] (unsigned long pos) const
+    {
+        const unsigned long* data = _indices.empty() ? nullptr : &_indices[0];
+        return Range(data + _offsets[pos], data + _offsets[pos + 1]);
+    }
+    /// Returns the indices shared by the rows \a pos1 and \a pos2.
+    std::vector<unsigned long> GetIndices(unsigned long pos1, unsigned long pos2) const;
+    /// Returns the number of bytes allocated by this structure.
+    std::size_t GetMemSize() const;
+
+protected:
+    MeshAdjacency(const MeshKernel &rclM) : _rclMesh(rclM)
+    { }
+    ~MeshAdjacency()
+    { }
+
+    /**
+     * Builds up rows derived from another relation. \a collect is called twice per row,
+     * once to count and once to fill in the entries. It must append the neighbours of
+     * the given row to the passed vector. Sorting and removing duplicates is done here.
+     * Both passes run over blocks of rows in parallel.
+     */
+    void BuildRows(std::size_t numRows,
+                   const std::function<void(unsigned long, std::vector<unsigned long>&)>& collect);
+
+protected:
+    const MeshKernel  &_rclMesh; /**< The mesh kernel. */
+    std::vector<unsigned long> _offsets;
+    std::vector<unsigned long> _indices;
+};
+
+/**
+ * The MeshCompactPointToFacets is the compact counterpart of MeshRefPointToFacets.
+ */
+class MeshExport MeshCompactPointToFacets : public MeshAdjacency
+{
+public:
+    /// Construction
+    MeshCompactPointToFacets (const MeshKernel &rclM) : MeshAdjacency(rclM)
+    { Rebuild(); }
+
+    /// Rebuilds up data structure
+    void Rebuild (void);
+    /// Returns the sorted neighbour points of the point with index \a pos.
+    std::vector<unsigned long> NeighbourPoints(unsigned long pos) const;
+    /// Collects all facets around \a ulFacetInd whose centers are closer than \a fMaxDist.
+    void Neighbours (unsigned long ulFacetInd, float fMaxDist, MeshCollector& collect) const;
+    Base::Vector3f GetNormal(unsigned long) const;
+};
+
+/**
+ * The MeshCompactFacetToFacets is the compact counterpart of MeshRefFacetToFacets.
+ */
+class MeshExport MeshCompactFacetToFacets : public MeshAdjacency
+{
+public:
+    /// Construction
+    MeshCompactFacetToFacets (const MeshKernel &rclM) : MeshAdjacency(rclM)
+    { Rebuild(MeshCompactPointToFacets(rclM)); }
+    MeshCompactFacetToFacets (const MeshCompactPointToFacets &vf, const MeshKernel &rclM) : MeshAdjacency(rclM)
+    { Rebuild(vf); }
+
+    /// Rebuilds up data structure from the point to facets relation of the same mesh
+    void Rebuild (const MeshCompactPointToFacets&);
+};
+
+/**
+ * The MeshCompactPointToPoints is the compact counterpart of MeshRefPointToPoints.
+ */
+class MeshExport MeshCompactPointToPoints : public MeshAdjacency
+{
+public:
+    /// Construction
+    MeshCompactPointToPoints (const MeshKernel &rclM) : MeshAdjacency(rclM)
+    { Rebuild(MeshCompactPointToFacets(rclM)); }
+    MeshCompactPointToPoints (const MeshCompactPointToFacets &vf, const MeshKernel &rclM) : MeshAdjacency(rclM)
+    { Rebuild(vf); }
+
+    /// Rebuilds up data structure from the point to facets relation of the same mesh
+    void Rebuild (const MeshCompactPointToFacets&);
+    Base::Vector3f GetNormal(unsigned long) const;
+    float GetAverageEdgeLength(unsigned long) const;
+};
+
 /**
  * The MeshRefEdgeToFacets builds up a structure to have access to all facets 
  * of an edge. On a manifold mesh an edge has one or two facets associated.
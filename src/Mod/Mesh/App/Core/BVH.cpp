@@ -0,0 +1,416 @@
+/***************************************************************************
+ *   Copyright (c) 2020 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <cmath>
+#endif
+
+#include "BVH.h"
+#include "MeshKernel.h"
+
+using namespace MeshCore;
+
+namespace {
+// Maximum number of facets in a leaf
+const unsigned long MaxLeafSize = 4;
+// Number of bins along an axis to evaluate the surface area heuristic
+const int NumBins = 16;
+
+inline float Coordinate(const Base::Vector3f& v, int axis)
+{
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+// Half of the surface area which is sufficient to compare split costs
+inline float SurfaceArea(const Base::BoundBox3f& box)
+{
+    if (!box.IsValid())
+        return 0.0f;
+    float lx = box.LengthX();
+    float ly = box.LengthY();
+    float lz = box.LengthZ();
+    return lx * ly + ly * lz + lz * lx;
+}
+
+// Returns false if the line doesn't hit the slab [lo, hi], otherwise narrows [tmin, tmax]
+inline bool ClipSlab(float p, float d, float lo, float hi, float& tmin, float& tmax)
+{
+    if (d == 0.0f)
+        return p >= lo && p <= hi;
+    float t1 = (lo - p) / d;
+    float t2 = (hi - p) / d;
+    if (t1 > t2)
+        std::swap(t1, t2);
+    tmin = std::max<float>(tmin, t1);
+    tmax = std::min<float>(tmax, t2);
+    return tmin <= tmax;
+}
+}
+
+MeshFacetBVH::MeshFacetBVH (const MeshKernel &rclMesh)
+  : _rclMesh(rclMesh), _bApply(false)
+{
+    Rebuild();
+}
+
+MeshFacetBVH::MeshFacetBVH (const MeshKernel &rclMesh, const Base::Matrix4D &rclMat)
+  : _rclMesh(rclMesh), _clTransform(rclMat)
+{
+    Base::Matrix4D clIdentity;
+    _bApply = (rclMat != clIdentity);
+    Rebuild();
+}
+
+MeshFacetBVH::~MeshFacetBVH ()
+{
+}
+
+void MeshFacetBVH::Rebuild ()
+{
+    _aclNodes.clear();
+    _aulFacets.clear();
+    _aclPoints.clear();
+
+    const MeshPointArray& rPoints = _rclMesh.GetPoints();
+    const MeshFacetArray& rFacets = _rclMesh.GetFacets();
+    unsigned long ulCtFacets = rFacets.size();
+    if (ulCtFacets == 0)
+        return;
+
+    // corners, bounding box and center of each facet
+    std::vector<Base::Vector3f> corners(3 * ulCtFacets);
+    std::vector<Base::BoundBox3f> boxes(ulCtFacets);
+    std::vector<Base::Vector3f> centers(ulCtFacets);
+    Base::BoundBox3f clTotal;
+    for (unsigned long i = 0; i < ulCtFacets; i++) {
+        for (int j = 0; j < 3; j++) {
+            Base::Vector3f clPnt = rPoints[rFacets[i]._aulPoints[j]];
+            if (_bApply)
+                clPnt = _clTransform * clPnt;
+            corners[3 * i + j] = clPnt;
+            boxes[i].Add(clPnt);
+        }
+        centers[i] = boxes[i].GetCenter();
+        clTotal.Add(boxes[i]);
+    }
+
+    // the node boxes are slightly enlarged so that rounding errors in the
+    // box tests don't reject facets that are hit at their border
+    float fEpsilon = 1.0e-6f * clTotal.CalcDiagonalLength();
+
+    _aulFacets.resize(ulCtFacets);
+    for (unsigned long i = 0; i < ulCtFacets; i++)
+        _aulFacets[i] = i;
+
+    Node clRoot;
+    clRoot.first = 0;
+    clRoot.count = ulCtFacets;
+    _aclNodes.push_back(clRoot);
+
+    std::vector<unsigned long> aulTodo(1, 0);
+    while (!aulTodo.empty()) {
+        unsigned long ulNode = aulTodo.back();
+        aulTodo.pop_back();
+
+        unsigned long ulFirst = _aclNodes[ulNode].first;
+        unsigned long ulCount = _aclNodes[ulNode].count;
+        unsigned long ulLast = ulFirst + ulCount;
+
+        Base::BoundBox3f clBox, clCenters;
+        for (unsigned long k = ulFirst; k < ulLast; k++) {
+            clBox.Add(boxes[_aulFacets[k]]);
+            clCenters.Add(centers[_aulFacets[k]]);
+        }
+        clBox.Enlarge(fEpsilon);
+        _aclNodes[ulNode].box = clBox;
+
+        if (ulCount <= MaxLeafSize)
+            continue;
+
+        // find the cheapest split between the bins of the facet centers
+        int iBestAxis = -1;
+        int iBestBin = 0;
+        float fBestCost = FLT_MAX;
+        float fBestMin = 0.0f, fBestScale = 0.0f;
+        for (int axis = 0; axis < 3; axis++) {
+            float fMin = Coordinate(Base::Vector3f(clCenters.MinX, clCenters.MinY, clCenters.MinZ), axis);
+            float fMax = Coordinate(Base::Vector3f(clCenters.MaxX, clCenters.MaxY, clCenters.MaxZ), axis);
+            if (fMax <= fMin)
+                continue;
+
+            float fScale = float(NumBins) / (fMax - fMin);
+            unsigned long aulBinCount[NumBins] = {0};
+            Base::BoundBox3f aclBinBox[NumBins];
+            for (unsigned long k = ulFirst; k < ulLast; k++) {
+                unsigned long ulFacet = _aulFacets[k];
+                int bin = std::min<int>(NumBins - 1, int((Coordinate(centers[ulFacet], axis) - fMin) * fScale));
+                aulBinCount[bin]++;
+                aclBinBox[bin].Add(boxes[ulFacet]);
+            }
+
+            float afRightArea[NumBins];
+            unsigned long aulRightCount[NumBins];
+            Base::BoundBox3f clAccum;
+            unsigned long ulAccum = 0;
+            for (int bin = NumBins - 1; bin > 0; bin--) {
+                clAccum.Add(aclBinBox[bin]);
+                ulAccum += aulBinCount[bin];
+                afRightArea[bin] = SurfaceArea(clAccum);
+                aulRightCount[bin] = ulAccum;
+            }
+
+            clAccum = Base::BoundBox3f();
+            ulAccum = 0;
+            for (int bin = 0; bin < NumBins - 1; bin++) {
+                clAccum.Add(aclBinBox[bin]);
+                ulAccum += aulBinCount[bin];
+                if (ulAccum == 0 || aulRightCount[bin + 1] == 0)
+                    continue;
+                float fCost = SurfaceArea(clAccum) * float(ulAccum) +
+                              afRightArea[bin + 1] * float(aulRightCount[bin + 1]);
+                if (fCost < fBestCost) {
+                    fBestCost = fCost;
+                    iBestAxis = axis;
+                    iBestBin = bin;
+                    fBestMin = fMin;
+                    fBestScale = fScale;
+                }
+            }
+        }
+
+        unsigned long ulMid = ulFirst + ulCount / 2;
+        if (iBestAxis >= 0) {
+            std::vector<unsigned long>::iterator it = std::partition(
+                _aulFacets.begin() + ulFirst, _aulFacets.begin() + ulLast,
+                [&](unsigned long ulFacet) {
+                    int bin = std::min<int>(NumBins - 1, int((Coordinate(centers[ulFacet], iBestAxis) - fBestMin) * fBestScale));
+                    return bin <= iBestBin;
+                });
+            unsigned long ulPart = static_cast<unsigned long>(it - _aulFacets.begin());
+            if (ulPart > ulFirst && ulPart < ulLast)
+                ulMid = ulPart;
+        }
+        // otherwise all centers coincide and the facets are simply halved
+
+        Node clLeft, clRight;
+        clLeft.first = ulFirst;
+        clLeft.count = ulMid - ulFirst;
+        clRight.first = ulMid;
+        clRight.count = ulLast - ulMid;
+
+        unsigned long ulChild = _aclNodes.size();
+        _aclNodes[ulNode].first = ulChild;
+        _aclNodes[ulNode].count = 0;
+        _aclNodes.push_back(clLeft);
+        _aclNodes.push_back(clRight);
+        aulTodo.push_back(ulChild);
+        aulTodo.push_back(ulChild + 1);
+    }
+
+    // store the corners in leaf order to access them sequentially
+    _aclPoints.resize(3 * ulCtFacets);
+    for (unsigned long k = 0; k < ulCtFacets; k++) {
+        unsigned long ulFacet = _aulFacets[k];
+        _aclPoints[3 * k    ] = corners[3 * ulFacet    ];
+        _aclPoints[3 * k + 1] = corners[3 * ulFacet + 1];
+        _aclPoints[3 * k + 2] = corners[3 * ulFacet + 2];
+    }
+}
+
+Base::BoundBox3f MeshFacetBVH::GetBoundBox () const
+{
+    if (_aclNodes.empty())
+        return Base::BoundBox3f();
+    return _aclNodes.front().box;
+}
+
+unsigned long MeshFacetBVH::Inside (const Base::BoundBox3f &rclBB, std::vector<unsigned long> &raulElements) const
+{
+    raulElements.clear();
+    if (_aclNodes.empty())
+        return 0;
+
+    std::vector<unsigned long> aulStack;
+    aulStack.reserve(64);
+    aulStack.push_back(0);
+    while (!aulStack.empty()) {
+        const Node& rclNode = _aclNodes[aulStack.back()];
+        aulStack.pop_back();
+        if (!(rclNode.box && rclBB))
+            continue;
+
+        if (rclNode.count > 0) {
+            for (unsigned long k = rclNode.first; k < rclNode.first + rclNode.count; k++) {
+                Base::BoundBox3f clBox(&_aclPoints[3 * k], 3);
+                if (clBox && rclBB)
+                    raulElements.push_back(_aulFacets[k]);
+            }
+        }
+        else {
+            aulStack.push_back(rclNode.first + 1);
+            aulStack.push_back(rclNode.first);
+        }
+    }
+
+    return raulElements.size();
+}
+
+float MeshFacetBVH::DistanceToBox (const Base::BoundBox3f &rclBB, const Base::Vector3f &rclPt) const
+{
+    float dx = std::max<float>(std::max<float>(rclBB.MinX - rclPt.x, 0.0f), rclPt.x - rclBB.MaxX);
+    float dy = std::max<float>(std::max<float>(rclBB.MinY - rclPt.y, 0.0f), rclPt.y - rclBB.MaxY);
+    float dz = std::max<float>(std::max<float>(rclBB.MinZ - rclPt.z, 0.0f), rclPt.z - rclBB.MaxZ);
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+bool MeshFacetBVH::SearchNearestFacet (const Base::Vector3f &rclPt, unsigned long &rulFacet, float &rfDist,
+                                       float fMaxDist) const
+{
+    if (_aclNodes.empty())
+        return false;
+
+    bool bFound = false;
+    float fBest = fMaxDist;
+
+    std::vector<unsigned long> aulStack;
+    aulStack.reserve(64);
+    aulStack.push_back(0);
+    while (!aulStack.empty()) {
+        const Node& rclNode = _aclNodes[aulStack.back()];
+        aulStack.pop_back();
+        if (DistanceToBox(rclNode.box, rclPt) >= fBest)
+            continue;
+
+        if (rclNode.count > 0) {
+            for (unsigned long k = rclNode.first; k < rclNode.first + rclNode.count; k++) {
+                MeshGeomFacet clFacet(_aclPoints[3 * k], _aclPoints[3 * k + 1], _aclPoints[3 * k + 2]);
+                float fDist = clFacet.DistanceToPoint(rclPt);
+                if (fDist < fBest) {
+                    fBest = fDist;
+                    rulFacet = _aulFacets[k];
+                    bFound = true;
+                }
+            }
+        }
+        else {
+            // visit the nearer child first
+            unsigned long ulLeft = rclNode.first;
+            unsigned long ulRight = rclNode.first + 1;
+            if (DistanceToBox(_aclNodes[ulLeft].box, rclPt) > DistanceToBox(_aclNodes[ulRight].box, rclPt))
+                std::swap(ulLeft, ulRight);
+            aulStack.push_back(ulRight);
+            aulStack.push_back(ulLeft);
+        }
+    }
+
+    if (bFound)
+        rfDist = fBest;
+    return bFound;
+}
+
+bool MeshFacetBVH::LineBoxDistance (const Base::BoundBox3f &rclBB, const Base::Vector3f &rclPt,
+                                    const Base::Vector3f &rclDir, float &rfDist) const
+{
+    float tmin = -FLT_MAX;
+    float tmax = FLT_MAX;
+    if (!ClipSlab(rclPt.x, rclDir.x, rclBB.MinX, rclBB.MaxX, tmin, tmax) ||
+        !ClipSlab(rclPt.y, rclDir.y, rclBB.MinY, rclBB.MaxY, tmin, tmax) ||
+        !ClipSlab(rclPt.z, rclDir.z, rclBB.MinZ, rclBB.MaxZ, tmin, tmax))
+        return false;
+
+    // the line is given in both directions, so the box may be behind the point
+    if (tmin > 0.0f)
+        rfDist = tmin;
+    else if (tmax < 0.0f)
+        rfDist = -tmax;
+    else
+        rfDist = 0.0f;
+    return true;
+}
+
+bool MeshFacetBVH::NearestFacetOnRay (const Base::Vector3f &rclPt, const Base::Vector3f &rclDir,
+                                      Base::Vector3f &rclRes, unsigned long &rulFacet,
+                                      bool bRay) const
+{
+    float fLength = rclDir.Length();
+    if (_aclNodes.empty() || fLength == 0.0f)
+        return false;
+
+    Base::Vector3f clUnit = rclDir / fLength;
+    bool bFound = false;
+    float fBest = FLT_MAX;
+    float fDist;
+
+    std::vector<unsigned long> aulStack;
+    aulStack.reserve(64);
+    aulStack.push_back(0);
+    while (!aulStack.empty()) {
+        const Node& rclNode = _aclNodes[aulStack.back()];
+        aulStack.pop_back();
+        if (!LineBoxDistance(rclNode.box, rclPt, clUnit, fDist) || fDist >= fBest)
+            continue;
+        if (bRay) {
+            // skip boxes completely behind the point
+            const Base::BoundBox3f& rclBB = rclNode.box;
+            float fExt = 0.5f * (std::fabs(clUnit.x) * rclBB.LengthX() +
+                                 std::fabs(clUnit.y) * rclBB.LengthY() +
+                                 std::fabs(clUnit.z) * rclBB.LengthZ());
+            if ((rclBB.GetCenter() - rclPt) * clUnit + fExt < 0.0f)
+                continue;
+        }
+
+        if (rclNode.count > 0) {
+            Base::Vector3f clRes;
+            for (unsigned long k = rclNode.first; k < rclNode.first + rclNode.count; k++) {
+                MeshGeomFacet clFacet(_aclPoints[3 * k], _aclPoints[3 * k + 1], _aclPoints[3 * k + 2]);
+                if (clFacet.Foraminate(rclPt, rclDir, clRes)) {
+                    if (bRay && (clRes - rclPt) * rclDir < 0.0f)
+                        continue;
+                    fDist = Base::Distance(rclPt, clRes);
+                    if (fDist < fBest) {
+                        fBest = fDist;
+                        rclRes = clRes;
+                        rulFacet = _aulFacets[k];
+                        bFound = true;
+                    }
+                }
+            }
+        }
+        else {
+            aulStack.push_back(rclNode.first + 1);
+            aulStack.push_back(rclNode.first);
+        }
+    }
+
+    return bFound;
+}
+
+unsigned long MeshFacetBVH::GetMemSize () const
+{
+    return static_cast<unsigned long>(_aclNodes.capacity() * sizeof(Node) +
+                                      _aulFacets.capacity() * sizeof(unsigned long) +
+                                      _aclPoints.capacity() * sizeof(Base::Vector3f));
+}
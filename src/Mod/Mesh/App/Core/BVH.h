@@ -0,0 +1,160 @@
+/***************************************************************************
+ *   Copyright (c) 2020 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef MESH_BVH_H
+#define MESH_BVH_H
+
+#include <cfloat>
+#include <vector>
+#include "Elements.h"
+
+namespace MeshCore
+{
+
+class MeshKernel;
+
+/**
+ * The MeshFacetBVH class is a bounding volume hierarchy over the facets of a mesh.
+ * Unlike MeshFacetGrid whose cells have a uniform size the hierarchy adapts to the
+ * facet density, so meshes with small details on large flat areas don't end up with
+ * a few overfull cells. The tree is built with the surface area heuristic and keeps
+ * a copy of the (optionally transformed) facet corners in leaf order.
+ *
+ * All queries are const and don't use any shared state, so they can be called from
+ * several threads at the same time.
+ */
+class MeshExport MeshFacetBVH
+{
+public:
+    /// Builds the hierarchy for the facets of \a rclMesh.
+    MeshFacetBVH (const MeshKernel &rclMesh);
+    /// Builds the hierarchy for the facets of \a rclMesh transformed by \a rclMat.
+    MeshFacetBVH (const MeshKernel &rclMesh, const Base::Matrix4D &rclMat);
+    ~MeshFacetBVH ();
+
+    /// Rebuilds the hierarchy, e.g. after the mesh has been modified.
+    void Rebuild ();
+    /// Returns the underlying mesh.
+    const MeshKernel& GetMesh () const
+    { return _rclMesh; }
+    /// Returns true if the mesh has no facets.
+    bool IsEmpty () const
+    { return _aclNodes.empty(); }
+    /// Returns the bounding box of all (transformed) facets.
+    Base::BoundBox3f GetBoundBox () const;
+
+    /**
+     * Collects the indices of all facets whose bounding box intersects \a rclBB.
+     * In contrast to MeshGrid::Inside() no facets of neighbouring cells are added
+     * and each facet is returned once. The returned number is the size of \a raulElements.
+     */
+    unsigned long Inside (const Base::BoundBox3f &rclBB, std::vector<unsigned long> &raulElements) const;
+    /**
+     * Collects the indices of all facets for whose bounding box \a pred returns true.
+     * The predicate is also called for the boxes of the tree to skip whole sub trees,
+     * so it must return true for every box that contains a box it accepts.
+     */
+    template <class Predicate>
+    unsigned long CollectFacets (Predicate pred, std::vector<unsigned long> &raulElements) const;
+    /**
+     * Searches for the facet with the shortest distance to \a rclPt. Only facets closer
+     * than \a fMaxDist are considered. If a facet was found true is returned and its index
+     * and distance are set to \a rulFacet and \a rfDist.
+     */
+    bool SearchNearestFacet (const Base::Vector3f &rclPt, unsigned long &rulFacet, float &rfDist,
+                             float fMaxDist = FLT_MAX) const;
+    /**
+     * Searches for the intersection of the line through \a rclPt with direction \a rclDir
+     * and the facets that is nearest to \a rclPt. This gives the same result as the
+     * overload of MeshAlgorithm::NearestFacetOnRay() that doesn't use a grid.
+     * If \a bRay is true only intersections in direction of \a rclDir are considered.
+     */
+    bool NearestFacetOnRay (const Base::Vector3f &rclPt, const Base::Vector3f &rclDir,
+                            Base::Vector3f &rclRes, unsigned long &rulFacet,
+                            bool bRay = false) const;
+
+    /// Returns the number of bytes used by the hierarchy.
+    unsigned long GetMemSize () const;
+
+protected:
+    struct Node {
+        Base::BoundBox3f box;
+        /// index of the first facet of a leaf, or of the left child of an inner node
+        unsigned long first;
+        /// number of facets of a leaf, 0 for inner nodes whose right child is first+1
+        unsigned long count;
+    };
+
+    float DistanceToBox (const Base::BoundBox3f &rclBB, const Base::Vector3f &rclPt) const;
+    bool LineBoxDistance (const Base::BoundBox3f &rclBB, const Base::Vector3f &rclPt,
+                          const Base::Vector3f &rclDir, float &rfDist) const;
+
+private:
+    const MeshKernel& _rclMesh;
+    Base::Matrix4D _clTransform;
+    bool _bApply;
+    std::vector<Node> _aclNodes;
+    /// facet indices in leaf order
+    std::vector<unsigned long> _aulFacets;
+    /// three corner points per entry of _aulFacets
+    std::vector<Base::Vector3f> _aclPoints;
+
+    MeshFacetBVH (const MeshFacetBVH&);
+    void operator= (const MeshFacetBVH&);
+};
+
+template <class Predicate>
+unsigned long MeshFacetBVH::CollectFacets (Predicate pred, std::vector<unsigned long> &raulElements) const
+{
+    raulElements.clear();
+    if (_aclNodes.empty())
+        return 0;
+
+    std::vector<unsigned long> aulStack;
+    aulStack.reserve(64);
+    aulStack.push_back(0);
+    while (!aulStack.empty()) {
+        const Node& rclNode = _aclNodes[aulStack.back()];
+        aulStack.pop_back();
+        if (!pred(rclNode.box))
+            continue;
+
+        if (rclNode.count > 0) {
+            for (unsigned long k = rclNode.first; k < rclNode.first + rclNode.count; k++) {
+                Base::BoundBox3f clBox(&_aclPoints[3 * k], 3);
+                if (pred(clBox))
+                    raulElements.push_back(_aulFacets[k]);
+            }
+        }
+        else {
+            aulStack.push_back(rclNode.first + 1);
+            aulStack.push_back(rclNode.first);
+        }
+    }
+
+    return raulElements.size();
+}
+
+} // namespace MeshCore
+
+#endif  // MESH_BVH_H
@@ -30,17 +30,15 @@
 #include <QtConcurrentMap>
 #include <boost_bind_bind.hpp>
 
-//#define OPTIMIZE_CURVATURE
-#ifdef OPTIMIZE_CURVATURE
-#include <Eigen/Eigenvalues>
-#else
+#include <Mod/Mesh/App/WildMagic4/Wm4Matrix2.h>
+#include <Mod/Mesh/App/WildMagic4/Wm4Matrix3.h>
+#include <Mod/Mesh/App/WildMagic4/Wm4Vector2.h>
 #include <Mod/Mesh/App/WildMagic4/Wm4Vector3.h>
-#include <Mod/Mesh/App/WildMagic4/Wm4MeshCurvature.h>
-#endif
 
 #include "Curvature.h"
 #include "Algorithm.h"
 #include "Approximation.h"
+#include "Functional.h"
 #include "MeshKernel.h"
 #include "Iterator.h"
 #include "Tools.h"
@@ -67,7 +65,7 @@ void MeshCurvature::ComputePerFace(bool parallel)
     Base::Vector3f rkDir0, rkDir1, rkPnt;
     Base::Vector3f rkNormal;
     myCurvature.clear();
-    MeshRefPointToFacets search(myKernel);
+    MeshCompactPointToFacets search(myKernel);
     FacetCurvature face(myKernel, search, myRadius, myMinPoints);
 
     if (!parallel) {
@@ -90,252 +88,173 @@ void MeshCurvature::ComputePerFace(bool parallel)
     }
 }
 
-#ifdef OPTIMIZE_CURVATURE
 namespace MeshCore {
-void GenerateComplementBasis (Eigen::Vector3f& rkU, Eigen::Vector3f& rkV,
-                              const Eigen::Vector3f& rkW)
-{
-    float fInvLength;
-
-    if (fabs(rkW[0]) >= fabs(rkW[1]))
-    {
-        // W.x or W.z is the largest magnitude component, swap them
-        fInvLength = 1.0/sqrt(rkW[0]*rkW[0] + rkW[2]*rkW[2]);
-        rkU[0] = -rkW[2]*fInvLength;
-        rkU[1] =  0.0;
-        rkU[2] = +rkW[0]*fInvLength;
-        rkV[0] = rkW[1]*rkU[2];
-        rkV[1] =  rkW[2]*rkU[0] - rkW[0]*rkU[2];
-        rkV[2] = -rkW[1]*rkU[0];
-    }
-    else
-    {
-        // W.y or W.z is the largest magnitude component, swap them
-        fInvLength = 1.0/sqrt(rkW[1]*rkW[1] + rkW[2]*rkW[2]);
-        rkU[0] =  0.0;
-        rkU[1] = +rkW[2]*fInvLength;
-        rkU[2] = -rkW[1]*fInvLength;
-        rkV[0] =  rkW[1]*rkU[2] - rkW[2]*rkU[1];
-        rkV[1] = -rkW[0]*rkU[2];
-        rkV[2] =  rkW[0]*rkU[1];
-    }
-}
-}
-
-void MeshCurvature::ComputePerVertex()
+/**
+ * Computes the principal curvatures and directions of a vertex the same way as
+ * Wm4::MeshCurvature does. The normal derivatives are accumulated only from the
+ * facets around the vertex so that no per-vertex matrices must be kept and each
+ * vertex can be handled independently of the others.
+ */
+static CurvatureInfo VertexCurvature(unsigned long index,
+                                     const std::vector<Wm4::Vector3<double> >& akVertex,
+                                     const std::vector<Wm4::Vector3<double> >& akNormal,
+                                     const MeshFacetArray& rFacets,
+                                     const MeshCompactPointToFacets& pt2f)
 {
-    // get all points
-    const MeshPointArray& pts = myKernel.GetPoints();
-
-    MeshCore::MeshRefPointToFacets pt2f(myKernel);
-    MeshCore::MeshRefPointToPoints pt2p(myKernel);
-    unsigned long numPoints = myKernel.CountPoints();
-
-    myCurvature.clear();
-    myCurvature.reserve(numPoints);
-
-    std::vector<Eigen::Vector3f> akNormal(numPoints);
-    std::vector<Eigen::Vector3f> akVertex(numPoints);
-    for (unsigned long i=0; i<numPoints; i++) {
-        Base::Vector3f n = pt2f.GetNormal(i);
-        akNormal[i][0] = n.x;
-        akNormal[i][1] = n.y;
-        akNormal[i][2] = n.z;
-        const Base::Vector3f& p = pts[i];
-        akVertex[i][0] = p.x;
-        akVertex[i][1] = p.y;
-        akVertex[i][2] = p.z;
-    }
-
-    // One could iterate over the triangles and then for each vertex of a triangle compute the derivates.
-    // One could also iterate over the points and then for each adjacent point calculate the derivates.
-    // Both methods must lead to the same values in the above matrices.
-    //
-    // Iterate over the vertexes
-    for (unsigned long i=0; i<numPoints; i++) {
-        Eigen::Matrix3f akDNormal;
-        akDNormal.setZero();
-        Eigen::Matrix3f akWWTrn;
-        akWWTrn.setZero();
-        Eigen::Matrix3f akDWTrn;
-        akDWTrn.setZero();
-
-        int iV0 = i;
-        int iV1;
-        const std::set<unsigned long>& nb = pt2p[i];
-        for (std::set<unsigned long>::const_iterator it = nb.begin(); it != nb.end(); ++it) {
-            iV1 = *it;
-
-            // Compute edge from V0 to V1, project to tangent plane of vertex,
-            // and compute difference of adjacent normals.
-            Eigen::Vector3f kE = akVertex[iV1] - akVertex[iV0];
-            Eigen::Vector3f kW = kE - (kE.dot(akNormal[iV0]))*akNormal[iV0];
-            Eigen::Vector3f kD = akNormal[iV1] - akNormal[iV0];
-            for (int iRow = 0; iRow < 3; iRow++)
-            {
-                for (int iCol = 0; iCol < 3; iCol++)
-                {
-                    akWWTrn(iRow,iCol) += 2*kW[iRow]*kW[iCol];
-                    akDWTrn(iRow,iCol) += 2*kD[iRow]*kW[iCol];
+    typedef Wm4::Vector3<double> Vector3d;
+    const Vector3d& kN = akNormal[index];
+    const Vector3d& kP = akVertex[index];
+
+    Wm4::Matrix3<double> kWWTrn, kDWTrn;
+    MeshAdjacency::Range facets = pt2f[index];
+    for (MeshAdjacency::Range::const_iterator it = facets.begin(); it != facets.end(); ++it) {
+        const MeshFacet& rFacet = rFacets[*it];
+        for (int j = 0; j < 3; j++) {
+            if (rFacet._aulPoints[j] != index)
+                continue;
+            for (int k = 1; k < 3; k++) {
+                unsigned long ulNeighbour = rFacet._aulPoints[(j+k)%3];
+
+                // Compute edge from V0 to the neighbour, project to tangent plane
+                // of vertex, and compute difference of adjacent normals.
+                Vector3d kE = akVertex[ulNeighbour] - kP;
+                Vector3d kW = kE - (kE.Dot(kN))*kN;
+                Vector3d kD = akNormal[ulNeighbour] - kN;
+                for (int iRow = 0; iRow < 3; iRow++) {
+                    for (int iCol = 0; iCol < 3; iCol++) {
+                        kWWTrn[iRow][iCol] += kW[iRow]*kW[iCol];
+                        kDWTrn[iRow][iCol] += kD[iRow]*kW[iCol];
+                    }
                 }
             }
         }
+    }
 
-        // Add in N*N^T to W*W^T for numerical stability.  In theory 0*0^T gets
-        // added to D*W^T, but of course no update needed in the implementation.
-        // Compute the matrix of normal derivatives.
-        for (int iRow = 0; iRow < 3; iRow++)
-        {
-            for (int iCol = 0; iCol < 3; iCol++)
-            {
-                akWWTrn(iRow,iCol) = 0.5*akWWTrn(iRow,iCol) + akNormal[i][iRow]*akNormal[i][iCol];
-                akDWTrn(iRow,iCol) *= 0.5;
-            }
-        }
-
-        akDNormal = akDWTrn*akWWTrn.inverse();
-
-        // If N is a unit-length normal at a vertex, let U and V be unit-length
-        // tangents so that {U, V, N} is an orthonormal set.  Define the matrix
-        // J = [U | V], a 3-by-2 matrix whose columns are U and V.  Define J^T
-        // to be the transpose of J, a 2-by-3 matrix.  Let dN/dX denote the
-        // matrix of first-order derivatives of the normal vector field.  The
-        // shape matrix is
-        //   S = (J^T * J)^{-1} * J^T * dN/dX * J = J^T * dN/dX * J
-        // where the superscript of -1 denotes the inverse.  (The formula allows
-        // for J built from non-perpendicular vectors.) The matrix S is 2-by-2.
-        // The principal curvatures are the eigenvalues of S.  If k is a principal
-        // curvature and W is the 2-by-1 eigenvector corresponding to it, then
-        // S*W = k*W (by definition).  The corresponding 3-by-1 tangent vector at
-        // the vertex is called the principal direction for k, and is J*W.
-        // compute U and V given N
-        float minCurvature;
-        float maxCurvature;
-        Base::Vector3f minDirection;
-        Base::Vector3f maxDirection;
-
-        Eigen::Vector3f kU, kV;
-        Eigen::Vector3f kN = akNormal[i];
-        float len = kN.squaredNorm();
-        if (len == 0)
-            continue; // skip
-        MeshCore::GenerateComplementBasis(kU,kV,kN);
-
-        // Compute S = J^T * dN/dX * J.  In theory S is symmetric, but
-        // because we have estimated dN/dX, we must slightly adjust our
-        // calculations to make sure S is symmetric.
-        float fS01 = kU.dot(akDNormal*kV);
-        float fS10 = kV.dot(akDNormal*kU);
-        float fSAvr = 0.5*(fS01+fS10);
-        Eigen::Matrix2f kS;
-        kS(0,0) = kU.dot(akDNormal*kU);
-        kS(0,1) = fSAvr;
-        kS(1,0) = fSAvr;
-        kS(1,1) = kV.dot(akDNormal*kV);
-
-        // compute the eigenvalues of S (min and max curvatures)
-        float fTrace = kS(0,0) + kS(1,1);
-        float fDet = kS(0,0)*kS(1,1) - kS(0,1)*kS(1,0);
-        float fDiscr = fTrace*fTrace - (4.0)*fDet;
-        float fRootDiscr = sqrt(fabs(fDiscr));
-        minCurvature = (0.5)*(fTrace - fRootDiscr);
-        maxCurvature = (0.5)*(fTrace + fRootDiscr);
-
-        // compute the eigenvectors of S
-        Eigen::Vector2f kW0(kS(0,1),minCurvature-kS(0,0));
-        Eigen::Vector2f kW1(minCurvature-kS(1,1),kS(1,0));
-        if (kW0.squaredNorm() >= kW1.squaredNorm())
-        {
-            float len = kW0.squaredNorm();
-            if (len > 0 && len != 1)
-                kW0.normalize();
-            Eigen::Vector3f v = kU*kW0[0] + kV*kW0[1];
-            minDirection.Set(v[0],v[1],v[2]);
-        }
-        else
-        {
-            float len = kW1.squaredNorm();
-            if (len > 0 && len != 1)
-                kW1.normalize();
-            Eigen::Vector3f v = kU*kW1[0] + kV*kW1[1];
-            minDirection.Set(v[0],v[1],v[2]);
+    // Add in N*N^T to W*W^T for numerical stability and compute the matrix
+    // of normal derivatives.
+    for (int iRow = 0; iRow < 3; iRow++) {
+        for (int iCol = 0; iCol < 3; iCol++) {
+            kWWTrn[iRow][iCol] = 0.5*kWWTrn[iRow][iCol] + kN[iRow]*kN[iCol];
+            kDWTrn[iRow][iCol] *= 0.5;
         }
+    }
 
-        kW0 = Eigen::Vector2f(kS(0,1),maxCurvature-kS(0,0));
-        kW1 = Eigen::Vector2f(maxCurvature-kS(1,1),kS(1,0));
-        if (kW0.squaredNorm() >= kW1.squaredNorm())
-        {
-            float len = kW0.squaredNorm();
-            if (len > 0 && len != 1)
-                kW0.normalize();
-            Eigen::Vector3f v = kU*kW0[0] + kV*kW0[1];
-            maxDirection.Set(v[0],v[1],v[2]);
-        }
-        else
-        {
-            float len = kW1.squaredNorm();
-            if (len > 0 && len != 1)
-                kW1.normalize();
-            Eigen::Vector3f v = kU*kW1[0] + kV*kW1[1];
-            maxDirection.Set(v[0],v[1],v[2]);
-        }
+    Wm4::Matrix3<double> kDNormal = kDWTrn*kWWTrn.Inverse();
+
+    // Compute S = J^T * dN/dX * J with J = [U | V] where {U, V, N} is an
+    // orthonormal set. The principal curvatures are the eigenvalues of S and
+    // J*W with an eigenvector W of S is the corresponding principal direction.
+    Vector3d kU, kV;
+    Vector3d::GenerateComplementBasis(kU,kV,kN);
+
+    double fS01 = kU.Dot(kDNormal*kV);
+    double fS10 = kV.Dot(kDNormal*kU);
+    double fSAvr = 0.5*(fS01+fS10);
+    Wm4::Matrix2<double> kS
+    (
+        kU.Dot(kDNormal*kU), fSAvr,
+        fSAvr, kV.Dot(kDNormal*kV)
+    );
+
+    // compute the eigenvalues of S (min and max curvatures)
+    double fTrace = kS[0][0] + kS[1][1];
+    double fDet = kS[0][0]*kS[1][1] - kS[0][1]*kS[1][0];
+    double fDiscr = fTrace*fTrace - 4.0*fDet;
+    double fRootDiscr = Wm4::Math<double>::Sqrt(Wm4::Math<double>::FAbs(fDiscr));
+    double fMinCurvature = 0.5*(fTrace - fRootDiscr);
+    double fMaxCurvature = 0.5*(fTrace + fRootDiscr);
+
+    // compute the eigenvectors of S
+    Vector3d kMinDirection, kMaxDirection;
+    Wm4::Vector2<double> kW0(kS[0][1],fMinCurvature-kS[0][0]);
+    Wm4::Vector2<double> kW1(fMinCurvature-kS[1][1],kS[1][0]);
+    if (kW0.SquaredLength() >= kW1.SquaredLength()) {
+        kW0.Normalize();
+        kMinDirection = kW0.X()*kU + kW0.Y()*kV;
+    }
+    else {
+        kW1.Normalize();
+        kMinDirection = kW1.X()*kU + kW1.Y()*kV;
+    }
 
-        CurvatureInfo ci;
-        ci.fMaxCurvature = maxCurvature;
-        ci.cMaxCurvDir = maxDirection;
-        ci.fMinCurvature = minCurvature;
-        ci.cMinCurvDir = minDirection;
-        myCurvature.push_back(ci);
+    kW0 = Wm4::Vector2<double>(kS[0][1],fMaxCurvature-kS[0][0]);
+    kW1 = Wm4::Vector2<double>(fMaxCurvature-kS[1][1],kS[1][0]);
+    if (kW0.SquaredLength() >= kW1.SquaredLength()) {
+        kW0.Normalize();
+        kMaxDirection = kW0.X()*kU + kW0.Y()*kV;
+    }
+    else {
+        kW1.Normalize();
+        kMaxDirection = kW1.X()*kU + kW1.Y()*kV;
     }
+
+    CurvatureInfo ci;
+    ci.cMaxCurvDir = Base::Vector3f((float)kMaxDirection.X(), (float)kMaxDirection.Y(), (float)kMaxDirection.Z());
+    ci.cMinCurvDir = Base::Vector3f((float)kMinDirection.X(), (float)kMinDirection.Y(), (float)kMinDirection.Z());
+    ci.fMaxCurvature = (float)fMaxCurvature;
+    ci.fMinCurvature = (float)fMinCurvature;
+    return ci;
+}
 }
-#else
+
 void MeshCurvature::ComputePerVertex()
 {
-    myCurvature.clear();
-
-    // get all points
-    std::vector< Wm4::Vector3<double> > aPnts;
-    aPnts.reserve(myKernel.CountPoints());
-    MeshPointIterator cPIt(myKernel);
-    for (cPIt.Init(); cPIt.More(); cPIt.Next()) {
-        Wm4::Vector3<double> cP(cPIt->x, cPIt->y, cPIt->z);
-        aPnts.push_back(cP);
-    }
+    std::vector<unsigned long> points(myKernel.CountPoints());
+    std::generate(points.begin(), points.end(), Base::iotaGen<unsigned long>(0));
+    ComputePerVertex(points);
+}
 
-    // get all point connections
-    std::vector<int> aIdx;
-    aIdx.reserve(3*myKernel.CountFacets());
-    const MeshFacetArray& raFts = myKernel.GetFacets();
-    for (MeshFacetArray::const_iterator jt = raFts.begin(); jt != raFts.end(); ++jt) {
-        for (int i=0; i<3; i++) {
-            aIdx.push_back((int)jt->_aulPoints[i]);
-        }
-    }
+void MeshCurvature::ComputePerVertex(const std::vector<unsigned long>& points)
+{
+    myCurvature.clear();
 
     // in case of an empty mesh no curvature can be calculated
     if (myKernel.CountPoints() == 0 || myKernel.CountFacets() == 0)
         return;
 
-    // compute vertex based curvatures
-    Wm4::MeshCurvature<double> meshCurv(myKernel.CountPoints(), &(aPnts[0]), myKernel.CountFacets(), &(aIdx[0]));
-
-    // get curvature information now
-    const Wm4::Vector3<double>* aMaxCurvDir = meshCurv.GetMaxDirections();
-    const Wm4::Vector3<double>* aMinCurvDir = meshCurv.GetMinDirections();
-    const double* aMaxCurv = meshCurv.GetMaxCurvatures();
-    const double* aMinCurv = meshCurv.GetMinCurvatures();
-
-    myCurvature.reserve(myKernel.CountPoints());
-    for (unsigned long i=0; i<myKernel.CountPoints(); i++) {
-        CurvatureInfo ci;
-        ci.cMaxCurvDir = Base::Vector3f((float)aMaxCurvDir[i].X(), (float)aMaxCurvDir[i].Y(), (float)aMaxCurvDir[i].Z());
-        ci.cMinCurvDir = Base::Vector3f((float)aMinCurvDir[i].X(), (float)aMinCurvDir[i].Y(), (float)aMinCurvDir[i].Z());
-        ci.fMaxCurvature = (float)aMaxCurv[i];
-        ci.fMinCurvature = (float)aMinCurv[i];
-        myCurvature.push_back(ci);
-    }
+    typedef Wm4::Vector3<double> Vector3d;
+    const MeshPointArray& rPoints = myKernel.GetPoints();
+    const MeshFacetArray& rFacets = myKernel.GetFacets();
+    MeshCompactPointToFacets pt2f(myKernel);
+
+    // get all points
+    std::vector<Vector3d> akVertex(rPoints.size());
+    parallel_blocks(rPoints.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++)
+            akVertex[i] = Vector3d(rPoints[i].x, rPoints[i].y, rPoints[i].z);
+    });
+
+    // compute the facet normals whose length provides a weighted sum
+    std::vector<Vector3d> akFacetNormal(rFacets.size());
+    parallel_blocks(rFacets.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            const MeshFacet& rFacet = rFacets[i];
+            Vector3d kEdge1 = akVertex[rFacet._aulPoints[1]] - akVertex[rFacet._aulPoints[0]];
+            Vector3d kEdge2 = akVertex[rFacet._aulPoints[2]] - akVertex[rFacet._aulPoints[0]];
+            akFacetNormal[i] = kEdge1.Cross(kEdge2);
+        }
+    });
+
+    // compute the vertex normals
+    std::vector<Vector3d> akNormal(rPoints.size());
+    parallel_blocks(rPoints.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            Vector3d kNormal(0.0, 0.0, 0.0);
+            MeshAdjacency::Range facets = pt2f[i];
+            for (MeshAdjacency::Range::const_iterator it = facets.begin(); it != facets.end(); ++it)
+                kNormal += akFacetNormal[*it];
+            kNormal.Normalize();
+            akNormal[i] = kNormal;
+        }
+    });
+
+    // compute vertex based curvatures in blocks of neighbouring vertices
+    myCurvature.resize(points.size());
+    parallel_blocks(points.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++)
+            myCurvature[i] = VertexCurvature(points[i], akVertex, akNormal, rFacets, pt2f);
+    }, 256);
 }
-#endif // OPTIMIZE_CURVATURE
 
 // --------------------------------------------------------
 
@@ -360,7 +279,7 @@ private:
 
 // --------------------------------------------------------
 
-FacetCurvature::FacetCurvature(const MeshKernel& kernel, const MeshRefPointToFacets& search, float r, unsigned long pt)
+FacetCurvature::FacetCurvature(const MeshKernel& kernel, const MeshCompactPointToFacets& search, float r, unsigned long pt)
   : myKernel(kernel), mySearch(search), myMinPoints(pt), myRadius(r)
 {
 }
@@ -29,7 +29,7 @@
 namespace MeshCore {
 
 class MeshKernel;
-class MeshRefPointToFacets;
+class MeshCompactPointToFacets;
 
 /** Curvature information. */
 struct MeshExport CurvatureInfo
@@ -41,12 +41,12 @@ struct MeshExport CurvatureInfo
 class MeshExport FacetCurvature
 {
 public:
-    FacetCurvature(const MeshKernel& kernel, const MeshRefPointToFacets& search, float, unsigned long);
+    FacetCurvature(const MeshKernel& kernel, const MeshCompactPointToFacets& search, float, unsigned long);
     CurvatureInfo Compute(unsigned long index) const;
 
 private:
     const MeshKernel& myKernel;
-    const MeshRefPointToFacets& mySearch;
+    const MeshCompactPointToFacets& mySearch;
     unsigned long myMinPoints;
     float myRadius;
 };
@@ -59,7 +59,12 @@ public:
     float GetRadius() const { return myRadius; }
     void SetRadius(float r) { myRadius = r; }
     void ComputePerFace(bool parallel);
+    /** Computes the principal curvatures and directions of all vertices. */
     void ComputePerVertex();
+    /** Computes the principal curvatures and directions of the given vertices only.
+     * The computed curvature information has the same order as \a points.
+     */
+    void ComputePerVertex(const std::vector<unsigned long>& points);
     const std::vector<CurvatureInfo>& GetCurvature() const { return myCurvature; }
 
 private:
@@ -23,6 +23,7 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <algorithm>
 #endif
 
 #include "Decimation.h"
@@ -30,117 +31,272 @@
 #include "Algorithm.h"
 #include "Iterator.h"
 #include "TopoAlgorithm.h"
+#include "Functional.h"
 #include <Base/Tools.h>
 #include "Simplify.h"
 
 
 using namespace MeshCore;
 
-MeshSimplify::MeshSimplify(MeshKernel& mesh)
-  : myKernel(mesh)
-{
-}
+namespace {
+// Below this number of facets per partition the overhead of splitting and
+// merging is higher than the gain of running the partitions concurrently.
+const std::size_t MinFacetsPerPartition = 100000;
+// Splitting, merging and the final pass run serially and take about 27% of the
+// serial decimation time, and the partitions together take about 115% of it.
+// So n partitions need roughly 0.27 + 1.15/n of the serial time, which only
+// pays off for the extra memory from four partitions on (0.56).
+const std::size_t MinPartitions = 4;
 
-MeshSimplify::~MeshSimplify()
+void fillSimplify(Simplify& alg, const MeshPointArray& points, const MeshFacetArray& facets)
 {
-}
-
-void MeshSimplify::simplify(float tolerance, float reduction)
-{
-    Simplify alg;
-
-    const MeshPointArray& points = myKernel.GetPoints();
+    alg.vertices.resize(points.size());
     for (std::size_t i = 0; i < points.size(); i++) {
-        Simplify::Vertex v;
+        Simplify::Vertex& v = alg.vertices[i];
         v.p = points[i];
-        alg.vertices.push_back(v);
+        v.locked = 0;
     }
 
-    const MeshFacetArray& facets = myKernel.GetFacets();
+    alg.triangles.resize(facets.size());
     for (std::size_t i = 0; i < facets.size(); i++) {
-        Simplify::Triangle t;
+        Simplify::Triangle& t = alg.triangles[i];
         for (int j = 0; j < 3; j++)
             t.v[j] = facets[i]._aulPoints[j];
-        alg.triangles.push_back(t);
     }
+}
 
-    int target_count = static_cast<int>(static_cast<float>(facets.size()) * (1.0f-reduction));
-
-    // Simplification starts
-    alg.simplify_mesh(target_count, tolerance);
-
-    // Simplification done
+void adoptSimplify(Simplify& alg, MeshKernel& kernel)
+{
     MeshPointArray new_points;
     new_points.reserve(alg.vertices.size());
     for (std::size_t i = 0; i < alg.vertices.size(); i++) {
         new_points.push_back(alg.vertices[i].p);
     }
 
-    std::size_t numFacets = 0;
-    for (std::size_t i = 0; i < alg.triangles.size(); i++) {
-        if (!alg.triangles[i].deleted)
-            numFacets++;
-    }
+    // simplify_mesh() has already removed the deleted triangles
     MeshFacetArray new_facets;
-    new_facets.reserve(numFacets);
+    new_facets.reserve(alg.triangles.size());
     for (std::size_t i = 0; i < alg.triangles.size(); i++) {
-        if (!alg.triangles[i].deleted) {
-            MeshFacet face;
-            face._aulPoints[0] = alg.triangles[i].v[0];
-            face._aulPoints[1] = alg.triangles[i].v[1];
-            face._aulPoints[2] = alg.triangles[i].v[2];
-            new_facets.push_back(face);
-        }
+        MeshFacet face;
+        face._aulPoints[0] = alg.triangles[i].v[0];
+        face._aulPoints[1] = alg.triangles[i].v[1];
+        face._aulPoints[2] = alg.triangles[i].v[2];
+        new_facets.push_back(face);
     }
 
-    myKernel.Adopt(new_points, new_facets, true);
+    alg.vertices.clear();
+    alg.triangles.clear();
+    alg.refs.clear();
+    kernel.Adopt(new_points, new_facets, true);
 }
 
-void MeshSimplify::simplify(int targetSize)
+struct Partition
 {
+    std::vector<unsigned long> facets;
+    int target;
     Simplify alg;
+};
+}
 
-    const MeshPointArray& points = myKernel.GetPoints();
-    for (std::size_t i = 0; i < points.size(); i++) {
-        Simplify::Vertex v;
-        v.p = points[i];
-        alg.vertices.push_back(v);
+MeshSimplify::MeshSimplify(MeshKernel& mesh)
+  : myKernel(mesh)
+  , myPartitions(0)
+{
+}
+
+MeshSimplify::~MeshSimplify()
+{
+}
+
+void MeshSimplify::simplify(float tolerance, float reduction)
+{
+    std::size_t numFacets = myKernel.CountFacets();
+    int target_count = static_cast<int>(static_cast<float>(numFacets) * (1.0f-reduction));
+    simplifyMesh(target_count, tolerance);
+}
+
+void MeshSimplify::simplify(int targetSize)
+{
+    simplifyMesh(targetSize, FLT_MAX);
+}
+
+void MeshSimplify::simplifyMesh(int targetSize, double tolerance)
+{
+    std::size_t numFacets = myKernel.CountFacets();
+    std::size_t numParts = myPartitions;
+    if (numParts == 0) {
+        numParts = std::min<std::size_t>(std::max(1, QThread::idealThreadCount()),
+                                         numFacets / MinFacetsPerPartition);
+        if (numParts < MinPartitions)
+            numParts = 1;
+    }
+    if (numParts > 1 && static_cast<std::size_t>(targetSize) < numFacets) {
+        simplifyPartitioned(targetSize, tolerance, numParts);
     }
+    else {
+        Simplify alg;
+        fillSimplify(alg, myKernel.GetPoints(), myKernel.GetFacets());
+        alg.simplify_mesh(targetSize, tolerance);
+        adoptSimplify(alg, myKernel);
+    }
+}
 
+void MeshSimplify::simplifyPartitioned(int targetSize, double tolerance, std::size_t numParts)
+{
+    const MeshPointArray& points = myKernel.GetPoints();
     const MeshFacetArray& facets = myKernel.GetFacets();
-    for (std::size_t i = 0; i < facets.size(); i++) {
-        Simplify::Triangle t;
-        for (int j = 0; j < 3; j++)
-            t.v[j] = facets[i]._aulPoints[j];
-        alg.triangles.push_back(t);
+    std::size_t numFacets = facets.size();
+
+    // Split the facets into slabs of equal size along the longest side of the bounding box
+    const Base::BoundBox3f& bbox = myKernel.GetBoundBox();
+    unsigned short axis = 0;
+    if (bbox.LengthY() > bbox.LengthX() && bbox.LengthY() >= bbox.LengthZ())
+        axis = 1;
+    else if (bbox.LengthZ() > bbox.LengthX() && bbox.LengthZ() > bbox.LengthY())
+        axis = 2;
+
+    auto center = [&](std::size_t i) {
+        const unsigned long* p = facets[i]._aulPoints;
+        return (points[p[0]][axis] + points[p[1]][axis] + points[p[2]][axis]) / 3.0f;
+    };
+
+    std::vector<float> splits;
+    {
+        std::vector<float> sorted(numFacets);
+        for (std::size_t i = 0; i < numFacets; i++)
+            sorted[i] = center(i);
+        std::vector<float>::iterator first = sorted.begin();
+        for (std::size_t k = 1; k < numParts; k++) {
+            std::vector<float>::iterator nth = sorted.begin() + k * numFacets / numParts;
+            std::nth_element(first, nth, sorted.end());
+            splits.push_back(*nth);
+            first = nth;
+        }
     }
 
-    // Simplification starts
-    alg.simplify_mesh(targetSize, FLT_MAX);
+    // A point is owned by a partition if all its facets are in there, otherwise it
+    // lies on a seam between partitions. Seam points get the values -2, -3, ... which
+    // encode their index in the merged mesh.
+    std::vector<Partition> parts(numParts);
+    std::vector<int> owner(points.size(), -1);
+    for (std::size_t i = 0; i < numFacets; i++) {
+        int part = static_cast<int>(std::upper_bound(splits.begin(), splits.end(), center(i)) - splits.begin());
+        parts[part].facets.push_back(i);
+        for (int j = 0; j < 3; j++) {
+            int& o = owner[facets[i]._aulPoints[j]];
+            if (o == -1)
+                o = part;
+            else if (o != part)
+                o = -2;
+        }
+    }
 
-    // Simplification done
-    MeshPointArray new_points;
-    new_points.reserve(alg.vertices.size());
-    for (std::size_t i = 0; i < alg.vertices.size(); i++) {
-        new_points.push_back(alg.vertices[i].p);
+    std::vector<unsigned long> seam;
+    for (std::size_t i = 0; i < owner.size(); i++) {
+        if (owner[i] == -2) {
+            owner[i] = -2 - static_cast<int>(seam.size());
+            seam.push_back(i);
+        }
     }
 
-    std::size_t numFacets = 0;
-    for (std::size_t i = 0; i < alg.triangles.size(); i++) {
-        if (!alg.triangles[i].deleted)
-            numFacets++;
+    // Facets touching the seam can hardly be reduced inside a partition. Forcing the
+    // partition to its share of the target anyway makes the decimator raise its error
+    // threshold until it collapses everything else. So, leave a band of twice the seam
+    // facets to the final pass which handles them with their full neighbourhood.
+    for (std::size_t k = 0; k < numParts; k++) {
+        const std::vector<unsigned long>& ids = parts[k].facets;
+        std::size_t band = 0;
+        for (std::vector<unsigned long>::const_iterator it = ids.begin(); it != ids.end(); ++it) {
+            const unsigned long* p = facets[*it]._aulPoints;
+            if (owner[p[0]] <= -2 || owner[p[1]] <= -2 || owner[p[2]] <= -2)
+                band++;
+        }
+
+        double ratio = static_cast<double>(ids.size()) / static_cast<double>(numFacets);
+        parts[k].target = static_cast<int>(ratio * targetSize) + static_cast<int>(2 * band);
     }
-    MeshFacetArray new_facets;
-    new_facets.reserve(numFacets);
-    for (std::size_t i = 0; i < alg.triangles.size(); i++) {
-        if (!alg.triangles[i].deleted) {
-            MeshFacet face;
-            face._aulPoints[0] = alg.triangles[i].v[0];
-            face._aulPoints[1] = alg.triangles[i].v[1];
-            face._aulPoints[2] = alg.triangles[i].v[2];
-            new_facets.push_back(face);
+
+    // Decimate the partitions concurrently. The seam points are locked so that each
+    // partition can be handled independently of its neighbours.
+    parallel_blocks(numParts, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t k = begin; k < end; k++) {
+            Partition& part = parts[k];
+            std::vector<unsigned long> verts;
+            verts.reserve(3 * part.facets.size());
+            for (std::vector<unsigned long>::const_iterator it = part.facets.begin(); it != part.facets.end(); ++it)
+                verts.insert(verts.end(), facets[*it]._aulPoints, facets[*it]._aulPoints + 3);
+            std::sort(verts.begin(), verts.end());
+            verts.erase(std::unique(verts.begin(), verts.end()), verts.end());
+
+            part.alg.vertices.resize(verts.size());
+            for (std::size_t i = 0; i < verts.size(); i++) {
+                Simplify::Vertex& v = part.alg.vertices[i];
+                v.p = points[verts[i]];
+                int o = owner[verts[i]];
+                v.locked = o <= -2 ? -1 - o : 0;
+            }
+
+            part.alg.triangles.resize(part.facets.size());
+            for (std::size_t i = 0; i < part.facets.size(); i++) {
+                const MeshFacet& face = facets[part.facets[i]];
+                for (int j = 0; j < 3; j++) {
+                    part.alg.triangles[i].v[j] = static_cast<int>(std::lower_bound(verts.begin(), verts.end(),
+                        face._aulPoints[j]) - verts.begin());
+                }
+            }
+
+            std::vector<unsigned long>().swap(part.facets);
+            part.alg.simplify_mesh(part.target, tolerance);
         }
+    }, 1);
+
+    // Merge the partitions straight into the decimator of the final pass. Seam
+    // points come first and are shared, the remaining points are appended
+    // partition by partition.
+    std::size_t numPoints = seam.size();
+    std::size_t numTriangles = 0;
+    for (std::size_t k = 0; k < numParts; k++) {
+        numPoints += parts[k].alg.vertices.size();
+        numTriangles += parts[k].alg.triangles.size();
+    }
+    owner.clear();
+    owner.shrink_to_fit();
+
+    Simplify alg;
+    alg.vertices.reserve(numPoints);
+    alg.vertices.resize(seam.size());
+    for (std::size_t i = 0; i < seam.size(); i++) {
+        Simplify::Vertex& v = alg.vertices[i];
+        v.p = points[seam[i]];
+        v.locked = 0;
+    }
+
+    alg.triangles.reserve(numTriangles);
+    for (std::size_t k = 0; k < numParts; k++) {
+        Simplify& part = parts[k].alg;
+        std::vector<int> index(part.vertices.size());
+        for (std::size_t i = 0; i < part.vertices.size(); i++) {
+            Simplify::Vertex& v = part.vertices[i];
+            if (v.locked) {
+                index[i] = v.locked - 1;
+            }
+            else {
+                index[i] = static_cast<int>(alg.vertices.size());
+                alg.vertices.push_back(v);
+            }
+        }
+
+        for (std::size_t i = 0; i < part.triangles.size(); i++) {
+            Simplify::Triangle t = part.triangles[i];
+            for (int j = 0; j < 3; j++)
+                t.v[j] = index[t.v[j]];
+            alg.triangles.push_back(t);
+        }
+
+        part = Simplify();
     }
 
-    myKernel.Adopt(new_points, new_facets, true);
+    // Finish the seams with a final pass over the already reduced mesh.
+    alg.simplify_mesh(targetSize, tolerance);
+    adoptSimplify(alg, myKernel);
 }
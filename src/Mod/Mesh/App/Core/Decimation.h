@@ -24,6 +24,7 @@
 #ifndef MESH_DECIMATION_H
 #define MESH_DECIMATION_H
 
+#include <cstddef>
 
 namespace MeshCore
 {
@@ -36,9 +37,20 @@ public:
     ~MeshSimplify();
     void simplify(float tolerance, float reduction);
     void simplify(int targetSize);
+    /// Number of partitions that are decimated in parallel, 0 chooses it
+    /// from the mesh size and the number of threads
+    void setPartitions(std::size_t numParts) {
+        myPartitions = numParts;
+    }
+
+private:
+    void simplifyMesh(int targetSize, double tolerance);
+    /// Decimates spatial partitions of the mesh in parallel and joins them
+    void simplifyPartitioned(int targetSize, double tolerance, std::size_t numParts);
 
 private:
     MeshKernel& myKernel;
+    std::size_t myPartitions;
 };
 
 } // namespace MeshCore
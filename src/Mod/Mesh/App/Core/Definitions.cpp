@@ -39,6 +39,7 @@ float  MeshDefinitions::_fMinPointDistanceD1  =  _fMinPointDistance;
 float  MeshDefinitions::_fMinEdgeLength       =  MESH_MIN_EDGE_LEN;
 bool   MeshDefinitions::_bRemoveMinLength     =  MESH_REMOVE_MIN_LEN;
 float  MeshDefinitions::_fMinEdgeAngle        =  Base::toRadians<float>(MESH_MIN_EDGE_ANGLE);
+bool   MeshDefinitions::_bUseFacetBVH         =  false;
 
 MeshDefinitions::MeshDefinitions (void)
 {
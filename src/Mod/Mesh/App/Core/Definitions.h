@@ -80,6 +80,9 @@ public:
 
   static float _fMinEdgeAngle;
 
+  /// Use MeshFacetBVH instead of MeshFacetGrid where both are supported
+  static bool  _bUseFacetBVH;
+
   static void  SetMinPointDistance (float fMin);
 };
 
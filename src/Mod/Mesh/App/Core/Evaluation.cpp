@@ -35,6 +35,7 @@
 #include "Iterator.h"
 #include "Algorithm.h"
 #include "Approximation.h"
+#include "BVH.h"
 #include "MeshIO.h"
 #include "Helpers.h"
 #include "Grid.h"
@@ -590,8 +591,62 @@ bool MeshFixSingleFacet::Fixup ()
 
 // ----------------------------------------------------------------
 
+namespace MeshCore {
+/**
+ * Searches for pairs of intersecting facets with the help of a bounding volume
+ * hierarchy. Each pair is tested once and the lower facet index comes first.
+ * If \a bStopOnFirst is true the search ends after the first found pair.
+ */
+static void SearchSelfIntersections(const MeshKernel& rclMesh, bool bStopOnFirst,
+                                    std::vector<std::pair<unsigned long, unsigned long> >& intersection)
+{
+    MeshFacetBVH clBVH(rclMesh);
+    const MeshFacetArray& rFaces = rclMesh.GetFacets();
+    unsigned long ulCtFacets = rFaces.size();
+
+    std::vector<unsigned long> aulCandidates;
+    Base::Vector3f pt1, pt2;
+    Base::SequencerLauncher seq("Checking for self-intersections...", ulCtFacets);
+    for (unsigned long i = 0; i < ulCtFacets; i++) {
+        seq.next(!bStopOnFirst);
+
+        MeshGeomFacet facet1 = rclMesh.GetFacet(i);
+        clBVH.Inside(facet1.GetBoundBox(), aulCandidates);
+
+        const MeshFacet& rface1 = rFaces[i];
+        for (std::vector<unsigned long>::iterator jt = aulCandidates.begin(); jt != aulCandidates.end(); ++jt) {
+            if (*jt <= i)
+                continue;
+            // ignore facets sharing a common vertex, see MeshEvalSelfIntersection::Evaluate()
+            const MeshFacet& rface2 = rFaces[*jt];
+            bool bShared = false;
+            for (int k = 0; k < 3 && !bShared; k++) {
+                bShared = rface1._aulPoints[k] == rface2._aulPoints[0] ||
+                          rface1._aulPoints[k] == rface2._aulPoints[1] ||
+                          rface1._aulPoints[k] == rface2._aulPoints[2];
+            }
+            if (bShared)
+                continue;
+
+            MeshGeomFacet facet2 = rclMesh.GetFacet(*jt);
+            if (facet1.IntersectWithFacet(facet2, pt1, pt2) == 2) {
+                intersection.emplace_back(i, *jt);
+                if (bStopOnFirst)
+                    return;
+            }
+        }
+    }
+}
+}
+
 bool MeshEvalSelfIntersection::Evaluate ()
 {
+    if (MeshDefinitions::_bUseFacetBVH) {
+        std::vector<std::pair<unsigned long, unsigned long> > intersection;
+        SearchSelfIntersections(_rclMesh, true, intersection);
+        return intersection.empty();
+    }
+
     // Contains bounding boxes for every facet 
     std::vector<Base::BoundBox3f> boxes;
 
@@ -688,6 +743,11 @@ void MeshEvalSelfIntersection::GetIntersections(const std::vector<std::pair<unsi
 
 void MeshEvalSelfIntersection::GetIntersections(std::vector<std::pair<unsigned long, unsigned long> >& intersection) const
 {
+    if (MeshDefinitions::_bUseFacetBVH) {
+        SearchSelfIntersections(_rclMesh, false, intersection);
+        return;
+    }
+
     // Contains bounding boxes for every facet 
     std::vector<Base::BoundBox3f> boxes;
     //intersection.clear();
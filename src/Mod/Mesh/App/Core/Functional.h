@@ -25,6 +25,9 @@
 #define MESH_FUNCTIONAL_H
 
 #include <algorithm>
+#include <utility>
+#include <vector>
+#include <QtConcurrentMap>
 #include <QtConcurrentRun>
 #include <QFuture>
 #include <QThread>
@@ -58,6 +61,30 @@ namespace MeshCore
         }
     }
 
+    /**
+     * Splits the range [0, count) into blocks of at least \a minBlock elements and
+     * calls \a func(begin, end) for each block on the global thread pool. Blocks are
+     * a few times more than threads so that uneven work per element is balanced.
+     */
+    template <class Func>
+    static void parallel_blocks(std::size_t count, Func func, std::size_t minBlock = 1024)
+    {
+        std::size_t numBlocks = static_cast<std::size_t>(std::max(1, QThread::idealThreadCount())) * 4;
+        std::size_t blockSize = std::max<std::size_t>(minBlock, (count + numBlocks - 1) / numBlocks);
+        if (count <= blockSize) {
+            if (count > 0)
+                func(std::size_t(0), count);
+            return;
+        }
+
+        std::vector<std::pair<std::size_t, std::size_t> > blocks;
+        for (std::size_t i = 0; i < count; i += blockSize)
+            blocks.push_back(std::make_pair(i, std::min(count, i + blockSize)));
+        QtConcurrent::blockingMap(blocks, [&func](const std::pair<std::size_t, std::size_t>& block) {
+            func(block.first, block.second);
+        });
+    }
+
 } // namespace MeshCore
 
 
@@ -24,6 +24,7 @@
 #include "PreCompiled.h"
 #ifndef _PreComp_
 # include <algorithm>
+# include <cmath>
 # include <map>
 #endif
 
@@ -32,6 +33,7 @@
 #include "Iterator.h"
 #include "Algorithm.h"
 #include "Grid.h"
+#include "BVH.h"
 
 #include <Base/Exception.h>
 #include <Base/Console.h>
@@ -144,12 +146,6 @@ bool MeshProjection::projectLineOnMesh(const MeshFacetGrid& grid,
                                        const Base::Vector3f& vd,
                                        std::vector<Base::Vector3f>& polyline)
 {
-    Base::Vector3f dir(v2 - v1);
-    Base::Vector3f base(v1), normal(vd % dir);
-    normal.Normalize();
-    dir.Normalize();
-
-
     std::vector<unsigned long> facets;
 
     // special case: start and endpoint inside same facet
@@ -170,10 +166,65 @@ bool MeshProjection::projectLineOnMesh(const MeshFacetGrid& grid,
     std::sort(facets.begin(), facets.end());
     facets.erase(std::unique(facets.begin(), facets.end()), facets.end());
 
+    return projectLineOnFacets(facets, v1, f1, v2, f2, vd, polyline);
+}
+
+bool MeshProjection::projectLineOnMesh(const MeshFacetBVH& bvh,
+                                       const Base::Vector3f& v1, unsigned long f1,
+                                       const Base::Vector3f& v2, unsigned long f2,
+                                       const Base::Vector3f& vd,
+                                       std::vector<Base::Vector3f>& polyline)
+{
+    // special case: start and endpoint inside same facet
+    if (f1 == f2) {
+        polyline.push_back(v1);
+        polyline.push_back(v2);
+        return true;
+    }
+
+    Base::Vector3f dir(v2 - v1);
+    Base::Vector3f base(v1), normal(vd % dir);
+    normal.Normalize();
+    dir.Normalize();
+
+    // Only facets between the planes through the endpoints perpendicular to
+    // the line can contribute to the result. Unlike bboxInsideRectangle() this
+    // holds for a box whenever it holds for one of its sub boxes.
+    float fMin = v1 * dir;
+    float fMax = v2 * dir;
+    float fEps = 1.0e-4f * (fMax - fMin);
+    auto between = [&](const Base::BoundBox3f& box) -> bool {
+        if (!box.IsCutPlane(base, normal))
+            return false;
+        float fCnt = box.GetCenter() * dir;
+        float fExt = 0.5f * (std::fabs(dir.x) * box.LengthX() +
+                             std::fabs(dir.y) * box.LengthY() +
+                             std::fabs(dir.z) * box.LengthZ());
+        return fCnt + fExt >= fMin - fEps && fCnt - fExt <= fMax + fEps;
+    };
+
+    std::vector<unsigned long> facets;
+    bvh.CollectFacets(between, facets);
+    std::sort(facets.begin(), facets.end());
+
+    return projectLineOnFacets(facets, v1, f1, v2, f2, vd, polyline);
+}
+
+bool MeshProjection::projectLineOnFacets(const std::vector<unsigned long>& facets,
+                                         const Base::Vector3f& v1, unsigned long f1,
+                                         const Base::Vector3f& v2, unsigned long f2,
+                                         const Base::Vector3f& vd,
+                                         std::vector<Base::Vector3f>& polyline)
+{
+    Base::Vector3f dir(v2 - v1);
+    Base::Vector3f base(v1), normal(vd % dir);
+    normal.Normalize();
+    dir.Normalize();
+
     // cut all facets with plane
     std::list< std::pair<Base::Vector3f, Base::Vector3f> > cutLine;
     //unsigned long start = 0, end = 0;
-    for (std::vector<unsigned long>::iterator it = facets.begin(); it != facets.end(); ++it) {
+    for (std::vector<unsigned long>::const_iterator it = facets.begin(); it != facets.end(); ++it) {
         Base::Vector3f e1, e2;
         MeshGeomFacet tria = kernel.GetFacet(*it);
         if (bboxInsideRectangle(tria.GetBoundBox(), v1, v2, vd)) {
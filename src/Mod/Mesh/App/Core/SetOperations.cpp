@@ -41,6 +41,7 @@
 #include "Evaluation.h"
 #include "Definitions.h"
 #include "Triangulation.h"
+#include "Functional.h"
 
 #include <Base/Sequencer.h>
 #include <Base/Builder3D.h>
@@ -170,14 +171,190 @@ void SetOperations::Do ()
   MeshDefinitions::SetMinPointDistance(saveMinMeshDistance);
 }
 
+namespace {
+// Intersection line (or point if both are equal) of two facets
+struct FacetCut
+{
+  unsigned long facet0, facet1;
+  MeshPoint     pt0, pt1;
+};
+
+// Work item of the narrow phase: one grid cell of the first mesh
+struct CellCuts
+{
+  unsigned long         x, y, z;
+  std::vector<FacetCut> cuts;
+};
+
+// Triangles of a cut facet
+struct FacetTriangles
+{
+  unsigned long              facet;
+  std::vector<MeshGeomFacet> triangles;
+};
+}
+
+bool SetOperations::CutFacets (const MeshGeomFacet& f1, const MeshGeomFacet& f2, MeshPoint& mp0, MeshPoint& mp1) const
+{
+  MeshPoint p0, p1;
+
+  int isect = f1.IntersectWithFacet(f2, p0, p1);
+  if (isect > 0)
+  { 
+     // optimize cut line if distance to nearest point is too small
+    float minDist1 = _minDistanceToPoint, minDist2 = _minDistanceToPoint;
+    MeshPoint np0 = p0, np1 = p1;
+    int i;
+    for (i = 0; i < 3; i++)
+    {
+      float d1 = (f1._aclPoints[i] - p0).Length();
+      float d2 = (f1._aclPoints[i] - p1).Length();
+      if (d1 < minDist1)
+      {
+        minDist1 = d1;
+        np0 = f1._aclPoints[i];
+      }
+      if (d2 < minDist2)
+      {
+        minDist2 = d2;
+        p1 = f1._aclPoints[i];
+      }
+    } // for (int i = 0; i < 3; i++)
+
+    // optimize cut line if distance to nearest point is too small
+    for (i = 0; i < 3; i++)
+    {
+      float d1 = (f2._aclPoints[i] - p0).Length();
+      float d2 = (f2._aclPoints[i] - p1).Length();
+      if (d1 < minDist1)
+      {
+        minDist1 = d1;
+        np0 = f2._aclPoints[i];
+      }
+      if (d2 < minDist2)
+      {
+        minDist2 = d2;
+        np1 = f2._aclPoints[i];
+      }
+    } // for (int i = 0; i < 3; i++)
+
+    mp0 = np0;
+    mp1 = np1;
+    return true;
+  }
+
+  return false;
+}
+
 void SetOperations::Cut (std::set<unsigned long>& facetsCuttingEdge0, std::set<unsigned long>& facetsCuttingEdge1)
 {
   MeshFacetGrid grid1(_cutMesh0, 20);
   MeshFacetGrid grid2(_cutMesh1, 20);
 
+  // bounding boxes of the facets of the second mesh to quickly skip facet pairs
+  // that cannot intersect
+  std::vector<Base::BoundBox3f> boxes2(_cutMesh1.CountFacets());
+  parallel_blocks(boxes2.size(), [this, &boxes2](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++)
+      boxes2[i] = _cutMesh1.GetFacet(i).GetBoundBox();
+  });
+
   unsigned long ctGx1, ctGy1, ctGz1;
   grid1.GetCtGrids(ctGx1, ctGy1, ctGz1);
 
+  // The non-empty grid cells are processed in batches. The facet pairs of a batch
+  // are intersected in parallel and the results are merged in the order of the
+  // cells afterwards. So, the outcome is the same as of a sequential run.
+  const std::size_t batchSize = 4096;
+  std::vector<CellCuts> cells;
+  cells.reserve(batchSize);
+
+  auto cutCells = [&]() {
+    parallel_blocks(cells.size(), [&](std::size_t begin, std::size_t end) {
+      std::vector<unsigned long> vecFacets2;
+      std::set<unsigned long> vecFacets1;
+      for (std::size_t c = begin; c < end; c++)
+      {
+        CellCuts& cell = cells[c];
+        vecFacets2.clear();
+        grid2.Inside(grid1.GetBoundBox(cell.x, cell.y, cell.z), vecFacets2);
+        if (vecFacets2.empty())
+          continue;
+
+        vecFacets1.clear();
+        grid1.GetElements(cell.x, cell.y, cell.z, vecFacets1);
+
+        std::set<unsigned long>::iterator it1;
+        for (it1 = vecFacets1.begin(); it1 != vecFacets1.end(); ++it1)
+        {
+          MeshGeomFacet f1 = _cutMesh0.GetFacet(*it1);
+          Base::BoundBox3f box1 = f1.GetBoundBox();
+
+          std::vector<unsigned long>::iterator it2;
+          for (it2 = vecFacets2.begin(); it2 != vecFacets2.end(); ++it2)
+          {
+            if (!box1.Intersect(boxes2[*it2]))
+              continue;
+
+            FacetCut cut;
+            if (CutFacets(f1, _cutMesh1.GetFacet(*it2), cut.pt0, cut.pt1))
+            {
+              cut.facet0 = *it1;
+              cut.facet1 = *it2;
+              cell.cuts.push_back(cut);
+            }
+          }
+        }
+      }
+    }, 16);
+
+    for (std::vector<CellCuts>::iterator it = cells.begin(); it != cells.end(); ++it)
+    {
+      for (std::vector<FacetCut>::iterator jt = it->cuts.begin(); jt != it->cuts.end(); ++jt)
+      {
+        unsigned long fidx1 = jt->facet0;
+        unsigned long fidx2 = jt->facet1;
+        const MeshPoint& mp0 = jt->pt0;
+        const MeshPoint& mp1 = jt->pt1;
+
+        if (mp0 != mp1)
+        {
+          facetsCuttingEdge0.insert(fidx1);
+          facetsCuttingEdge1.insert(fidx2);
+
+          std::pair<std::set<MeshPoint>::iterator, bool> pit0 = _cutPoints.insert(mp0);
+          std::pair<std::set<MeshPoint>::iterator, bool> pit1 = _cutPoints.insert(mp1);
+
+          _edges[Edge(mp0, mp1)] = EdgeInfo();
+
+          _facet2points[0][fidx1].push_back(pit0.first);
+          _facet2points[0][fidx1].push_back(pit1.first);
+          _facet2points[1][fidx2].push_back(pit0.first);
+          _facet2points[1][fidx2].push_back(pit1.first);
+        }
+        else
+        {
+          std::pair<std::set<MeshPoint>::iterator, bool> pit = _cutPoints.insert(mp0);
+
+          // do not insert a facet when only one corner point cuts the edge
+          // if (!((mp0 == f1._aclPoints[0]) || (mp0 == f1._aclPoints[1]) || (mp0 == f1._aclPoints[2])))
+          {
+            facetsCuttingEdge0.insert(fidx1);
+            _facet2points[0][fidx1].push_back(pit.first);
+          }
+
+          // if (!((mp0 == f2._aclPoints[0]) || (mp0 == f2._aclPoints[1]) || (mp0 == f2._aclPoints[2])))
+          {
+            facetsCuttingEdge1.insert(fidx2);
+            _facet2points[1][fidx2].push_back(pit.first);
+          }
+        }
+      }
+    }
+
+    cells.clear();
+  };
+
   unsigned long gx1;
   for (gx1 = 0; gx1 < ctGx1; gx1++)  
   {
@@ -189,227 +366,133 @@ void SetOperations::Cut (std::set<unsigned long>& facetsCuttingEdge0, std::set<u
       {
         if (grid1.GetCtElements(gx1, gy1, gz1) > 0)
         {
-          std::vector<unsigned long> vecFacets2;
-          grid2.Inside(grid1.GetBoundBox(gx1, gy1, gz1), vecFacets2);
-      
-          if (vecFacets2.size() > 0)
-          {
-            std::set<unsigned long> vecFacets1;
-            grid1.GetElements(gx1, gy1, gz1, vecFacets1);
-            
-            std::set<unsigned long>::iterator it1;
-            for (it1 = vecFacets1.begin(); it1 != vecFacets1.end(); ++it1)
-            {
-              unsigned long fidx1 = *it1;
-              MeshGeomFacet f1 = _cutMesh0.GetFacet(*it1);
-              
-              std::vector<unsigned long>::iterator it2;
-              for (it2 = vecFacets2.begin(); it2 != vecFacets2.end(); ++it2)
-              {
-                unsigned long fidx2 = *it2;
-                MeshGeomFacet f2 = _cutMesh1.GetFacet(fidx2);
-
-                MeshPoint p0, p1;
-
-                int isect = f1.IntersectWithFacet(f2, p0, p1);
-                if (isect > 0)
-                { 
-                   // optimize cut line if distance to nearest point is too small
-                  float minDist1 = _minDistanceToPoint, minDist2 = _minDistanceToPoint;
-                  MeshPoint np0 = p0, np1 = p1;
-                  int i;
-                  for (i = 0; i < 3; i++)
-                  {
-                    float d1 = (f1._aclPoints[i] - p0).Length();
-                    float d2 = (f1._aclPoints[i] - p1).Length();
-                    if (d1 < minDist1)
-                    {
-                      minDist1 = d1;
-                      np0 = f1._aclPoints[i];
-                    }
-                    if (d2 < minDist2)
-                    {
-                      minDist2 = d2;
-                      p1 = f1._aclPoints[i];
-                    }
-                  } // for (int i = 0; i < 3; i++)
-
-                  // optimize cut line if distance to nearest point is too small
-                  for (i = 0; i < 3; i++)
-                  {
-                    float d1 = (f2._aclPoints[i] - p0).Length();
-                    float d2 = (f2._aclPoints[i] - p1).Length();
-                    if (d1 < minDist1)
-                    {
-                      minDist1 = d1;
-                      np0 = f2._aclPoints[i];
-                    }
-                    if (d2 < minDist2)
-                    {
-                      minDist2 = d2;
-                      np1 = f2._aclPoints[i];
-                    }
-                  } // for (int i = 0; i < 3; i++)
-
-                  MeshPoint mp0 = np0;
-                  MeshPoint mp1 = np1;
-
-                  if (mp0 != mp1)
-                  {
-                    facetsCuttingEdge0.insert(fidx1);
-                    facetsCuttingEdge1.insert(fidx2);
-
-                    _cutPoints.insert(mp0);
-                    _cutPoints.insert(mp1);
-
-                    std::pair<std::set<MeshPoint>::iterator, bool> pit0 = _cutPoints.insert(mp0);
-                    std::pair<std::set<MeshPoint>::iterator, bool> pit1 = _cutPoints.insert(mp1);
-
-                    _edges[Edge(mp0, mp1)] = EdgeInfo();
-
-                    _facet2points[0][fidx1].push_back(pit0.first);
-                    _facet2points[0][fidx1].push_back(pit1.first);
-                    _facet2points[1][fidx2].push_back(pit0.first);
-                    _facet2points[1][fidx2].push_back(pit1.first);
-
-                  }
-                  else
-                  {
-                    std::pair<std::set<MeshPoint>::iterator, bool> pit = _cutPoints.insert(mp0);
-
-                    // do not insert a facet when only one corner point cuts the edge
-                    // if (!((mp0 == f1._aclPoints[0]) || (mp0 == f1._aclPoints[1]) || (mp0 == f1._aclPoints[2])))
-                    {
-                      facetsCuttingEdge0.insert(fidx1);
-                      _facet2points[0][fidx1].push_back(pit.first);
-                    }
-
-                    // if (!((mp0 == f2._aclPoints[0]) || (mp0 == f2._aclPoints[1]) || (mp0 == f2._aclPoints[2])))
-                    {
-                      facetsCuttingEdge1.insert(fidx2);
-                      _facet2points[1][fidx2].push_back(pit.first);
-                    }
-                  }
-
-                 } // if (f1.IntersectWithFacet(f2, p0, p1))
-              } // for (it2 = vecFacets2.begin(); it2 != vecFacets2.end(); ++it2)
-            } // for (it1 = vecFacets1.begin(); it1 != vecFacets1.end(); ++it1)
-          } // if (vecFacets2.size() > 0)
-        } // if (grid1.GetCtElements(gx1, gy1, gz1) > 0)
+          CellCuts cell;
+          cell.x = gx1;
+          cell.y = gy1;
+          cell.z = gz1;
+          cells.push_back(cell);
+          if (cells.size() == batchSize)
+            cutCells();
+        }
       } // for (gz1 = 0; gz1 < ctGz1; gz1++)
     } // for (gy1 = 0; gy1 < ctGy1; gy1++)
   } // for (gx1 = 0; gx1 < ctGx1; gx1++)  
+
+  cutCells();
 }
 
-void SetOperations::TriangulateMesh (const MeshKernel &cutMesh, int side)
+void SetOperations::TriangulateFacet (const MeshGeomFacet& f, const std::list<std::set<MeshPoint>::iterator>& cutPoints,
+                                      std::vector<MeshGeomFacet>& triangles) const
 {
-  // Triangulate Mesh 
-  std::map<unsigned long, std::list<std::set<MeshPoint>::iterator> >::iterator it1;
-  for (it1 = _facet2points[side].begin(); it1 != _facet2points[side].end(); ++it1)
-  {
-    std::vector<Vector3f> points;
-    std::set<MeshPoint>   pointsSet;
-
-    unsigned long fidx = it1->first;
-    MeshGeomFacet f = cutMesh.GetFacet(fidx);
+  std::vector<Vector3f> points;
+  std::set<MeshPoint>   pointsSet;
 
-    //if (side == 1)
-    //    _builder.addSingleTriangle(f._aclPoints[0], f._aclPoints[1], f._aclPoints[2], 3, 0, 1, 1);
+  // facet corner points
+  int i;
+  for (i = 0; i < 3; i++)
+  {
+    pointsSet.insert(f._aclPoints[i]);
+    points.push_back(f._aclPoints[i]);
+  }
 
-     // facet corner points
-    //const MeshFacet& mf = cutMesh._aclFacetArray[fidx];
-    int i;
-    for (i = 0; i < 3; i++)
+  // triangulated facets
+  std::list<std::set<MeshPoint>::iterator>::const_iterator it2;
+  for (it2 = cutPoints.begin(); it2 != cutPoints.end(); ++it2)
+  {
+    if (pointsSet.find(*(*it2)) == pointsSet.end())
     {
-      pointsSet.insert(f._aclPoints[i]);
-      points.push_back(f._aclPoints[i]);
+      pointsSet.insert(*(*it2));
+      points.push_back(*(*it2));
     }
-    
-    // triangulated facets
-    std::list<std::set<MeshPoint>::iterator>::iterator it2;
-    for (it2 = it1->second.begin(); it2 != it1->second.end(); ++it2)
-    {
-      if (pointsSet.find(*(*it2)) == pointsSet.end())
-      {
-        pointsSet.insert(*(*it2));
-        points.push_back(*(*it2));
-      }
 
-    }
+  }
 
-    Vector3f normal = f.GetNormal();
-    Vector3f base = points[0];
-    Vector3f dirX = points[1] - points[0];
-    dirX.Normalize();
-    Vector3f dirY = dirX % normal;
+  Vector3f normal = f.GetNormal();
+  Vector3f base = points[0];
+  Vector3f dirX = points[1] - points[0];
+  dirX.Normalize();
+  Vector3f dirY = dirX % normal;
 
-    // project points to 2D plane
-    std::vector<Vector3f>::iterator it;
-    std::vector<Vector3f> vertices;
-    for (it = points.begin(); it != points.end(); ++it)
-    {
-      Vector3f pv = *it;
-      pv.TransformToCoordinateSystem(base, dirX, dirY);
-      vertices.push_back(pv);
+  // project points to 2D plane
+  std::vector<Vector3f>::iterator it;
+  std::vector<Vector3f> vertices;
+  for (it = points.begin(); it != points.end(); ++it)
+  {
+    Vector3f pv = *it;
+    pv.TransformToCoordinateSystem(base, dirX, dirY);
+    vertices.push_back(pv);
+  }
+
+  DelaunayTriangulator tria;
+  tria.SetPolygon(vertices);
+  tria.TriangulatePolygon();
+
+  std::vector<MeshFacet> facets = tria.GetFacets();
+  for (std::vector<MeshFacet>::iterator it = facets.begin(); it != facets.end(); ++it)
+  {
+    if ((it->_aulPoints[0] == it->_aulPoints[1]) ||
+        (it->_aulPoints[1] == it->_aulPoints[2]) ||
+        (it->_aulPoints[2] == it->_aulPoints[0]))
+    { // two same triangle corner points
+      continue;
     }
 
-    DelaunayTriangulator tria;
-    tria.SetPolygon(vertices);
-    tria.TriangulatePolygon();
+    MeshGeomFacet facet(points[it->_aulPoints[0]],
+                        points[it->_aulPoints[1]],
+                        points[it->_aulPoints[2]]);
+
+    float dist0 = facet._aclPoints[0].DistanceToLine
+        (facet._aclPoints[1],facet._aclPoints[1] - facet._aclPoints[2]);
+    float dist1 = facet._aclPoints[1].DistanceToLine
+        (facet._aclPoints[0],facet._aclPoints[0] - facet._aclPoints[2]);
+    float dist2 = facet._aclPoints[2].DistanceToLine
+        (facet._aclPoints[0],facet._aclPoints[0] - facet._aclPoints[1]);
 
-    std::vector<MeshFacet> facets = tria.GetFacets();
-    for (std::vector<MeshFacet>::iterator it = facets.begin(); it != facets.end(); ++it)
+    if ((dist0 < _minDistanceToPoint) ||
+        (dist1 < _minDistanceToPoint) ||
+        (dist2 < _minDistanceToPoint))
     {
-      if ((it->_aulPoints[0] == it->_aulPoints[1]) ||
-          (it->_aulPoints[1] == it->_aulPoints[2]) ||
-          (it->_aulPoints[2] == it->_aulPoints[0]))
-      { // two same triangle corner points
-        continue;
-      }
-  
-      MeshGeomFacet facet(points[it->_aulPoints[0]],
-                          points[it->_aulPoints[1]],
-                          points[it->_aulPoints[2]]);
-
-      //if (side == 1)
-      // _builder.addSingleTriangle(facet._aclPoints[0], facet._aclPoints[1], facet._aclPoints[2], true, 3, 0, 1, 1);
-
-      //if (facet.Area() < 0.0001f)
-      //{ // too small facet
-      //  continue;
-      //}
-
-      float dist0 = facet._aclPoints[0].DistanceToLine
-          (facet._aclPoints[1],facet._aclPoints[1] - facet._aclPoints[2]);
-      float dist1 = facet._aclPoints[1].DistanceToLine
-          (facet._aclPoints[0],facet._aclPoints[0] - facet._aclPoints[2]);
-      float dist2 = facet._aclPoints[2].DistanceToLine
-          (facet._aclPoints[0],facet._aclPoints[0] - facet._aclPoints[1]);
-
-      if ((dist0 < _minDistanceToPoint) ||
-          (dist1 < _minDistanceToPoint) ||
-          (dist2 < _minDistanceToPoint))
-      {
-        continue;
-      }
+      continue;
+    }
 
-      //dist0 = (facet._aclPoints[0] - facet._aclPoints[1]).Length();
-      //dist1 = (facet._aclPoints[1] - facet._aclPoints[2]).Length();
-      //dist2 = (facet._aclPoints[2] - facet._aclPoints[3]).Length();
+    facet.CalcNormal();
+    if ((facet.GetNormal() * f.GetNormal()) < 0.0f)
+    { // adjust normal
+      std::swap(facet._aclPoints[0], facet._aclPoints[1]);
+      facet.CalcNormal();
+    }
 
-      //if ((dist0 < _minDistanceToPoint) || (dist1 < _minDistanceToPoint) || (dist2 < _minDistanceToPoint))
-      //{
-      //  continue;
-      //}
+    triangles.push_back(facet);
+  }
+}
 
-      facet.CalcNormal();
-      if ((facet.GetNormal() * f.GetNormal()) < 0.0f)
-      { // adjust normal
-         std::swap(facet._aclPoints[0], facet._aclPoints[1]);
-         facet.CalcNormal();
-      }
+void SetOperations::TriangulateMesh (const MeshKernel &cutMesh, int side)
+{
+  // The triangulation of the cut facets is independent of each other and done in
+  // parallel. The bookkeeping of the cut edges is done afterwards in facet order.
+  std::vector<std::map<unsigned long, std::list<std::set<MeshPoint>::iterator> >::const_iterator> cutFacets;
+  cutFacets.reserve(_facet2points[side].size());
+  std::map<unsigned long, std::list<std::set<MeshPoint>::iterator> >::const_iterator it1;
+  for (it1 = _facet2points[side].begin(); it1 != _facet2points[side].end(); ++it1)
+    cutFacets.push_back(it1);
 
+  std::vector<FacetTriangles> result(cutFacets.size());
+  parallel_blocks(cutFacets.size(), [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++)
+    {
+      result[i].facet = cutFacets[i]->first;
+      TriangulateFacet(cutMesh.GetFacet(cutFacets[i]->first), cutFacets[i]->second, result[i].triangles);
+    }
+  }, 64);
 
+  std::vector<FacetTriangles>::iterator rt;
+  for (rt = result.begin(); rt != result.end(); ++rt)
+  {
+    unsigned long fidx = rt->facet;
+    std::vector<MeshGeomFacet>::iterator ft;
+    for (ft = rt->triangles.begin(); ft != rt->triangles.end(); ++ft)
+    {
+      MeshGeomFacet& facet = *ft;
       int j;
       for (j = 0; j < 3; j++)
       {
@@ -420,9 +503,6 @@ void SetOperations::TriangulateMesh (const MeshKernel &cutMesh, int side)
 
           if (eit->second.fcounter[side] < 2)
           {
-            //if (side == 0)
-            //   _builder.addSingleTriangle(facet._aclPoints[0], facet._aclPoints[1], facet._aclPoints[2], true, 3, 0, 1, 1);
-
             eit->second.facet[side] = fidx;
             eit->second.facets[side][eit->second.fcounter[side]] = facet;
             eit->second.fcounter[side]++;
@@ -433,9 +513,8 @@ void SetOperations::TriangulateMesh (const MeshKernel &cutMesh, int side)
       }
 
       _newMeshFacets[side].push_back(facet);
-
-    } // for (i = 0; i < (out->numberoftriangles * 3); i += 3)
-  } // for (it1 = _facet2points[side].begin(); it1 != _facet2points[side].end(); ++it1)
+    }
+  }
 }
 
 void SetOperations::CollectFacets (int side, float mult)
@@ -172,8 +172,13 @@ private:
 
   /** Cut mesh 1 with mesh 2 */
   void Cut (std::set<unsigned long>& facetsNotCuttingEdge0, std::set<unsigned long>& facetsCuttingEdge1);
+  /** Intersect two facets and snap the cut line to nearby corner points */
+  bool CutFacets (const MeshGeomFacet& f1, const MeshGeomFacet& f2, MeshPoint& mp0, MeshPoint& mp1) const;
   /** Trianglute each facets cut with its cutting points */
   void TriangulateMesh (const MeshKernel &cutMesh, int side);
+  /** Trianglute one facet with its cutting points */
+  void TriangulateFacet (const MeshGeomFacet& f, const std::list<std::set<MeshPoint>::iterator>& cutPoints,
+                         std::vector<MeshGeomFacet>& triangles) const;
   /** search facets for adding (with region growing) */
   void CollectFacets (int side, float mult);
   /** close gap in the mesh */
@@ -9,6 +9,7 @@
 // * Comment out printf statements
 // * Fix compiler warnings
 // * Remove macros loop,i,j,k
+// * Add Vertex::locked to keep vertices on partition seams in place
 
 #include <vector>
 #include <Base/Vector3D.h>
@@ -84,7 +85,9 @@ class Simplify
 {
 public:
     struct Triangle { int v[3];double err[4];int deleted,dirty;vec3f n; };
-    struct Vertex { vec3f p;int tstart,tcount;SymmetricMatrix q;int border;};
+    // locked: if non-zero the vertex is neither moved nor collapsed. The value
+    // is kept by compact_mesh() so that the caller can use it as a key.
+    struct Vertex { vec3f p;int tstart,tcount;SymmetricMatrix q;int border;int locked;};
     struct Ref { int tid,tvertex; }; 
     std::vector<Triangle> triangles;
     std::vector<Vertex> vertices;
@@ -197,6 +200,8 @@ void Simplify::simplify_mesh(int target_count, double tolerance, double aggressi
                     // Border check
                     if (v0.border != v1.border)
                         continue;
+                    if (v0.locked || v1.locked)
+                        continue;
 
                     // Compute vertex to collapse to
                     vec3f p;
@@ -480,6 +485,7 @@ void Simplify::compact_mesh()
         {
             vertices[i].tstart=dst;
             vertices[dst].p=vertices[i].p;
+            vertices[dst].locked=vertices[i].locked;
             dst++;
         }
     }
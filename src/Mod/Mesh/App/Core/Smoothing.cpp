@@ -31,6 +31,7 @@
 #include "Elements.h"
 #include "Iterator.h"
 #include "Approximation.h"
+#include "Functional.h"
 
 
 using namespace MeshCore;
@@ -179,81 +180,88 @@ LaplaceSmoothing::~LaplaceSmoothing()
 {
 }
 
-void LaplaceSmoothing::Umbrella(const MeshRefPointToPoints& vv_it,
-                                const MeshRefPointToFacets& vf_it, double stepsize)
+namespace MeshCore {
+/**
+ * Computes the new position of the point \a pos from the positions in \a points.
+ * Border points and points with less than three neighbours keep their position.
+ */
+static inline Base::Vector3f UmbrellaPoint(const MeshPointArray& points,
+                                           const MeshCompactPointToPoints& vv_it,
+                                           const MeshCompactPointToFacets& vf_it,
+                                           unsigned long pos, double stepsize)
 {
-    const MeshCore::MeshPointArray& points = kernel.GetPoints();
-    MeshCore::MeshPointArray::_TConstIterator v_it,
-    v_beg = points.begin(), v_end = points.end();
-
-    unsigned long pos = 0;
-    for (v_it = points.begin(); v_it != v_end; ++v_it,++pos) {
-        const std::set<unsigned long>& cv = vv_it[pos];
-        if (cv.size() < 3)
-            continue;
-        if (cv.size() != vf_it[pos].size()) {
-            // do nothing for border points
-            continue;
-        }
+    const MeshPoint& p = points[pos];
+    MeshAdjacency::Range cv = vv_it[pos];
+    if (cv.size() < 3)
+        return p;
+    if (cv.size() != vf_it[pos].size()) {
+        // do nothing for border points
+        return p;
+    }
 
-        size_t n_count = cv.size();
-        double w;
-        w=1.0/double(n_count);
+    // the neighbours of a point are stored contiguously
+    const unsigned long* nb = cv.begin();
+    std::size_t n_count = cv.size();
+    double sumx=0.0,sumy=0.0,sumz=0.0;
+    for (std::size_t i = 0; i < n_count; i++) {
+        const MeshPoint& q = points[nb[i]];
+        sumx += static_cast<double>(q.x);
+        sumy += static_cast<double>(q.y);
+        sumz += static_cast<double>(q.z);
+    }
 
-        double delx=0.0,dely=0.0,delz=0.0;
-        std::set<unsigned long>::const_iterator cv_it;
-        for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
-            delx += w*static_cast<double>((v_beg[*cv_it]).x-v_it->x);
-            dely += w*static_cast<double>((v_beg[*cv_it]).y-v_it->y);
-            delz += w*static_cast<double>((v_beg[*cv_it]).z-v_it->z);
-        }
+    double w = 1.0/double(n_count);
+    double delx = w*sumx - static_cast<double>(p.x);
+    double dely = w*sumy - static_cast<double>(p.y);
+    double delz = w*sumz - static_cast<double>(p.z);
 
-        float x = static_cast<float>(static_cast<double>(v_it->x)+stepsize*delx);
-        float y = static_cast<float>(static_cast<double>(v_it->y)+stepsize*dely);
-        float z = static_cast<float>(static_cast<double>(v_it->z)+stepsize*delz);
-        kernel.SetPoint(pos,x,y,z);
-    }
+    float x = static_cast<float>(static_cast<double>(p.x)+stepsize*delx);
+    float y = static_cast<float>(static_cast<double>(p.y)+stepsize*dely);
+    float z = static_cast<float>(static_cast<double>(p.z)+stepsize*delz);
+    return Base::Vector3f(x,y,z);
+}
 }
 
-void LaplaceSmoothing::Umbrella(const MeshRefPointToPoints& vv_it,
-                                const MeshRefPointToFacets& vf_it, double stepsize,
-                                const std::vector<unsigned long>& point_indices)
+void LaplaceSmoothing::Umbrella(const MeshCompactPointToPoints& vv_it,
+                                const MeshCompactPointToFacets& vf_it, double stepsize)
 {
+    // All new positions are computed from the current ones into a second buffer
+    // and copied back afterwards. So, the result doesn't depend on the order the
+    // points are processed and the points can be handled in parallel.
     const MeshCore::MeshPointArray& points = kernel.GetPoints();
-    MeshCore::MeshPointArray::_TConstIterator v_beg = points.begin();
-
-    for (std::vector<unsigned long>::const_iterator pos = point_indices.begin(); pos != point_indices.end(); ++pos) {
-        const std::set<unsigned long>& cv = vv_it[*pos];
-        if (cv.size() < 3)
-            continue;
-        if (cv.size() != vf_it[*pos].size()) {
-            // do nothing for border points
-            continue;
-        }
+    std::size_t count = points.size();
+    buffer.resize(count);
 
-        size_t n_count = cv.size();
-        double w;
-        w=1.0/double(n_count);
+    parallel_blocks(count, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t pos = begin; pos < end; pos++)
+            buffer[pos] = UmbrellaPoint(points, vv_it, vf_it, pos, stepsize);
+    });
 
-        double delx=0.0,dely=0.0,delz=0.0;
-        std::set<unsigned long>::const_iterator cv_it;
-        for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
-            delx += w*static_cast<double>((v_beg[*cv_it]).x-(v_beg[*pos]).x);
-            dely += w*static_cast<double>((v_beg[*cv_it]).y-(v_beg[*pos]).y);
-            delz += w*static_cast<double>((v_beg[*cv_it]).z-(v_beg[*pos]).z);
-        }
+    for (std::size_t pos = 0; pos < count; pos++)
+        kernel.SetPoint(pos, buffer[pos]);
+}
 
-        float x = static_cast<float>(static_cast<double>((v_beg[*pos]).x)+stepsize*delx);
-        float y = static_cast<float>(static_cast<double>((v_beg[*pos]).y)+stepsize*dely);
-        float z = static_cast<float>(static_cast<double>((v_beg[*pos]).z)+stepsize*delz);
-        kernel.SetPoint(*pos,x,y,z);
-    }
+void LaplaceSmoothing::Umbrella(const MeshCompactPointToPoints& vv_it,
+                                const MeshCompactPointToFacets& vf_it, double stepsize,
+                                const std::vector<unsigned long>& point_indices)
+{
+    const MeshCore::MeshPointArray& points = kernel.GetPoints();
+    std::size_t count = point_indices.size();
+    buffer.resize(count);
+
+    parallel_blocks(count, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++)
+            buffer[i] = UmbrellaPoint(points, vv_it, vf_it, point_indices[i], stepsize);
+    });
+
+    for (std::size_t i = 0; i < count; i++)
+        kernel.SetPoint(point_indices[i], buffer[i]);
 }
 
 void LaplaceSmoothing::Smooth(unsigned int iterations)
 {
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    MeshCore::MeshCompactPointToFacets vf_it(kernel);
+    MeshCore::MeshCompactPointToPoints vv_it(vf_it, kernel);
 
     for (unsigned int i=0; i<iterations; i++) {
         Umbrella(vv_it, vf_it, lambda);
@@ -262,8 +270,8 @@ void LaplaceSmoothing::Smooth(unsigned int iterations)
 
 void LaplaceSmoothing::SmoothPoints(unsigned int iterations, const std::vector<unsigned long>& point_indices)
 {
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    MeshCore::MeshCompactPointToFacets vf_it(kernel);
+    MeshCore::MeshCompactPointToPoints vv_it(vf_it, kernel);
 
     for (unsigned int i=0; i<iterations; i++) {
         Umbrella(vv_it, vf_it, lambda, point_indices);
@@ -281,8 +289,8 @@ TaubinSmoothing::~TaubinSmoothing()
 
 void TaubinSmoothing::Smooth(unsigned int iterations)
 {
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    MeshCore::MeshCompactPointToFacets vf_it(kernel);
+    MeshCore::MeshCompactPointToPoints vv_it(vf_it, kernel);
 
     // Theoretically Taubin does not shrink the surface
     iterations = (iterations+1)/2; // two steps per iteration
@@ -294,8 +302,8 @@ void TaubinSmoothing::Smooth(unsigned int iterations)
 
 void TaubinSmoothing::SmoothPoints(unsigned int iterations, const std::vector<unsigned long>& point_indices)
 {
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
+    MeshCore::MeshCompactPointToFacets vf_it(kernel);
+    MeshCore::MeshCompactPointToPoints vv_it(vf_it, kernel);
 
     // Theoretically Taubin does not shrink the surface
     iterations = (iterations+1)/2; // two steps per iteration
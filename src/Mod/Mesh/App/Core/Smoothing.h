@@ -25,12 +25,13 @@
 #define MESH_SMOOTHING_H
 
 #include <vector>
+#include <Base/Vector3D.h>
 
 namespace MeshCore
 {
 class MeshKernel;
-class MeshRefPointToPoints;
-class MeshRefPointToFacets;
+class MeshCompactPointToPoints;
+class MeshCompactPointToFacets;
 
 /** Base class for smoothing algorithms. */
 class MeshExport AbstractSmoothing
@@ -83,14 +84,15 @@ public:
     void SetLambda(double l) { lambda = l;}
 
 protected:
-    void Umbrella(const MeshRefPointToPoints&,
-                  const MeshRefPointToFacets&, double);
-    void Umbrella(const MeshRefPointToPoints&,
-                  const MeshRefPointToFacets&, double,
+    void Umbrella(const MeshCompactPointToPoints&,
+                  const MeshCompactPointToFacets&, double);
+    void Umbrella(const MeshCompactPointToPoints&,
+                  const MeshCompactPointToFacets&, double,
                   const std::vector<unsigned long>&);
 
 protected:
     double lambda;
+    std::vector<Base::Vector3f> buffer;
 };
 
 class MeshExport TaubinSmoothing : public LaplaceSmoothing
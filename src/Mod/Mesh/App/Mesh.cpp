@@ -989,9 +989,10 @@ void MeshObject::decimate(float fTolerance, float fReduction)
     dm.simplify(fTolerance, fReduction);
 }
 
-void MeshObject::decimate(int targetSize)
+void MeshObject::decimate(int targetSize, int partitions)
 {
     MeshCore::MeshSimplify dm(this->_kernel);
+    dm.setPartitions(std::max(0, partitions));
     dm.simplify(targetSize);
 }
 
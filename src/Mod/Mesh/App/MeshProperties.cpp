@@ -445,6 +445,35 @@ PropertyMeshKernel::~PropertyMeshKernel()
     }
 }
 
+bool PropertyMeshKernel::isShared() const
+{
+    // Another reference, usually from a copy made for undo, expects the mesh
+    // object to stay unchanged. The cached Python wrapper references it too.
+    return _meshObject.getRefCount() > (meshPyObject ? 2 : 1);
+}
+
+void PropertyMeshKernel::detach(bool keepContent)
+{
+    if (!isShared())
+        return;
+
+    Base::Reference<MeshObject> mesh(_meshObject);
+    if (keepContent) {
+        _meshObject = new MeshObject(*mesh);
+    }
+    else {
+        _meshObject = new MeshObject();
+        _meshObject->setTransform(mesh->getTransform());
+    }
+
+    // the cached wrapper keeps the old mesh object
+    if (meshPyObject) {
+        meshPyObject->parentProperty = 0;
+        Py_DECREF(meshPyObject);
+        meshPyObject = 0;
+    }
+}
+
 void PropertyMeshKernel::setValuePtr(MeshObject* mesh)
 {
     // use the tmp. object to guarantee that the referenced mesh is not destroyed
@@ -458,6 +487,8 @@ void PropertyMeshKernel::setValuePtr(MeshObject* mesh)
 void PropertyMeshKernel::setValue(const MeshObject& mesh)
 {
     aboutToSetValue();
+    if (&mesh != (MeshObject*)_meshObject)
+        detach(false);
     *_meshObject = mesh;
     hasSetValue();
 }
@@ -465,6 +496,8 @@ void PropertyMeshKernel::setValue(const MeshObject& mesh)
 void PropertyMeshKernel::setValue(const MeshCore::MeshKernel& mesh)
 {
     aboutToSetValue();
+    if (&mesh != &_meshObject->getKernel())
+        detach(false);
     _meshObject->setKernel(mesh);
     hasSetValue();
 }
@@ -472,14 +505,32 @@ void PropertyMeshKernel::setValue(const MeshCore::MeshKernel& mesh)
 void PropertyMeshKernel::swapMesh(MeshObject& mesh)
 {
     aboutToSetValue();
-    _meshObject->swap(mesh);
+    if (isShared()) {
+        // the old mesh must stay unchanged for the copy made for undo, so
+        // the caller gets a copy of it
+        Base::Reference<MeshObject> old(_meshObject);
+        detach(false);
+        _meshObject->swap(mesh);
+        mesh = *old;
+    }
+    else {
+        _meshObject->swap(mesh);
+    }
     hasSetValue();
 }
 
 void PropertyMeshKernel::swapMesh(MeshCore::MeshKernel& mesh)
 {
     aboutToSetValue();
-    _meshObject->swap(mesh);
+    if (isShared()) {
+        Base::Reference<MeshObject> old(_meshObject);
+        detach(false);
+        _meshObject->swap(mesh);
+        mesh = old->getKernel();
+    }
+    else {
+        _meshObject->swap(mesh);
+    }
     hasSetValue();
 }
 
@@ -511,9 +562,17 @@ unsigned int PropertyMeshKernel::getMemSize (void) const
     return size;
 }
 
+unsigned int PropertyMeshKernel::getUnsharedMemSize (void) const
+{
+    if (isShared())
+        return 0;
+    return getMemSize();
+}
+
 MeshObject* PropertyMeshKernel::startEditing()
 {
     aboutToSetValue();
+    detach(true);
     return (MeshObject*)_meshObject;
 }
 
@@ -525,6 +584,7 @@ void PropertyMeshKernel::finishEditing()
 void PropertyMeshKernel::transformGeometry(const Base::Matrix4D &rclMat)
 {
     aboutToSetValue();
+    detach(true);
     _meshObject->transformGeometry(rclMat);
     hasSetValue();
 }
@@ -532,6 +592,7 @@ void PropertyMeshKernel::transformGeometry(const Base::Matrix4D &rclMat)
 void PropertyMeshKernel::setPointIndices(const std::vector<std::pair<unsigned long, Base::Vector3f> >& inds)
 {
     aboutToSetValue();
+    detach(true);
     MeshCore::MeshKernel& kernel = _meshObject->getKernel();
     for (std::vector<std::pair<unsigned long, Base::Vector3f> >::const_iterator it = inds.begin(); it != inds.end(); ++it)
         kernel.SetPoint(it->first, it->second);
@@ -603,6 +664,7 @@ void PropertyMeshKernel::Restore(Base::XMLReader &reader)
         kernel.Adopt(points, facets);
 
         aboutToSetValue();
+        detach(false);
         _meshObject->getKernel().Adopt(points, facets);
         hasSetValue();
     } 
@@ -620,6 +682,7 @@ void PropertyMeshKernel::SaveDocFile (Base::Writer &writer) const
 void PropertyMeshKernel::RestoreDocFile(Base::Reader &reader)
 {
     aboutToSetValue();
+    detach(false);
     _meshObject->load(reader);
     hasSetValue();
 }
@@ -632,10 +695,20 @@ App::Property *PropertyMeshKernel::Copy(void) const
     return prop;
 }
 
+App::Property *PropertyMeshKernel::copyForTransaction(void) const
+{
+    // Note: The mesh object is shared, both properties get their own one
+    // before they are modified
+    PropertyMeshKernel *prop = new PropertyMeshKernel();
+    prop->_meshObject = this->_meshObject;
+    return prop;
+}
+
 void PropertyMeshKernel::Paste(const App::Property &from)
 {
     // Note: Copy the content, do NOT reference the same mesh object
     aboutToSetValue();
+    detach(false);
     const PropertyMeshKernel& prop = dynamic_cast<const PropertyMeshKernel&>(from);
     *(this->_meshObject) = *(prop._meshObject);
     hasSetValue();
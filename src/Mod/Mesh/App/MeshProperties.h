@@ -246,9 +246,25 @@ public:
     void RestoreDocFile(Base::Reader &reader);
 
     App::Property *Copy(void) const;
+    /** Returns a copy that references the same mesh object. This property
+     * gets its own mesh object before it's modified the next time.
+     */
+    App::Property *copyForTransaction(void) const;
     void Paste(const App::Property &from);
+    /** Returns the size of the mesh unless the mesh object is also referenced
+     * elsewhere, usually by the property the copy was made from.
+     */
+    unsigned int getUnsharedMemSize(void) const;
     //@}
 
+private:
+    bool isShared() const;
+    /** Gives this property its own mesh object before it gets modified, if
+     * the current one is also referenced elsewhere. With \a keepContent false
+     * the modification replaces the whole mesh and the old data needn't be copied.
+     */
+    void detach(bool keepContent);
+
 private:
     Base::Reference<MeshObject> _meshObject;
     MeshPy* meshPyObject;
@@ -1727,10 +1727,10 @@ PyObject*  MeshPy::smooth(PyObject *args, PyObject *kwds)
     Py_Return;
 }
 
-PyObject*  MeshPy::decimate(PyObject *args)
+PyObject*  MeshPy::decimate(PyObject *args, PyObject *kwds)
 {
     float fTol, fRed;
-    if (PyArg_ParseTuple(args, "ff", &fTol,&fRed)) {
+    if (!kwds && PyArg_ParseTuple(args, "ff", &fTol,&fRed)) {
         PY_TRY {
             getMeshObjectPtr()->decimate(fTol, fRed);
         } PY_CATCH;
@@ -1740,15 +1740,18 @@ PyObject*  MeshPy::decimate(PyObject *args)
 
     PyErr_Clear();
     int targetSize;
-    if (PyArg_ParseTuple(args, "i", &targetSize)) {
+    int partitions = 0;
+    static char* keywords_decimate[] = {"targetSize","partitions",NULL};
+    if (PyArg_ParseTupleAndKeywords(args, kwds, "i|i",keywords_decimate,
+                                    &targetSize, &partitions)) {
         PY_TRY {
-            getMeshObjectPtr()->decimate(targetSize);
+            getMeshObjectPtr()->decimate(targetSize, partitions);
         } PY_CATCH;
 
         Py_Return;
     }
 
-    PyErr_SetString(PyExc_ValueError, "decimate(tolerance=float, reduction=float) or decimate(targetSize=int)");
+    PyErr_SetString(PyExc_ValueError, "decimate(tolerance=float, reduction=float) or decimate(targetSize=int, [partitions=int])");
     return nullptr;
 }
 
@@ -1941,13 +1944,34 @@ PyObject*  MeshPy::getSegmentsByCurvature(PyObject *args)
 
 PyObject* MeshPy::getCurvaturePerVertex(PyObject* args)
 {
-    if (!PyArg_ParseTuple(args, ""))
+    PyObject* pcObj = 0;
+    if (!PyArg_ParseTuple(args, "|O", &pcObj))
         return NULL;
 
     const MeshCore::MeshKernel& kernel = getMeshObjectPtr()->getKernel();
-    MeshCore::MeshSegmentAlgorithm finder(kernel);
     MeshCore::MeshCurvature meshCurv(kernel);
-    meshCurv.ComputePerVertex();
+    if (pcObj) {
+        std::vector<unsigned long> points;
+        Py::Sequence ary(pcObj);
+        unsigned long numPoints = kernel.CountPoints();
+        for (Py::Sequence::iterator it = ary.begin(); it != ary.end(); ++it) {
+#if PY_MAJOR_VERSION >= 3
+            Py::Long idx(*it);
+#else
+            Py::Int idx(*it);
+#endif
+            unsigned long index = (long)idx;
+            if (index >= numPoints) {
+                PyErr_SetString(PyExc_IndexError, "Point index out of range");
+                return NULL;
+            }
+            points.push_back(index);
+        }
+        meshCurv.ComputePerVertex(points);
+    }
+    else {
+        meshCurv.ComputePerVertex();
+    }
 
     const std::vector<MeshCore::CurvatureInfo>& curv = meshCurv.GetCurvature();
     Py::List list;
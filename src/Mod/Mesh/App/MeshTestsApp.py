@@ -230,3 +230,115 @@ class PolynomialFitCases(unittest.TestCase):
 
     def tearDown(self):
         pass
+
+
+class MeshSmoothingCases(unittest.TestCase):
+    def setUp(self):
+        self.mesh = Mesh.createSphere(10.0, 50)
+
+    def testLaplaceShrinks(self):
+        count = self.mesh.CountPoints
+        volume = self.mesh.Volume
+        self.mesh.smooth(Method="Laplace", Iteration=5)
+        self.assertEqual(self.mesh.CountPoints, count)
+        self.assertLess(self.mesh.Volume, volume)
+
+    def testTaubinKeepsVolume(self):
+        laplace = self.mesh.copy()
+        laplace.smooth(Method="Laplace", Iteration=10)
+        self.mesh.smooth(Method="Taubin", Iteration=10)
+        self.assertGreater(self.mesh.Volume, laplace.Volume)
+
+    def testBorderPointsUnchanged(self):
+        def vec(x, y):
+            return FreeCAD.Vector(x, y, 0.1 * ((x + y) % 2))
+        plane = Mesh.Mesh()
+        for i in range(5):
+            for j in range(5):
+                plane.addFacet(vec(i,j), vec(i+1,j), vec(i,j+1))
+                plane.addFacet(vec(i+1,j), vec(i+1,j+1), vec(i,j+1))
+        border = [p.Vector for p in plane.Points if p.x in (0,5) or p.y in (0,5)]
+        plane.smooth(Method="Laplace", Iteration=3)
+        for v in border:
+            self.assertTrue(any(v.isEqual(p.Vector, 1e-6) for p in plane.Points))
+
+    def tearDown(self):
+        pass
+
+
+class MeshCurvatureCases(unittest.TestCase):
+    def setUp(self):
+        self.mesh = Mesh.createSphere(10.0, 50)
+
+    def testSphereCurvature(self):
+        curv = self.mesh.getCurvaturePerVertex()
+        self.assertEqual(len(curv), self.mesh.CountPoints)
+        for c in curv:
+            self.assertAlmostEqual(c[0], 0.1, delta=0.03)
+            self.assertAlmostEqual(c[1], 0.1, delta=0.03)
+
+    def testSubsetOfPoints(self):
+        curv = self.mesh.getCurvaturePerVertex()
+        indices = [5, 0, self.mesh.CountPoints - 1]
+        subset = self.mesh.getCurvaturePerVertex(indices)
+        self.assertEqual(len(subset), len(indices))
+        for i, c in zip(indices, subset):
+            self.assertEqual(c, curv[i])
+
+    def tearDown(self):
+        pass
+
+
+class MeshDecimationCases(unittest.TestCase):
+    def testDecimateSmallMesh(self):
+        mesh = Mesh.createSphere(10.0, 50)
+        count = mesh.CountFacets
+        mesh.decimate(count // 4)
+        self.assertLess(mesh.CountFacets, count)
+        self.assertTrue(mesh.isSolid())
+
+    def testDecimatePartitioned(self):
+        # force the partitions, the automatic count depends on the number of threads
+        mesh = Mesh.createSphere(10.0, 200)
+        count = mesh.CountFacets
+        serial = mesh.copy()
+        mesh.decimate(count // 10, partitions=4)
+        self.assertLess(mesh.CountFacets, count // 5)
+        self.assertTrue(mesh.isSolid())
+        self.assertFalse(mesh.hasNonManifolds())
+
+        # The distance of the points and facet centers to the sphere bounds the
+        # distance to the original mesh. It must stay close to the serial result.
+        def deviation(m):
+            dev = max(abs(p.Vector.Length - 10.0) for p in m.Points)
+            for f in m.Facets:
+                c = (f.Points[0][0] + f.Points[1][0] + f.Points[2][0]) / 3.0, \
+                    (f.Points[0][1] + f.Points[1][1] + f.Points[2][1]) / 3.0, \
+                    (f.Points[0][2] + f.Points[1][2] + f.Points[2][2]) / 3.0
+                dev = max(dev, abs(FreeCAD.Vector(*c).Length - 10.0))
+            return dev
+        serial.decimate(count // 10, partitions=1)
+        self.assertLessEqual(deviation(mesh), 1.5 * deviation(serial) + 1e-3)
+
+
+class MeshSetOperationsCases(unittest.TestCase):
+    def setUp(self):
+        self.sphere1 = Mesh.createSphere(1.0, 30)
+        self.sphere2 = Mesh.createSphere(1.0, 30)
+        self.sphere2.translate(1.0, 0.0, 0.0)
+
+    def testUnite(self):
+        res = self.sphere1.unite(self.sphere2)
+        self.assertGreater(res.CountFacets, 0)
+        self.assertAlmostEqual(res.BoundBox.XLength, 3.0, 1)
+
+    def testIntersect(self):
+        res = self.sphere1.intersect(self.sphere2)
+        self.assertGreater(res.CountFacets, 0)
+        self.assertAlmostEqual(res.BoundBox.XLength, 1.0, 1)
+
+    def testDifference(self):
+        res = self.sphere1.difference(self.sphere2)
+        self.assertGreater(res.CountFacets, 0)
+        self.assertAlmostEqual(res.BoundBox.XMin, -1.0, 1)
+        self.assertLess(res.BoundBox.XMax, 0.6)
@@ -43,6 +43,7 @@
 # include <BRep_Tool.hxx>
 # include <GeomAPI_IntCS.hxx>
 # include <Standard_Failure.hxx>
+# include <memory>
 #endif
 
 
@@ -53,6 +54,8 @@
 #include <Mod/Mesh/App/Core/MeshKernel.h>
 #include <Mod/Mesh/App/Core/Iterator.h>
 #include <Mod/Mesh/App/Core/Algorithm.h>
+#include <Mod/Mesh/App/Core/BVH.h>
+#include <Mod/Mesh/App/Core/Functional.h>
 #include <Mod/Mesh/App/Core/Projection.h>
 #include <Mod/Mesh/App/Core/Grid.h>
 #include <Mod/Mesh/App/Mesh.h>
@@ -849,10 +852,18 @@ void MeshProjection::projectOnMesh(const std::vector<Base::Vector3f>& pointsIn,
                                    float tolerance,
                                    std::vector<Base::Vector3f>& pointsOut) const
 {
-    // calculate the average edge length and create a grid
+    // calculate the average edge length and create a grid, or build a
+    // bounding volume hierarchy if preferred
     MeshAlgorithm clAlg(_rcMesh);
-    float fAvgLen = clAlg.GetAverageEdgeLength();
-    MeshFacetGrid cGrid(_rcMesh, 5.0f*fAvgLen);
+    std::unique_ptr<MeshFacetGrid> cGrid;
+    std::unique_ptr<MeshCore::MeshFacetBVH> cBVH;
+    if (MeshCore::MeshDefinitions::_bUseFacetBVH) {
+        cBVH.reset(new MeshCore::MeshFacetBVH(_rcMesh));
+    }
+    else {
+        float fAvgLen = clAlg.GetAverageEdgeLength();
+        cGrid.reset(new MeshFacetGrid(_rcMesh, 5.0f*fAvgLen));
+    }
 
     // get all boundary points and edges of the mesh
     std::vector<Base::Vector3f> boundaryPoints;
@@ -879,7 +890,9 @@ void MeshProjection::projectOnMesh(const std::vector<Base::Vector3f>& pointsIn,
     for (auto it : pointsIn) {
         Base::Vector3f result;
         unsigned long index;
-        if (clAlg.NearestFacetOnRay(it, dir, cGrid, result, index)) {
+        bool hit = cBVH ? clAlg.NearestFacetOnRay(it, dir, *cBVH, result, index)
+                        : clAlg.NearestFacetOnRay(it, dir, *cGrid, result, index);
+        if (hit) {
             MeshCore::MeshGeomFacet geomFacet = _rcMesh.GetFacet(index);
             if (tolerance > 0 && geomFacet.IntersectPlaneWithLine(it, dir, result)) {
                 if (geomFacet.IsPointOfFace(result, tolerance))
@@ -926,98 +939,122 @@ void MeshProjection::projectOnMesh(const std::vector<Base::Vector3f>& pointsIn,
 
 void MeshProjection::projectParallelToMesh (const TopoDS_Shape &aShape, const Base::Vector3f& dir, std::vector<PolyLine>& rPolyLines) const
 {
-    // calculate the average edge length and create a grid
-    MeshAlgorithm clAlg(_rcMesh);
-    float fAvgLen = clAlg.GetAverageEdgeLength();
-    MeshFacetGrid cGrid(_rcMesh, 5.0f*fAvgLen);
+    // the sampling of the curves is done by OCC and stays sequential
+    std::vector< std::vector<Base::Vector3f> > samples;
     TopExp_Explorer Ex;
-
-    int iCnt=0;
-    for (Ex.Init(aShape, TopAbs_EDGE); Ex.More(); Ex.Next())
-        iCnt++;
-
-    Base::SequencerLauncher seq( "Project curve on mesh", iCnt );
-
     for (Ex.Init(aShape, TopAbs_EDGE); Ex.More(); Ex.Next()) {
         const TopoDS_Edge& aEdge = TopoDS::Edge(Ex.Current());
         std::vector<Base::Vector3f> points;
         discretize(aEdge, points, 5);
+        samples.push_back(points);
+    }
 
-        typedef std::pair<Base::Vector3f, unsigned long> HitPoint;
-        std::vector<HitPoint> hitPoints;
-        typedef std::pair<HitPoint, HitPoint> HitPoints;
-        std::vector<HitPoints> hitPointPairs;
-        for (auto it : points) {
-            Base::Vector3f result;
-            unsigned long index;
-            if (clAlg.NearestFacetOnRay(it, dir, cGrid, result, index)) {
-                hitPoints.emplace_back(result, index);
-
-                if (hitPoints.size() > 1) {
-                    HitPoint p1 = hitPoints[hitPoints.size()-2];
-                    HitPoint p2 = hitPoints[hitPoints.size()-1];
-                    hitPointPairs.emplace_back(p1, p2);
-                }
-            }
-        }
+    projectSamplesToMesh(samples, dir, rPolyLines);
+}
 
-        MeshCore::MeshProjection meshProjection(_rcMesh);
-        PolyLine polyline;
-        for (auto it : hitPointPairs) {
-            points.clear();
-            if (meshProjection.projectLineOnMesh(cGrid, it.first.first, it.first.second,
-                                                 it.second.first, it.second.second, dir, points)) {
-                polyline.points.insert(polyline.points.end(), points.begin(), points.end());
-            }
-        }
-        rPolyLines.push_back(polyline);
+void MeshProjection::projectParallelToMesh (const std::vector<PolyLine> &aEdges, const Base::Vector3f& dir, std::vector<PolyLine>& rPolyLines) const
+{
+    std::vector< std::vector<Base::Vector3f> > samples;
+    samples.reserve(aEdges.size());
+    for (auto it : aEdges)
+        samples.push_back(it.points);
 
-        seq.next();
-    }
+    projectSamplesToMesh(samples, dir, rPolyLines);
 }
 
-void MeshProjection::projectParallelToMesh (const std::vector<PolyLine> &aEdges, const Base::Vector3f& dir, std::vector<PolyLine>& rPolyLines) const
+void MeshProjection::projectSamplesToMesh(const std::vector< std::vector<Base::Vector3f> >& aSamples,
+                                          const Base::Vector3f& dir, std::vector<PolyLine>& rPolyLines) const
 {
-    // calculate the average edge length and create a grid
+    // The queries of the grid and of the bounding volume hierarchy are const and can
+    // run in parallel. Unlike the grid the hierarchy doesn't have to check all cells to
+    // find the facets between two hit points. Either way only hits in direction of 'dir'
+    // are taken.
     MeshAlgorithm clAlg(_rcMesh);
-    float fAvgLen = clAlg.GetAverageEdgeLength();
-    MeshFacetGrid cGrid(_rcMesh, 5.0f*fAvgLen);
-
-    Base::SequencerLauncher seq( "Project curve on mesh", aEdges.size() );
-
-    for (auto it : aEdges) {
-        std::vector<Base::Vector3f> points = it.points;
-
-        typedef std::pair<Base::Vector3f, unsigned long> HitPoint;
-        std::vector<HitPoint> hitPoints;
-        typedef std::pair<HitPoint, HitPoint> HitPoints;
-        std::vector<HitPoints> hitPointPairs;
-        for (auto it : points) {
-            Base::Vector3f result;
-            unsigned long index;
-            if (clAlg.NearestFacetOnRay(it, dir, cGrid, result, index)) {
-                hitPoints.emplace_back(result, index);
-
-                if (hitPoints.size() > 1) {
-                    HitPoint p1 = hitPoints[hitPoints.size()-2];
-                    HitPoint p2 = hitPoints[hitPoints.size()-1];
-                    hitPointPairs.emplace_back(p1, p2);
-                }
-            }
+    std::unique_ptr<MeshFacetGrid> cGrid;
+    std::unique_ptr<MeshCore::MeshFacetBVH> cBVH;
+    if (MeshCore::MeshDefinitions::_bUseFacetBVH) {
+        cBVH.reset(new MeshCore::MeshFacetBVH(_rcMesh));
+    }
+    else {
+        float fAvgLen = clAlg.GetAverageEdgeLength();
+        cGrid.reset(new MeshFacetGrid(_rcMesh, 5.0f*fAvgLen));
+    }
+
+    std::vector<std::size_t> offsets;
+    std::vector<Base::Vector3f> points;
+    for (auto it : aSamples) {
+        offsets.push_back(points.size());
+        points.insert(points.end(), it.begin(), it.end());
+    }
+    offsets.push_back(points.size());
+
+    // shoot the rays of all samples
+    typedef std::pair<Base::Vector3f, unsigned long> HitPoint;
+    std::vector<HitPoint> hitPoints(points.size());
+    std::vector<char> hits(points.size(), 0);
+    MeshCore::parallel_blocks(points.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            bool hit = cBVH ? clAlg.NearestFacetOnRay(points[i], dir, *cBVH, hitPoints[i].first, hitPoints[i].second)
+                            : clAlg.NearestFacetOnRay(points[i], dir, *cGrid, hitPoints[i].first, hitPoints[i].second);
+            if (hit)
+                hits[i] = 1;
         }
+    }, 256);
+
+    // connect consecutive hit points of each curve
+    typedef std::pair<HitPoint, HitPoint> HitPoints;
+    std::vector<HitPoints> hitPointPairs;
+    std::vector<std::size_t> pairOffsets;
+    for (std::size_t curve = 0; curve < aSamples.size(); curve++) {
+        pairOffsets.push_back(hitPointPairs.size());
+        const HitPoint* prev = nullptr;
+        for (std::size_t i = offsets[curve]; i < offsets[curve+1]; i++) {
+            if (!hits[i])
+                continue;
+            if (prev)
+                hitPointPairs.emplace_back(*prev, hitPoints[i]);
+            prev = &hitPoints[i];
+        }
+    }
+    pairOffsets.push_back(hitPointPairs.size());
+
+    // Project the segments between the hit points. Whole curves are put into batches
+    // that are big enough to run in parallel, and the progress advances per curve.
+    std::vector< std::vector<Base::Vector3f> > sections(hitPointPairs.size());
+    std::vector<char> projected(hitPointPairs.size(), 0);
+    const std::size_t batchSize = 4096;
+    Base::SequencerLauncher seq( "Project curve on mesh", aSamples.size() );
+    std::size_t curve = 0;
+    while (curve < aSamples.size()) {
+        std::size_t last = curve + 1;
+        while (last < aSamples.size() && pairOffsets[last] - pairOffsets[curve] < batchSize)
+            last++;
+
+        std::size_t first = pairOffsets[curve];
+        MeshCore::parallel_blocks(pairOffsets[last] - first, [&](std::size_t begin, std::size_t end) {
+            MeshCore::MeshProjection meshProjection(_rcMesh);
+            for (std::size_t i = first + begin; i < first + end; i++) {
+                const HitPoints& it = hitPointPairs[i];
+                bool ok = cBVH ? meshProjection.projectLineOnMesh(*cBVH, it.first.first, it.first.second,
+                                                                  it.second.first, it.second.second, dir, sections[i])
+                               : meshProjection.projectLineOnMesh(*cGrid, it.first.first, it.first.second,
+                                                                  it.second.first, it.second.second, dir, sections[i]);
+                if (ok)
+                    projected[i] = 1;
+            }
+        }, 16);
+
+        for (; curve < last; curve++)
+            seq.next();
+    }
 
-        MeshCore::MeshProjection meshProjection(_rcMesh);
+    for (std::size_t curve = 0; curve < aSamples.size(); curve++) {
         PolyLine polyline;
-        for (auto it : hitPointPairs) {
-            points.clear();
-            if (meshProjection.projectLineOnMesh(cGrid, it.first.first, it.first.second,
-                                                 it.second.first, it.second.second, dir, points)) {
-                polyline.points.insert(polyline.points.end(), points.begin(), points.end());
-            }
+        for (std::size_t i = pairOffsets[curve]; i < pairOffsets[curve+1]; i++) {
+            if (projected[i])
+                polyline.points.insert(polyline.points.end(), sections[i].begin(), sections[i].end());
         }
         rPolyLines.push_back(polyline);
-
-        seq.next();
     }
 }
 
@@ -1059,32 +1096,39 @@ void MeshProjection::projectEdgeToEdge( const TopoDS_Edge &aEdge, float fMaxDist
 //  Bnd_Box clBB;
 //  BndLib_Add3dCurve::Add( BRepAdaptor_Curve(aEdge), 0.0, clBB );
 
-    MeshPointIterator cPI( _rcMesh );
-    MeshFacetIterator cFI( _rcMesh );
-
-    Base::SequencerLauncher seq( "Project curve on mesh", pEdgeToFace.size() );
-    std::map<std::pair<unsigned long, unsigned long>, std::list<unsigned long> >::iterator it;
-    for ( it = pEdgeToFace.begin(); it != pEdgeToFace.end(); ++it ) {
-        seq.next();
-
+    // The cuts of the curve with the planes through the mesh edges are independent
+    // of each other and are computed in parallel. The edges are processed in batches
+    // so that the progress keeps moving, and the results are taken in edge order.
+    typedef std::map<std::pair<unsigned long, unsigned long>, std::list<unsigned long> >::const_iterator EdgeIterator;
+    std::vector<EdgeIterator> meshEdges;
+    meshEdges.reserve(pEdgeToFace.size());
+    for (EdgeIterator it = pEdgeToFace.begin(); it != pEdgeToFace.end(); ++it)
+        meshEdges.push_back(it);
+
+    struct EdgeCut {
+        int solutions = 0;
+        Standard_Real param = 0;
+        SplitEdge splitEdge;
+    };
+    std::vector<EdgeCut> edgeCuts(meshEdges.size());
+
+    const MeshCore::MeshPointArray& rclPAry = _rcMesh.GetPoints();
+    auto cutEdge = [&](const Handle(Geom_Curve)& curve, EdgeIterator it, EdgeCut& cut) {
         // edge points
         unsigned long uE0 = it->first.first;
-        cPI.Set( uE0 );
-        Base::Vector3f cE0 = *cPI;
+        Base::Vector3f cE0 = rclPAry[uE0];
         unsigned long uE1 = it->first.second;
-        cPI.Set( uE1 );
-        Base::Vector3f cE1 = *cPI;
+        Base::Vector3f cE1 = rclPAry[uE1];
 
         const std::list<unsigned long>& auFaces = it->second;
         if ( auFaces.size() > 2 )
-            continue; // non-manifold edge -> don't handle this
+            return; // non-manifold edge -> don't handle this
 //      if ( clBB.IsOut( gp_Pnt(cE0.x, cE0.y, cE0.z) ) && clBB.IsOut( gp_Pnt(cE1.x, cE1.y, cE1.z) ) )
-//          continue;
+//          return;
 
         Base::Vector3f cEdgeNormal;
         for ( std::list<unsigned long>::const_iterator itF = auFaces.begin(); itF != auFaces.end(); ++itF ) {
-            cFI.Set( *itF );
-            cEdgeNormal += cFI->GetNormal();
+            cEdgeNormal += _rcMesh.GetFacet(*itF).GetNormal();
         }
 
         // create a plane from the edge normal and point
@@ -1093,14 +1137,14 @@ void MeshProjection::projectEdgeToEdge( const TopoDS_Edge &aEdge, float fMaxDist
                                     gp_Dir(cPlaneNormal.x,cPlaneNormal.y,cPlaneNormal.z)));
 
         // get intersection of curve and plane
-        GeomAPI_IntCS Alg(hCurve,hPlane);
+        GeomAPI_IntCS Alg(curve,hPlane);
         if ( Alg.IsDone() ) {
             Standard_Integer nNbPoints = Alg.NbPoints();
-            if ( nNbPoints == 1 ) {
+            // search for the right solution, only one sensible solution is taken
+            for ( int j=1; j<=nNbPoints; j++ ) {
                 Standard_Real fU, fV, fW;
-                Alg.Parameters( 1, fU, fV, fW);
-
-                gp_Pnt P = Alg.Point(1);
+                Alg.Parameters( j, fU, fV, fW);
+                gp_Pnt P = Alg.Point(j);
                 Base::Vector3f cP0((float)P.X(), (float)P.Y(), (float)P.Z());
 
                 float l = ( (cP0 - cE0) * (cE1 - cE0) ) / ( (cE1 - cE0) * ( cE1 - cE0) );
@@ -1111,53 +1155,40 @@ void MeshProjection::projectEdgeToEdge( const TopoDS_Edge &aEdge, float fMaxDist
                     float fDist = Base::Distance( cP0, cSplitPoint );
 
                     if ( fDist <= fMaxDist ) {
-                        SplitEdge splitEdge;
-                        splitEdge.uE0 = uE0;
-                        splitEdge.uE1 = uE1;
-                        splitEdge.cPt = cSplitPoint;
-                        rParamSplitEdges[fW] = splitEdge;
+                        cut.solutions++;
+                        cut.param = fW;
+                        cut.splitEdge.uE0 = uE0;
+                        cut.splitEdge.uE1 = uE1;
+                        cut.splitEdge.cPt = cSplitPoint;
                     }
                 }
             }
-            // search for the right solution
-            else if ( nNbPoints > 1 ) {
-                int nCntSol=0;
-                Base::Vector3f cSplitPoint;
-                Standard_Real fSol;
-                Base::Vector3f cP0;
-                for ( int j=1; j<=nNbPoints; j++ ) {
-                    Standard_Real fU, fV, fW;
-                    Alg.Parameters( j, fU, fV, fW);
-                    gp_Pnt P = Alg.Point(j);
-                    cP0.Set((float)P.X(), (float)P.Y(), (float)P.Z());
-
-                    float l = ( (cP0 - cE0) * (cE1 - cE0) ) / ( (cE1 - cE0) * ( cE1 - cE0) );
-
-                    // lies the point inside the edge?
-                    if ( l>=0.0 && l<=1.0 ) {
-                        cSplitPoint = (1-l) * cE0 + l * cE1;
-                        float fDist = Base::Distance( cP0, cSplitPoint );
-
-                        if (fDist <= fMaxDist) {
-                            nCntSol++;
-                            fSol = fW;
-                        }
-                    }
-                }
-
-                // ok, only one sensible solution
-                if ( nCntSol == 1 ) {
-                    SplitEdge splitEdge;
-                    splitEdge.uE0 = uE0;
-                    splitEdge.uE1 = uE1;
-                    splitEdge.cPt = cSplitPoint;
-                    rParamSplitEdges[fSol] = splitEdge;
-                }
-                else if ( nCntSol > 1 ) {
-                    Base::Console().Log("More than one possible intersection points\n");
-                }
-            }
         }
+    };
+
+    if (hCurve.IsNull())
+        return;
+
+    const std::size_t batchSize = 4096;
+    Base::SequencerLauncher seq( "Project curve on mesh", meshEdges.size() );
+    for (std::size_t first = 0; first < meshEdges.size(); first += batchSize) {
+        std::size_t last = std::min(meshEdges.size(), first + batchSize);
+        MeshCore::parallel_blocks(last - first, [&](std::size_t begin, std::size_t end) {
+            // older OCC versions cache evaluations inside the curve, so each block uses its own copy
+            Handle(Geom_Curve) curve = Handle(Geom_Curve)::DownCast(hCurve->Copy());
+            for (std::size_t i = first + begin; i < first + end; i++)
+                cutEdge(curve, meshEdges[i], edgeCuts[i]);
+        }, 64);
+
+        for (std::size_t i = first; i < last; i++)
+            seq.next();
+    }
+
+    for (std::vector<EdgeCut>::const_iterator it = edgeCuts.begin(); it != edgeCuts.end(); ++it) {
+        if (it->solutions == 1)
+            rParamSplitEdges[it->param] = it->splitEdge;
+        else if (it->solutions > 1)
+            Base::Console().Log("More than one possible intersection points\n");
     }
 
     // sorted by parameter
@@ -225,6 +225,13 @@ public:
 protected:
     void projectEdgeToEdge(const TopoDS_Edge &aCurve, float fMaxDist, const MeshCore::MeshFacetGrid& rGrid,
                            std::vector<SplitEdge>& rSplitEdges) const;
+    /**
+     * Projects the sampled curves \a aSamples onto the mesh along \a dir and appends
+     * one polyline per curve to \a rPolyLines. The samples and the segments between
+     * them are processed in parallel.
+     */
+    void projectSamplesToMesh(const std::vector< std::vector<Base::Vector3f> >& aSamples,
+                              const Base::Vector3f& dir, std::vector<PolyLine>& rPolyLines) const;
     bool findIntersection(const Edge&, const Edge&, const Base::Vector3f& dir, Base::Vector3f& res) const;
 
 private:
@@ -36,6 +36,8 @@
 #include <tuple>
 #include <array>
 
+#include <Mod/Mesh/App/Core/Functional.h>
+
 #ifndef M_PI
 #define M_PI    3.14159265358979323846f
 #endif
@@ -145,64 +147,158 @@ LscmRelax::LscmRelax(
 //////////////////////////////////////////////////////////////////////////
 /////////////////                 F.E.M                      /////////////
 //////////////////////////////////////////////////////////////////////////
-void LscmRelax::relax(double weight)
+
+// Adds up the values of a sparse matrix with a fixed pattern. The first
+// assembly builds the matrix from triplets and records the position of every
+// value, later assemblies add the values in place in the same order.
+class PatternAssembler
 {
-    ColMat<double, 3> d_q_l_g = this->q_l_m - this->q_l_g;
-    // for every triangle
-    Eigen::Matrix<double, 3, 6> B;
-    Eigen::Matrix<double, 2, 2> T;
-    Eigen::Matrix<double, 6, 6> K_m;
-    Eigen::Matrix<double, 6, 1> u_m, rhs_m;
-    Eigen::VectorXd rhs(this->vertices.cols() * 2 + 3);
-    if (this->sol.size() == 0)
-        this->sol.Zero(this->vertices.cols() * 2 + 3);
-    spMat K_g(this->vertices.cols() * 2 + 3, this->vertices.cols() * 2 + 3);
-    std::vector<trip> K_g_triplets;
-    Vector2 v1, v2, v3, v12, v23, v31;
-    long row_pos, col_pos;
-    double A;
+  public:
+    PatternAssembler(spMat& mat, std::vector<long>& entries, bool build, std::size_t count)
+        : mat(mat), entries(entries), build(build)
+    {
+        if (build)
+        {
+            this->triplets.reserve(count);
+            this->entries.clear();
+        }
+        else
+        {
+            this->values = mat.valuePtr();
+            std::fill(this->values, this->values + mat.nonZeros(), 0.0);
+        }
+    }
 
-    rhs.setZero();
+    void add(long row, long col, double value)
+    {
+        if (this->build)
+            this->triplets.push_back(trip(row, col, value));
+        else
+            this->values[this->entries[this->entry++]] += value;
+    }
 
-    for (long i=0; i<this->triangles.cols(); i++)
+    void finish(long rows, long cols)
     {
-        // 1: construct B-mat in m-system
-        v1 = this->flat_vertices.col(this->triangles(0, i));
-        v2 = this->flat_vertices.col(this->triangles(1, i));
-        v3 = this->flat_vertices.col(this->triangles(2, i));
-        v12 = v2 - v1;
-        v23 = v3 - v2;
-        v31 = v1 - v3;
-        B << -v23.y(),   0,        -v31.y(),   0,        -v12.y(),   0,
-              0,         v23.x(),   0,         v31.x(),   0,         v12.x(),
-             -v23.x(),   v23.y(),  -v31.x(),   v31.y(),  -v12.x(),   v12.y();
-        T << v12.x(), -v12.y(),
-             v12.y(), v12.x();
-        T /= v12.norm();
-        A = std::abs(this->q_l_m(i, 0) * this->q_l_m(i, 2) / 2);
-        B /= A * 2; // (2*area)
-
-        // 2: sigma due dqlg in m-system
-        u_m << Vector2(0, 0), T * Vector2(d_q_l_g(i, 0), 0), T * Vector2(d_q_l_g(i, 1), d_q_l_g(i, 2));
-
-        // 3: rhs_m = B.T * C * B * dqlg_m
-        //    K_m = B.T * C * B
-        rhs_m = B.transpose() * this->C * B * u_m * A;
-        K_m = B.transpose() * this->C * B * A;
+        if (!this->build)
+            return;
+        this->mat.resize(rows, cols);
+        this->mat.setFromTriplets(this->triplets.begin(), this->triplets.end());
+        this->mat.makeCompressed();
+
+        const int* outer = this->mat.outerIndexPtr();
+        const int* inner = this->mat.innerIndexPtr();
+        this->entries.reserve(this->triplets.size());
+        for (auto triplet: this->triplets)
+        {
+            const int* pos = std::lower_bound(inner + outer[triplet.col()], inner + outer[triplet.col() + 1], triplet.row());
+            this->entries.push_back(pos - inner);
+        }
+    }
+
+  private:
+    spMat& mat;
+    std::vector<long>& entries;
+    bool build;
+    std::vector<trip> triplets;
+    double* values = nullptr;
+    std::size_t entry = 0;
+};
 
+struct LscmRelax::RelaxSystem
+{
+    spMat K_g;
+    // position of every assembled value in K_g.valuePtr()
+    std::vector<long> entries;
+    Eigen::SimplicialLDLT<spMat, Eigen::Lower> solver;
+    bool analyzed = false;
+};
+
+struct LscmRelax::EdgeSystem
+{
+    std::vector<std::array<long, 2>> edges;
+    spMat K_g;
+    std::vector<long> entries;
+};
+
+void LscmRelax::assemble_relax(Eigen::VectorXd & rhs)
+{
+    long n_vertices = this->vertices.cols();
+    long n_triangles = this->triangles.cols();
+    // the conjugate gradient method projects out the rigid body motions instead
+    // of using lagrange multipliers, so it only needs the stiffness block
+    bool multipliers = !this->iterative_relax;
+    long n_dof = n_vertices * 2 + (multipliers ? 3 : 0);
+    ColMat<double, 3> d_q_l_g = this->q_l_m - this->q_l_g;
+
+    // the element matrices of the triangles are independent of each other
+    std::vector<Eigen::Matrix<double, 6, 6>, Eigen::aligned_allocator<Eigen::Matrix<double, 6, 6>>> K_m(n_triangles);
+    std::vector<Eigen::Matrix<double, 6, 1>, Eigen::aligned_allocator<Eigen::Matrix<double, 6, 1>>> rhs_m(n_triangles);
+    MeshCore::parallel_blocks(n_triangles, [&](std::size_t begin, std::size_t end)
+    {
+        Eigen::Matrix<double, 3, 6> B;
+        Eigen::Matrix<double, 2, 2> T;
+        Eigen::Matrix<double, 6, 1> u_m;
+        Vector2 v1, v2, v3, v12, v23, v31;
+        double A;
+        for (long i=begin; i<static_cast<long>(end); i++)
+        {
+            // 1: construct B-mat in m-system
+            v1 = this->flat_vertices.col(this->triangles(0, i));
+            v2 = this->flat_vertices.col(this->triangles(1, i));
+            v3 = this->flat_vertices.col(this->triangles(2, i));
+            v12 = v2 - v1;
+            v23 = v3 - v2;
+            v31 = v1 - v3;
+            B << -v23.y(),   0,        -v31.y(),   0,        -v12.y(),   0,
+                  0,         v23.x(),   0,         v31.x(),   0,         v12.x(),
+                 -v23.x(),   v23.y(),  -v31.x(),   v31.y(),  -v12.x(),   v12.y();
+            T << v12.x(), -v12.y(),
+                 v12.y(), v12.x();
+            T /= v12.norm();
+            A = std::abs(this->q_l_m(i, 0) * this->q_l_m(i, 2) / 2);
+            B /= A * 2; // (2*area)
+
+            // 2: sigma due dqlg in m-system
+            u_m << Vector2(0, 0), T * Vector2(d_q_l_g(i, 0), 0), T * Vector2(d_q_l_g(i, 1), d_q_l_g(i, 2));
+
+            // 3: rhs_m = B.T * C * B * dqlg_m
+            //    K_m = B.T * C * B
+            rhs_m[i] = B.transpose() * this->C * B * u_m * A;
+            K_m[i] = B.transpose() * this->C * B * A;
+        }
+    });
+
+    // the pattern only has to be built once, later calls write the values in place
+    std::size_t n_entries = n_triangles * 36 + (multipliers ? n_vertices * 8 : 0);
+    bool build = !this->relax_system || this->relax_system->K_g.rows() != n_dof ||
+        this->relax_system->entries.size() != n_entries;
+    if (build)
+        this->relax_system.reset(new RelaxSystem);
+    RelaxSystem& system = *this->relax_system;
+
+    PatternAssembler K_g(system.K_g, system.entries, build, n_entries);
+    auto add = [&K_g](long row, long col, double value)
+    {
+        K_g.add(row, col, value);
+    };
+
+    rhs.setZero(n_dof);
+    long row_pos, col_pos;
+    for (long i=0; i<n_triangles; i++)
+    {
         // 5: add to rhs_g, K_g
         for (int j=0; j < 3; j++)
         {
             row_pos = this->triangles(j, i);
-            rhs[row_pos * 2]     += rhs_m[j * 2];
-            rhs[row_pos * 2 + 1] += rhs_m[j * 2 +1];
+            rhs[row_pos * 2]     += rhs_m[i][j * 2];
+            rhs[row_pos * 2 + 1] += rhs_m[i][j * 2 +1];
             for (int k=0; k < 3; k++)
             {
                 col_pos = this->triangles(k, i);
-                K_g_triplets.push_back(trip(row_pos * 2,     col_pos * 2,        K_m(j * 2,      k * 2)));
-                K_g_triplets.push_back(trip(row_pos * 2 + 1, col_pos * 2,        K_m(j * 2 + 1,  k * 2)));
-                K_g_triplets.push_back(trip(row_pos * 2 + 1, col_pos * 2 + 1,    K_m(j * 2 + 1,  k * 2 + 1)));
-                K_g_triplets.push_back(trip(row_pos * 2,     col_pos * 2 + 1,    K_m(j * 2,      k * 2 + 1)));
+                add(row_pos * 2,     col_pos * 2,        K_m[i](j * 2,      k * 2));
+                add(row_pos * 2 + 1, col_pos * 2,        K_m[i](j * 2 + 1,  k * 2));
+                add(row_pos * 2 + 1, col_pos * 2 + 1,    K_m[i](j * 2 + 1,  k * 2 + 1));
+                add(row_pos * 2,     col_pos * 2 + 1,    K_m[i](j * 2,      k * 2 + 1));
                 // we don't have to fill all because the matrix is symmetric.
             }
         }
@@ -251,19 +347,19 @@ void LscmRelax::relax(double weight)
     //     K_g_triplets.push_back(trip(i, i, 0.01));
 
     // lagrange multiplier
-    for (long i=0; i < this->flat_vertices.cols() ; i++)
+    for (long i=0; multipliers && i < this->flat_vertices.cols() ; i++)
     {
         // fixing total ux
-        K_g_triplets.push_back(trip(i * 2, this->flat_vertices.cols() * 2, 1));
-        K_g_triplets.push_back(trip(this->flat_vertices.cols() * 2, i * 2, 1));
+        add(i * 2, this->flat_vertices.cols() * 2, 1);
+        add(this->flat_vertices.cols() * 2, i * 2, 1);
         // fixing total uy
-        K_g_triplets.push_back(trip(i * 2 + 1, this->flat_vertices.cols() * 2 + 1, 1));
-        K_g_triplets.push_back(trip(this->flat_vertices.cols() * 2 + 1, i * 2 + 1, 1));
+        add(i * 2 + 1, this->flat_vertices.cols() * 2 + 1, 1);
+        add(this->flat_vertices.cols() * 2 + 1, i * 2 + 1, 1);
         // fixing ux*y-uy*x
-        K_g_triplets.push_back(trip(i * 2, this->flat_vertices.cols() * 2 + 2, - this->flat_vertices(1, i)));
-        K_g_triplets.push_back(trip(this->flat_vertices.cols() * 2 + 2, i * 2, - this->flat_vertices(1, i)));
-        K_g_triplets.push_back(trip(i * 2 + 1, this->flat_vertices.cols() * 2 + 2, this->flat_vertices(0, i)));
-        K_g_triplets.push_back(trip(this->flat_vertices.cols() * 2 + 2, i * 2 + 1, this->flat_vertices(0, i)));
+        add(i * 2, this->flat_vertices.cols() * 2 + 2, - this->flat_vertices(1, i));
+        add(this->flat_vertices.cols() * 2 + 2, i * 2, - this->flat_vertices(1, i));
+        add(i * 2 + 1, this->flat_vertices.cols() * 2 + 2, this->flat_vertices(0, i));
+        add(this->flat_vertices.cols() * 2 + 2, i * 2 + 1, this->flat_vertices(0, i));
     }
 
     // project out the nullspace solution:
@@ -282,14 +378,43 @@ void LscmRelax::relax(double weight)
     // rhs -= nullspace1.dot(rhs) * nullspace1;
     // rhs -= nullspace2.dot(rhs) * nullspace2;
 
-    K_g.setFromTriplets(K_g_triplets.begin(), K_g_triplets.end());
-    // rhs +=  K_g * Eigen::VectorXd::Ones(K_g.rows());
-    
-    // solve linear system (privately store the value for guess in next step)
-    Eigen::SimplicialLDLT<spMat, Eigen::Lower> solver;
-    solver.compute(K_g);
-    this->sol = solver.solve(-rhs);
-    this->set_shift(this->sol.head(this->vertices.cols() * 2) * weight);
+    K_g.finish(n_dof, n_dof);
+}
+
+void LscmRelax::relax(double weight)
+{
+    long n = this->vertices.cols() * 2;
+    Eigen::VectorXd rhs;
+    this->assemble_relax(rhs);
+    const spMat& K_g = this->relax_system->K_g;
+
+    if (this->iterative_relax)
+    {
+        // Instead of the lagrange multipliers the rigid body motions are projected
+        // out of the search directions. The solution is the increment of this step,
+        // which goes to zero while relaxing, so zero is the best initial guess.
+        Eigen::ConjugateGradient<spMat, Eigen::Lower, JacobiNullSpaceProjector> solver;
+        solver.preconditioner().setNullSpace(this->get_nullspace());
+        solver.setTolerance(1e-10);
+        solver.compute(K_g);
+        Eigen::VectorXd u = solver.solve(-rhs);
+        this->sol.setZero(n + 3);
+        this->sol.head(n) = u;
+    }
+    else
+    {
+        // solve linear system (privately store the value for guess in next step)
+        // the symbolic factorization is done once for all iterations
+        RelaxSystem& system = *this->relax_system;
+        if (!system.analyzed)
+        {
+            system.solver.analyzePattern(K_g);
+            system.analyzed = true;
+        }
+        system.solver.factorize(K_g);
+        this->sol = system.solver.solve(-rhs);
+    }
+    this->set_shift(this->sol.head(n) * weight);
     this->set_q_l_m();
 }
 
@@ -351,33 +476,41 @@ void LscmRelax::area_relax(double weight)
 
 void LscmRelax::edge_relax(double weight)
 {
-//  1. get all edges
-    std::set<std::array<long, 2>> edges;
-    std::array<long, 2> edge;
-    for(long i=0; i<this->triangles.cols(); i++)
+    long n_dof = this->vertices.cols() * 2;
+    // the edges and the pattern of the stiffness matrix only depend on the triangles
+    bool build = !this->edge_system || this->edge_system->K_g.rows() != n_dof;
+    if (build)
     {
-        for(int j=0; j<3; j++)
+        this->edge_system.reset(new EdgeSystem);
+//  1. get all edges
+        std::set<std::array<long, 2>> edges;
+        std::array<long, 2> edge;
+        for(long i=0; i<this->triangles.cols(); i++)
         {
-            long k = j+1;
-            if (k==3)
-                k = 0;
-            if (this->triangles(j, i) < this->triangles(k, i))
-                edge = std::array<long, 2>{{this->triangles(j, i), this->triangles(k, i)}};
-            else
-                edge = std::array<long, 2>{{this->triangles(k, i), this->triangles(j, i)}};
-            edges.insert(edge);
+            for(int j=0; j<3; j++)
+            {
+                long k = j+1;
+                if (k==3)
+                    k = 0;
+                if (this->triangles(j, i) < this->triangles(k, i))
+                    edge = std::array<long, 2>{{this->triangles(j, i), this->triangles(k, i)}};
+                else
+                    edge = std::array<long, 2>{{this->triangles(k, i), this->triangles(j, i)}};
+                edges.insert(edge);
+            }
         }
+        this->edge_system->edges.assign(edges.begin(), edges.end());
     }
+    EdgeSystem& system = *this->edge_system;
 //  2. create system
 
     if (this->sol.size() == 0)
         this->sol.Zero(this->vertices.cols());
 
-    std::vector<trip> K_g_triplets;
-    spMat K_g(this->vertices.cols() * 2, this->vertices.cols() * 2);
-    Eigen::VectorXd rhs(this->vertices.cols() * 2);
+    PatternAssembler K_g(system.K_g, system.entries, build, system.edges.size() * 16);
+    Eigen::VectorXd rhs(n_dof);
     rhs.setZero();
-    for(auto edge : edges)
+    for(auto edge : system.edges)
     {
 // 	this goes to the right side
 	Vector3 v1_g = this->vertices.col(edge[0]);
@@ -404,16 +537,16 @@ void LscmRelax::edge_relax(double weight)
 	{
 	    for (auto col: range_4)
 	    {
-		K_g_triplets.push_back(trip(indices[row], indices[col], (double) K(row, col)));
+		K_g.add(indices[row], indices[col], (double) K(row, col));
 	    }
 	    rhs(indices[row]) += rhs_m[row];
 	}
     }
 
-    K_g.setFromTriplets(K_g_triplets.begin(), K_g_triplets.end());
+    K_g.finish(n_dof, n_dof);
     Eigen::ConjugateGradient<spMat,Eigen::Lower, NullSpaceProjector> solver;
     solver.preconditioner().setNullSpace(this->get_nullspace());
-    solver.compute(K_g);
+    solver.compute(system.K_g);
     this->sol = solver.solve(-rhs);
     this->set_shift(this->sol * weight);
 }
@@ -701,7 +834,7 @@ std::vector<long> LscmRelax::get_fem_fixed_pins()
 Eigen::MatrixXd LscmRelax::get_nullspace()
 {
     Eigen::MatrixXd null_space;
-    null_space.setZero(this->flat_vertices.size() * 2, 3);
+    null_space.setZero(this->flat_vertices.cols() * 2, 3);
 
     for (int i=0; i<this->flat_vertices.cols(); i++)
     {
@@ -66,10 +66,63 @@ class NullSpaceProjector: public Eigen::IdentityPreconditioner
 	this->null_space_2 = null_space.transpose();
     }
 };
+
+// the nullspace projection around a diagonal scaling, keeps the
+// preconditioner symmetric for the conjugate gradient method
+class JacobiNullSpaceProjector: public NullSpaceProjector
+{
+  public:
+    Eigen::VectorXd inv_diag;
+
+    template<typename MatType>
+    JacobiNullSpaceProjector& analyzePattern(const MatType&) { return *this; }
+
+    template<typename MatType>
+    JacobiNullSpaceProjector& factorize(const MatType& mat) {
+	this->inv_diag.setOnes(mat.cols());
+	for (Eigen::Index j = 0; j < mat.outerSize(); j++) {
+	    typename MatType::InnerIterator it(mat, j);
+	    while (it && it.index() != j)
+		++it;
+	    if (it && it.value() != 0)
+		this->inv_diag[j] = 1. / it.value();
+	}
+	return *this;
+    }
+
+    template<typename MatType>
+    JacobiNullSpaceProjector& compute(const MatType& mat) { return this->factorize(mat); }
+
+    template<typename Rhs>
+    inline Rhs solve(Rhs& b) const {
+	Rhs x = NullSpaceProjector::solve(b);
+	x = x.cwiseProduct(this->inv_diag);
+	return NullSpaceProjector::solve(x);
+    }
+};
     
 typedef Eigen::Vector3d Vector3;
 typedef Eigen::Vector2d Vector2;
 
+// holds data that is computed once and reused by later calls, a copy of the
+// owner starts empty instead of sharing the data with the original
+template<typename T>
+class SystemCache
+{
+  public:
+    SystemCache() {}
+    SystemCache(const SystemCache&) {}
+    SystemCache& operator=(const SystemCache&) { this->ptr.reset(); return *this; }
+
+    void reset(T* p = nullptr) { this->ptr.reset(p); }
+    T& operator*() const { return *this->ptr; }
+    T* operator->() const { return this->ptr.get(); }
+    explicit operator bool() const { return static_cast<bool>(this->ptr); }
+
+  private:
+    std::shared_ptr<T> ptr;
+};
+
 class LscmRelax{
 private:
     ColMat<double, 3> q_l_g;  // the position of the 3d triangles at there locale coord sys
@@ -90,6 +143,14 @@ private:
     std::vector<long> get_fem_fixed_pins();
     Eigen::MatrixXd get_nullspace();
 
+    // the stiffness matrices of relax() and edge_relax() and the
+    // factorization keep their sparsity pattern over all iterations
+    struct RelaxSystem;
+    struct EdgeSystem;
+    SystemCache<RelaxSystem> relax_system;
+    SystemCache<EdgeSystem> edge_system;
+    void assemble_relax(Eigen::VectorXd & rhs);
+
 public:
     LscmRelax() {}
     LscmRelax(
@@ -106,6 +167,9 @@ public:
 
     double nue=0.9;
     double elasticity=1.;
+    // solve the relax steps with a conjugate gradient method instead of a
+    // direct factorization, needs less memory for big meshes
+    bool iterative_relax=false;
 
     void lscm();
     void relax(double);
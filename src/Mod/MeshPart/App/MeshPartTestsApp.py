@@ -0,0 +1,63 @@
+# -*- coding: utf-8 -*-
+
+#***************************************************************************
+#*   This file is part of the FreeCAD CAx development system.              *
+#*                                                                         *
+#*   This program is free software; you can redistribute it and/or modify  *
+#*   it under the terms of the GNU Lesser General Public License (LGPL)    *
+#*   as published by the Free Software Foundation; either version 2 of     *
+#*   the License, or (at your option) any later version.                   *
+#*   for detail see the LICENCE text file.                                 *
+#*                                                                         *
+#*   FreeCAD is distributed in the hope that it will be useful,            *
+#*   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#*   GNU Lesser General Public License for more details.                   *
+#*                                                                         *
+#*   You should have received a copy of the GNU Library General Public     *
+#*   License along with FreeCAD; if not, write to the Free Software        *
+#*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#*   USA                                                                   *
+#*                                                                         *
+#***************************************************************************/
+
+import FreeCAD, unittest, Mesh, MeshPart
+
+
+#---------------------------------------------------------------------------
+# define the functions to test the FreeCAD MeshPart module
+#---------------------------------------------------------------------------
+
+
+class MeshProjectionCases(unittest.TestCase):
+    def setUp(self):
+        # a square in the xy plane made of two triangles
+        self.mesh = Mesh.Mesh([[0, 0, 0], [10, 0, 0], [10, 10, 0],
+                               [0, 0, 0], [10, 10, 0], [0, 10, 0]])
+        # crosses the common edge of the triangles
+        self.polygon = [FreeCAD.Vector(1, 2, 5), FreeCAD.Vector(8, 3, 5)]
+
+    def testProjectAlongDirection(self):
+        lines = MeshPart.projectShapeOnMesh([self.polygon], self.mesh, FreeCAD.Vector(0, 0, -1))
+        self.assertEqual(len(lines), 1)
+        self.assertGreaterEqual(len(lines[0]), 2)
+        for pnt in lines[0]:
+            self.assertAlmostEqual(pnt.z, 0.0)
+
+    def testProjectAgainstDirection(self):
+        # the mesh lies behind the polygon, so nothing is hit
+        lines = MeshPart.projectShapeOnMesh([self.polygon], self.mesh, FreeCAD.Vector(0, 0, 1))
+        self.assertEqual(len(lines), 1)
+        self.assertEqual(len(lines[0]), 0)
+
+    def testProjectWithMaxDistance(self):
+        import Part
+        edge = Part.makeLine(FreeCAD.Vector(1, 2, 0.1), FreeCAD.Vector(8, 3, 0.1))
+        lines = MeshPart.projectShapeOnMesh(edge, self.mesh, 1.0)
+        self.assertEqual(len(lines), 1)
+        for pnt in lines[0]:
+            self.assertAlmostEqual(pnt.z, 0.0)
+        # the cut with the common edge of the triangles
+        diagonal = [pnt for pnt in lines[0] if abs(pnt.x - pnt.y) < 1e-5]
+        self.assertEqual(len(diagonal), 1)
+        self.assertAlmostEqual(diagonal[0].x, 13.0 / 6.0, 4)
@@ -24,3 +24,6 @@
 #*                                                                         *
 #*   Juergen Riegel 2002                                                   *
 #***************************************************************************/
+
+
+FreeCAD.__unit_test__ += [ "MeshPartTestsApp" ]
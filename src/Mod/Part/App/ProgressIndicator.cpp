@@ -52,11 +52,16 @@ using namespace Part;
 
   pi->EndScope();
   \endcode
+
+  If another operation already runs the sequencer, e.g. a document recompute,
+  the indicator doesn't report its progress but still lets the algorithm
+  check for a user break.
  */
 
 ProgressIndicator::ProgressIndicator (int theMaxVal)
-  : myProgress(new Base::SequencerLauncher("", theMaxVal))
 {
+    if (!Base::Sequencer().isRunning())
+        myProgress.reset(new Base::SequencerLauncher("", theMaxVal));
     SetScale (0, theMaxVal, 1);
 }
 
@@ -66,6 +71,9 @@ ProgressIndicator::~ProgressIndicator ()
 
 Standard_Boolean ProgressIndicator::Show (const Standard_Boolean theForce)
 {
+    if (!myProgress)
+        return Standard_True;
+
     if (theForce) {
         Handle(TCollection_HAsciiString) aName = GetScope(1).GetName(); //current step
         if (!aName.IsNull())
@@ -81,5 +89,5 @@ Standard_Boolean ProgressIndicator::Show (const Standard_Boolean theForce)
 
 Standard_Boolean ProgressIndicator::UserBreak()
 {
-    return myProgress->wasCanceled();
+    return Base::Sequencer().wasCanceled();
 }
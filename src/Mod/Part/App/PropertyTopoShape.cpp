@@ -215,6 +215,17 @@ App::Property *PropertyPartShape::Copy(void) const
     return prop;
 }
 
+App::Property *PropertyPartShape::copyForTransaction(void) const
+{
+    // The topology is shared like in Paste(). A transaction only pastes the
+    // shape back, and modeling operations build new shapes instead of
+    // changing the referenced ones.
+    PropertyPartShape *prop = new PropertyPartShape();
+    prop->_Shape = this->_Shape;
+
+    return prop;
+}
+
 void PropertyPartShape::Paste(const App::Property &from)
 {
     aboutToSetValue();
@@ -227,6 +238,19 @@ unsigned int PropertyPartShape::getMemSize (void) const
     return _Shape.getMemSize();
 }
 
+unsigned int PropertyPartShape::getUnsharedMemSize (void) const
+{
+    // Counts the shape only if deleting this property frees it, i.e. no other
+    // shape references its TShape. This is not an estimate of sharing between
+    // properties: any other holder, e.g. a copy made for undo, the live
+    // property or a sub-shape kept by another feature, counts the same way.
+    // Sub-shapes of an unshared TShape may still be shared and are counted.
+    const TopoDS_Shape& shape = _Shape.getShape();
+    if (!shape.IsNull() && shape.TShape()->GetRefCount() > 1)
+        return 0;
+    return _Shape.getMemSize();
+}
+
 void PropertyPartShape::getPaths(std::vector<App::ObjectIdentifier> &paths) const
 {
     paths.push_back(App::ObjectIdentifier(getContainer()) << App::ObjectIdentifier::Component::SimpleComponent(getName())
@@ -84,8 +84,12 @@ public:
     void RestoreDocFile(Base::Reader &reader);
 
     App::Property *Copy(void) const;
+    /// Returns a copy that shares the topology, it's only used for undo/redo
+    App::Property *copyForTransaction(void) const;
     void Paste(const App::Property &from);
     unsigned int getMemSize (void) const;
+    /// Returns the size of the shape unless its TShape is also referenced elsewhere
+    unsigned int getUnsharedMemSize(void) const;
     //@}
 
     /// Get valid paths for this property; used by auto completer
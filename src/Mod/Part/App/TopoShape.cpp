@@ -1701,6 +1701,25 @@ bool TopoShape::isClosed() const
     return closed;
 }
 
+// Let the user break lengthy Boolean operations, e.g. while the document is
+// recomputed on a worker thread, see Part::ProgressIndicator
+template<class Algo>
+static void setUserBreak(Algo &mk)
+{
+#if OCC_VERSION_HEX >= 0x070200 && OCC_VERSION_HEX < 0x070500
+    Handle(Message_ProgressIndicator) pi = new ProgressIndicator(100);
+    mk.SetProgressIndicator(pi);
+#else
+    (void)mk;
+#endif
+}
+
+static void checkUserBreak()
+{
+    if (Base::Sequencer().wasCanceled())
+        throw Base::AbortException("Boolean operation aborted by user");
+}
+
 TopoDS_Shape TopoShape::cut(TopoDS_Shape shape) const
 {
     if (this->_Shape.IsNull())
@@ -1738,7 +1757,9 @@ TopoDS_Shape TopoShape::cut(const std::vector<TopoDS_Shape>& shapes, Standard_Re
     mkCut.SetTools(shapeTools);
     if (tolerance > 0.0)
         mkCut.SetFuzzyValue(tolerance);
+    setUserBreak(mkCut);
     mkCut.Build();
+    checkUserBreak();
     if (!mkCut.IsDone())
         throw Base::RuntimeError("Multi cut failed");
 
@@ -1784,7 +1805,9 @@ TopoDS_Shape TopoShape::common(const std::vector<TopoDS_Shape>& shapes, Standard
     mkCommon.SetTools(shapeTools);
     if (tolerance > 0.0)
         mkCommon.SetFuzzyValue(tolerance);
+    setUserBreak(mkCommon);
     mkCommon.Build();
+    checkUserBreak();
     if (!mkCommon.IsDone())
         throw Base::RuntimeError("Multi common failed");
 
@@ -1843,7 +1866,9 @@ TopoDS_Shape TopoShape::fuse(const std::vector<TopoDS_Shape>& shapes, Standard_R
     mkFuse.SetTools(shapeTools);
     if (tolerance > 0.0)
         mkFuse.SetFuzzyValue(tolerance);
+    setUserBreak(mkFuse);
     mkFuse.Build();
+    checkUserBreak();
     if (!mkFuse.IsDone())
         throw Base::RuntimeError("Multi fuse failed");
 
@@ -1918,7 +1943,9 @@ TopoDS_Shape TopoShape::section(const std::vector<TopoDS_Shape>& shapes,
     mkSection.SetTools(shapeTools);
     if (tolerance > 0.0)
         mkSection.SetFuzzyValue(tolerance);
+    setUserBreak(mkSection);
     mkSection.Build();
+    checkUserBreak();
     if (!mkSection.IsDone())
         throw Base::RuntimeError("Multi section failed");
 
@@ -1987,7 +2014,9 @@ TopoDS_Shape TopoShape::generalFuse(const std::vector<TopoDS_Shape> &sOthers, St
 #if OCC_VERSION_HEX >= 0x070000
     mkGFA.SetNonDestructive(Standard_True);
 #endif
+    setUserBreak(mkGFA);
     mkGFA.Build();
+    checkUserBreak();
     if (!mkGFA.IsDone())
         throw BooleanException("MultiFusion failed");
     TopoDS_Shape resShape = mkGFA.Shape();
@@ -30,8 +30,10 @@
 
 #ifndef _PreComp_
 # include <float.h>
+# include <cmath>
 # include <algorithm>
 # include <map>
+# include <unordered_map>
 # include <Python.h>
 # include <Inventor/SoPickedPoint.h>
 # include <Inventor/SoPrimitiveVertex.h>
@@ -55,10 +57,18 @@
 # include <Inventor/errors/SoReadError.h>
 # include <Inventor/details/SoFaceDetail.h>
 # include <Inventor/details/SoLineDetail.h>
+# include <Inventor/details/SoPointDetail.h>
+# include <Inventor/SbBox3f.h>
+# include <Inventor/SbLine.h>
+# include <Inventor/elements/SoModelMatrixElement.h>
+# include <Inventor/elements/SoViewVolumeElement.h>
+# include <Inventor/elements/SoViewportRegionElement.h>
+# include <Inventor/actions/SoRayPickAction.h>
 # include <Inventor/misc/SoState.h>
 # include <Inventor/misc/SoContextHandler.h>
 # include <Inventor/elements/SoShapeStyleElement.h>
 # include <Inventor/elements/SoCacheElement.h>
+# include <Inventor/elements/SoPickStyleElement.h>
 # include <Inventor/elements/SoTextureEnabledElement.h>
 # ifdef FC_OS_WIN32
 #  include <windows.h>
@@ -138,6 +148,15 @@ public:
                 const int mbind,
                 SbBool texture);
 
+    // make the buffers reload their content on the next render
+    void invalidate()
+    {
+        for (auto &v : vbomap) {
+            v.second.updateVbo = true;
+            v.second.vboLoaded = false;
+        }
+    }
+
     static void context_destruction_cb(uint32_t context, void * userdata)
     {
         VBO * self = static_cast<VBO*>(userdata);
@@ -165,11 +184,357 @@ public:
 
 SbBool SoBrepFaceSet::VBO::vboAvailable = false;
 
+// Picking by SoShape::rayPick() runs generatePrimitives() and tests every
+// single triangle. For preselection this happens on each mouse move, so
+// the triangles are sorted into a bounding volume hierarchy which is built
+// on the first pick and kept until the node or its coordinates change.
+class SoBrepFaceSet::PickBVH {
+public:
+    struct Node {
+        SbBox3f box;
+        int first; // first triangle in 'triangles' for leaves, left child otherwise
+        int count; // number of triangles for leaves, 0 for inner nodes
+    };
+
+    std::vector<Node> nodes;
+    std::vector<int32_t> triangles; // triangle indices sorted by node, invalid ones left out
+    std::vector<int32_t> parts;     // part index of each triangle, by triangle index
+    uint32_t nodeId = 0;
+    uint32_t coordId = 0;
+
+    static const int LeafSize = 8;
+
+    bool isValid(uint32_t node, uint32_t coords) const {
+        return !nodes.empty() && nodeId == node && coordId == coords;
+    }
+
+    void build(const SoCoordinateElement *coords, const int32_t *cindices, int numindices,
+               const int32_t *pindices, int numparts)
+    {
+        nodes.clear();
+        triangles.clear();
+        parts.clear();
+
+        int numtria = numindices / 4;
+        int numcoords = coords->getNum();
+        // indexed by triangle, entries of skipped triangles stay unused
+        std::vector<SbVec3f> centers(numtria);
+        std::vector<SbBox3f> boxes(numtria);
+        triangles.reserve(numtria);
+        for (int i=0; i<numtria; i++) {
+            const int32_t *tria = cindices + 4*i;
+            SbBox3f box;
+            bool valid = true;
+            for (int j=0; j<3; j++) {
+                if (tria[j] < 0 || tria[j] >= numcoords) {
+                    valid = false;
+                    break;
+                }
+                box.extendBy(coords->get3(tria[j]));
+            }
+            if (!valid)
+                continue;
+            boxes[i] = box;
+            centers[i] = box.getCenter();
+            triangles.push_back(i);
+        }
+
+        parts.resize(numtria, -1);
+        int tria = 0;
+        for (int i=0; i<numparts && tria<numtria; i++) {
+            for (int j=0; j<pindices[i] && tria<numtria; j++)
+                parts[tria++] = i;
+        }
+
+        numtria = static_cast<int>(triangles.size());
+        if (numtria == 0)
+            return;
+        nodes.reserve(2*(numtria/LeafSize+1));
+        nodes.push_back(Node());
+        split(0, 0, numtria, boxes, centers);
+    }
+
+    template<class Func>
+    void traverse(const SbLine &line, Func func) const {
+        if (nodes.empty())
+            return;
+        const SbVec3f &pos = line.getPosition();
+        const SbVec3f &dir = line.getDirection();
+        SbVec3f inv;
+        for (int i=0; i<3; i++)
+            inv[i] = dir[i] != 0.0f ? 1.0f/dir[i] : FLT_MAX;
+
+        // the median split keeps the tree balanced, but don't rely on it
+        std::vector<int> stack;
+        stack.reserve(64);
+        stack.push_back(0);
+        while (!stack.empty()) {
+            const Node &node = nodes[stack.back()];
+            stack.pop_back();
+            if (!hitBox(node.box, pos, inv))
+                continue;
+            if (node.count > 0) {
+                for (int i=node.first; i<node.first+node.count; i++)
+                    func(triangles[i]);
+            }
+            else {
+                stack.push_back(node.first);
+                stack.push_back(node.first+1);
+            }
+        }
+    }
+
+private:
+    void split(int index, int first, int count,
+               const std::vector<SbBox3f> &boxes, const std::vector<SbVec3f> &centers)
+    {
+        SbBox3f box;
+        for (int i=first; i<first+count; i++)
+            box.extendBy(boxes[triangles[i]]);
+        nodes[index].box = box;
+
+        if (count <= LeafSize) {
+            nodes[index].first = first;
+            nodes[index].count = count;
+            return;
+        }
+
+        // split at the median of the longest axis
+        float dx, dy, dz;
+        box.getSize(dx, dy, dz);
+        int axis = (dx >= dy && dx >= dz) ? 0 : (dy >= dz ? 1 : 2);
+        int half = count / 2;
+        std::nth_element(triangles.begin()+first, triangles.begin()+first+half,
+                         triangles.begin()+first+count,
+                         [&](int32_t a, int32_t b) {
+                             return centers[a][axis] < centers[b][axis];
+                         });
+
+        int left = static_cast<int>(nodes.size());
+        nodes.push_back(Node());
+        nodes.push_back(Node());
+        nodes[index].first = left;
+        nodes[index].count = 0;
+        split(left, first, half, boxes, centers);
+        split(left+1, first+half, count-half, boxes, centers);
+    }
+
+    static bool hitBox(const SbBox3f &box, const SbVec3f &pos, const SbVec3f &inv) {
+        // slab test against the infinite line, the pick action checks
+        // the near and far plane of the intersection itself
+        float tmin = -FLT_MAX;
+        float tmax = FLT_MAX;
+        const SbVec3f &bmin = box.getMin();
+        const SbVec3f &bmax = box.getMax();
+        for (int i=0; i<3; i++) {
+            if (inv[i] == FLT_MAX) {
+                if (pos[i] < bmin[i] || pos[i] > bmax[i])
+                    return false;
+                continue;
+            }
+            float t1 = (bmin[i]-pos[i])*inv[i];
+            float t2 = (bmax[i]-pos[i])*inv[i];
+            if (t1 > t2)
+                std::swap(t1, t2);
+            tmin = std::max(tmin, t1);
+            tmax = std::min(tmax, t2);
+            if (tmin > tmax)
+                return false;
+        }
+        return true;
+    }
+};
+
 void SoBrepFaceSet::initClass()
 {
     SO_NODE_INIT_CLASS(SoBrepFaceSet, SoIndexedFaceSet, "IndexedFaceSet");
 }
 
+// Large shapes are rendered with all their triangles even if they are far
+// away. For shapes with many triangles a coarser triangulation is derived
+// from the full one by clustering the vertices on a grid. Each remaining
+// triangle stays in its part, so partIndex keeps its meaning on every level. The levels are
+// built on first use and dropped when the node or its coordinates change.
+// Picking, selection and highlighting always use the full triangulation.
+//
+// The level depends on the camera, which must not leak into render caches:
+// a cache recording the view volume would never be hit again. Inside an
+// open cache the full triangulation is rendered. Otherwise the level is
+// chosen and auto caching is turned off for the shape, so that the level
+// keeps following the camera.
+class SoBrepFaceSet::LOD {
+public:
+    struct Level {
+        int resolution;     // number of grid cells along the bounding box diagonal
+        float maxPixels;    // use this level if the shape is smaller on screen
+        bool built;
+        bool usable;
+        std::vector<int32_t> coordIndex;
+        std::vector<int32_t> partIndex;
+        std::unique_ptr<VBO> vbo;
+    };
+
+    static const int MinTriangles = 4096;
+
+    Level levels[2];
+    SbBox3f bbox;
+    uint32_t nodeId = 0;
+    uint32_t coordId = 0;
+
+    LOD() {
+        levels[0].resolution = 16;
+        levels[0].maxPixels = 48.0f;
+        levels[1].resolution = 64;
+        levels[1].maxPixels = 192.0f;
+        reset();
+    }
+
+    void reset() {
+        for (auto &level : levels) {
+            level.built = false;
+            level.usable = false;
+            level.coordIndex.clear();
+            level.partIndex.clear();
+            level.vbo.reset();
+        }
+        bbox.makeEmpty();
+    }
+
+    void invalidateVbo() {
+        for (auto &level : levels) {
+            if (level.vbo)
+                level.vbo->invalidate();
+        }
+    }
+
+    Level *select(SoState *state, const SoCoordinateElement *coords, uint32_t id,
+                        const int32_t *cindices, int numindices,
+                        const int32_t *pindices, int numparts)
+    {
+        if (numindices/4 < MinTriangles || numparts <= 0)
+            return nullptr;
+        if (SoCacheElement::anyOpen(state))
+            return nullptr;
+        SoGLCacheContextElement::shouldAutoCache(state, SoGLCacheContextElement::DONT_AUTO_CACHE);
+
+        if (nodeId != id || coordId != coords->getNodeId()) {
+            reset();
+            nodeId = id;
+            coordId = coords->getNodeId();
+            int numcoords = coords->getNum();
+            for (int i=0; i<numindices; i++) {
+                if (cindices[i] >= 0 && cindices[i] < numcoords)
+                    bbox.extendBy(coords->get3(cindices[i]));
+            }
+        }
+        if (bbox.isEmpty())
+            return nullptr;
+
+        float pixels = screenSize(state);
+        for (auto &level : levels) {
+            if (pixels >= level.maxPixels)
+                continue;
+            if (!level.built)
+                build(level, coords, cindices, numindices, pindices, numparts);
+            if (level.usable)
+                return &level;
+        }
+        return nullptr;
+    }
+
+private:
+    float screenSize(SoState *state) const {
+        const SbViewVolume &vv = SoViewVolumeElement::get(state);
+        const SbMatrix &mm = SoModelMatrixElement::get(state);
+        const SbViewportRegion &vp = SoViewportRegionElement::get(state);
+        SbVec2s size = vp.getViewportSizePixels();
+
+        const SbVec3f &bmin = bbox.getMin();
+        const SbVec3f &bmax = bbox.getMax();
+        float minx = FLT_MAX, miny = FLT_MAX, maxx = -FLT_MAX, maxy = -FLT_MAX;
+        for (int i=0; i<8; i++) {
+            SbVec3f corner(i&1 ? bmax[0] : bmin[0],
+                           i&2 ? bmax[1] : bmin[1],
+                           i&4 ? bmax[2] : bmin[2]);
+            SbVec3f world, screen;
+            mm.multVecMatrix(corner, world);
+            vv.projectToScreen(world, screen);
+            // partly behind the camera or beyond the far plane
+            if (screen[2] < 0.0f || screen[2] > 1.0f)
+                return FLT_MAX;
+            minx = std::min(minx, screen[0]);
+            maxx = std::max(maxx, screen[0]);
+            miny = std::min(miny, screen[1]);
+            maxy = std::max(maxy, screen[1]);
+        }
+        return std::max((maxx-minx)*size[0], (maxy-miny)*size[1]);
+    }
+
+    void build(Level &level, const SoCoordinateElement *coords,
+               const int32_t *cindices, int numindices,
+               const int32_t *pindices, int numparts)
+    {
+        level.built = true;
+        level.coordIndex.clear();
+        level.partIndex.assign(numparts, 0);
+
+        float dx, dy, dz;
+        bbox.getSize(dx, dy, dz);
+        float cell = std::sqrt(dx*dx + dy*dy + dz*dz) / level.resolution;
+        if (cell <= 0.0f)
+            return;
+        const SbVec3f &bmin = bbox.getMin();
+        uint64_t cells = static_cast<uint64_t>(level.resolution) + 1;
+
+        // the first vertex falling into a cell represents all others of it
+        int numcoords = coords->getNum();
+        std::vector<int32_t> remap(numcoords, -1);
+        std::unordered_map<uint64_t, int32_t> representative;
+        auto cluster = [&](int32_t index) -> int32_t {
+            if (remap[index] < 0) {
+                SbVec3f p = coords->get3(index) - bmin;
+                uint64_t key = (static_cast<uint64_t>(p[0]/cell) * cells
+                              + static_cast<uint64_t>(p[1]/cell)) * cells
+                              + static_cast<uint64_t>(p[2]/cell);
+                remap[index] = representative.emplace(key, index).first->second;
+            }
+            return remap[index];
+        };
+
+        int numtria = numindices / 4;
+        int tria = 0;
+        for (int part=0; part<numparts && tria<numtria; part++) {
+            for (int j=0; j<pindices[part] && tria<numtria; j++, tria++) {
+                const int32_t *vi = cindices + 4*tria;
+                if (vi[0] < 0 || vi[1] < 0 || vi[2] < 0 ||
+                    vi[0] >= numcoords || vi[1] >= numcoords || vi[2] >= numcoords)
+                    continue;
+                int32_t v0 = cluster(vi[0]);
+                int32_t v1 = cluster(vi[1]);
+                int32_t v2 = cluster(vi[2]);
+                if (v0 == v1 || v1 == v2 || v2 == v0)
+                    continue;
+                level.coordIndex.push_back(v0);
+                level.coordIndex.push_back(v1);
+                level.coordIndex.push_back(v2);
+                level.coordIndex.push_back(-1);
+                level.partIndex[part]++;
+            }
+        }
+
+        // only worth it if it saves a good amount of triangles
+        std::size_t count = level.coordIndex.size() / 4;
+        level.usable = count > 0 && count * 2 < static_cast<std::size_t>(numtria);
+        if (!level.usable) {
+            level.coordIndex.clear();
+            level.partIndex.clear();
+        }
+        else {
+            level.vbo.reset(new VBO);
+        }
+    }
+};
+
 SoBrepFaceSet::SoBrepFaceSet()
 {
     SO_NODE_CONSTRUCTOR(SoBrepFaceSet);
@@ -180,6 +545,8 @@ SoBrepFaceSet::SoBrepFaceSet()
     packedColor = 0;
 
     pimpl.reset(new VBO);
+    pickBVH.reset(new PickBVH);
+    lod.reset(new LOD);
 }
 
 SoBrepFaceSet::~SoBrepFaceSet()
@@ -342,10 +709,8 @@ void SoBrepFaceSet::doAction(SoAction* action)
     // but the base class made this method private so that we can't override it.
     // So, the alternative way is to write a custom SoAction class.
     else if (action->getTypeId() == Gui::SoUpdateVBOAction::getClassTypeId()) {
-        for(auto &v : PRIVATE(this)->vbomap) {
-            v.second.updateVbo = true;
-            v.second.vboLoaded = false;
-        }
+        PRIVATE(this)->invalidate();
+        lod->invalidateVbo();
     }
 
     inherited::doAction(action);
@@ -662,8 +1027,27 @@ void SoBrepFaceSet::GLRender(SoGLRenderAction *action)
             //    this->startVertexArray(action, coords, normals, false, false);
             //}
         }
-        renderShape(action, hasVBO, static_cast<const SoGLCoordinateElement*>(coords), cindices, numindices,
-            pindices, numparts, normals, nindices, &mb, mindices, &tb, tindices, nbind, mbind, doTextures?1:0);
+        // Use a coarser level of detail if the shape is small on screen. Only
+        // bindings that don't depend on the position in coordIndex are supported.
+        LOD::Level *level = nullptr;
+        if (!ctx2 && !doTextures && !normalCacheUsed && nindices == cindices &&
+            (nbind == OVERALL || nbind == PER_VERTEX_INDEXED) &&
+            (mbind == OVERALL || mbind == PER_PART || mbind == PER_PART_INDEXED))
+        {
+            level = lod->select(state, coords, this->getNodeId(), cindices, numindices, pindices, numparts);
+        }
+
+        if (level) {
+            const int32_t *lodindices = level->coordIndex.data();
+            renderShape(action, hasVBO, static_cast<const SoGLCoordinateElement*>(coords),
+                lodindices, static_cast<int>(level->coordIndex.size()),
+                level->partIndex.data(), numparts, normals, lodindices, &mb, mindices, &tb, tindices,
+                nbind, mbind, 0, level->vbo.get());
+        }
+        else {
+            renderShape(action, hasVBO, static_cast<const SoGLCoordinateElement*>(coords), cindices, numindices,
+                pindices, numparts, normals, nindices, &mb, mindices, &tb, tindices, nbind, mbind, doTextures?1:0);
+        }
 
         // if (!hasVBO) {
         //     // Disable caching for this node
@@ -1737,7 +2121,8 @@ void SoBrepFaceSet::renderShape(SoGLRenderAction * action,
                                 const int32_t *texindices,
                                 const int nbind,
                                 const int mbind,
-                                SbBool texture)
+                                SbBool texture,
+                                VBO *vbo)
 {
     // Can we use vertex buffer objects?
     if (hasVBO) {
@@ -1747,7 +2132,9 @@ void SoBrepFaceSet::renderShape(SoGLRenderAction * action,
             // if no shading is set then the normals are all equal
             nbinding = static_cast<int>(OVERALL);
         }
-        PRIVATE(this)->render(action, vertexlist, vertexindices, num_indices, partindices, num_partindices, normals,
+        if (!vbo)
+            vbo = PRIVATE(this).get();
+        vbo->render(action, vertexlist, vertexindices, num_indices, partindices, num_partindices, normals,
                     normalindices, materials, matindices, texcoords, texindices, nbinding, mbind, texture);
         return;
     }
@@ -1904,6 +2291,62 @@ void SoBrepFaceSet::renderShape(SoGLRenderAction * action,
     glEnd();
 }
 
+void SoBrepFaceSet::rayPick(SoRayPickAction * action)
+{
+    if (!this->shouldRayPick(action))
+        return;
+
+    // Vertex property nodes are not used by the Part view providers. Leave them
+    // and picking by bounding box to the generic implementation.
+    SoState * state = action->getState();
+    if (this->vertexProperty.getValue() || this->coordIndex.getNum() < 3 ||
+        SoPickStyleElement::get(state) == SoPickStyleElement::BOUNDING_BOX) {
+        inherited::rayPick(action);
+        return;
+    }
+
+    const SoCoordinateElement * coords = SoCoordinateElement::getInstance(state);
+    if (!pickBVH->isValid(this->getNodeId(), coords->getNodeId())) {
+        pickBVH->build(coords, this->coordIndex.getValues(0), this->coordIndex.getNum(),
+                       this->partIndex.getValues(0), this->partIndex.getNum());
+        pickBVH->nodeId = this->getNodeId();
+        pickBVH->coordId = coords->getNodeId();
+    }
+
+    this->computeObjectSpaceRay(action);
+
+    const int32_t * cindices = this->coordIndex.getValues(0);
+    const std::vector<int32_t> &parts = pickBVH->parts;
+    pickBVH->traverse(action->getLine(), [&](int32_t tria) {
+        const int32_t * vi = cindices + 4*tria;
+        SbVec3f v0 = coords->get3(vi[0]);
+        SbVec3f v1 = coords->get3(vi[1]);
+        SbVec3f v2 = coords->get3(vi[2]);
+        SbVec3f isect, bary;
+        SbBool front;
+        if (!action->intersect(v0, v1, v2, isect, bary, front) || !action->isBetweenPlanes(isect))
+            return;
+        SoPickedPoint * pp = action->addIntersection(isect);
+        if (!pp)
+            return;
+
+        SbVec3f normal = (v1-v0).cross(v2-v0);
+        normal.normalize();
+        pp->setObjectNormal(normal);
+
+        SoFaceDetail * detail = new SoFaceDetail;
+        detail->setFaceIndex(tria);
+        detail->setPartIndex(parts[tria]);
+        detail->setNumPoints(3);
+        SoPointDetail pointDetail;
+        for (int i=0; i<3; i++) {
+            pointDetail.setCoordinateIndex(vi[i]);
+            detail->setPoint(i, &pointDetail);
+        }
+        pp->setDetail(detail, this);
+    });
+}
+
 SoDetail * SoBrepFaceSet::createTriangleDetail(SoRayPickAction * action,
                                                const SoPrimitiveVertex * v1,
                                                const SoPrimitiveVertex * v2,
@@ -99,6 +99,7 @@ protected:
         SoPickedPoint * pp);
     virtual void generatePrimitives(SoAction * action);
     virtual void getBoundingBox(SoGetBoundingBoxAction * action);
+    virtual void rayPick(SoRayPickAction * action);
 
 private:
     enum Binding {
@@ -113,6 +114,11 @@ private:
     };
     Binding findMaterialBinding(SoState * const state) const;
     Binding findNormalBinding(SoState * const state) const;
+
+    // Vertex buffer objects of a triangulation, per GL context
+    class VBO;
+
+    /// Renders the triangles, with \a vbo instead of the node's own VBO if given
     void renderShape(SoGLRenderAction * action,
                      SbBool hasVBO,
                      const SoGLCoordinateElement * const vertexlist,
@@ -128,7 +134,8 @@ private:
                      const int32_t *texindices,
                      const int nbind,
                      const int mbind,
-                     SbBool texture);
+                     SbBool texture,
+                     VBO *vbo=nullptr);
 
     typedef Gui::SoFCSelectionContextEx SelContext;
     typedef Gui::SoFCSelectionContextExPtr SelContextPtr;
@@ -156,8 +163,15 @@ private:
     Gui::SoFCSelectionCounter selCounter;
 
     // Define some VBO pointer for the current mesh
-    class VBO;
     std::unique_ptr<VBO> pimpl;
+
+    // Bounding volume hierarchy over the triangles, used for picking
+    class PickBVH;
+    std::unique_ptr<PickBVH> pickBVH;
+
+    // Coarser triangulations used when the shape covers only a few pixels
+    class LOD;
+    std::unique_ptr<LOD> lod;
 };
 
 } // namespace PartGui
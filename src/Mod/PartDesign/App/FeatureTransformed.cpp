@@ -30,10 +30,14 @@
 # include <TopExp.hxx>
 # include <TopExp_Explorer.hxx>
 # include <TopTools_IndexedMapOfShape.hxx>
+# include <TopTools_ListOfShape.hxx>
 # include <Precision.hxx>
 # include <BRepBuilderAPI_Copy.hxx>
 # include <BRepBndLib.hxx>
+# include <BRepExtrema_DistShapeShape.hxx>
 # include <Bnd_Box.hxx>
+# include <Standard_Version.hxx>
+# include <algorithm>
 #endif
 
 
@@ -57,6 +61,10 @@ using namespace PartDesign;
 
 namespace PartDesign {
 
+// Below this number of additive instances, checking each one against the
+// support before batching costs more than the batched fuse saves
+static const std::size_t BatchFuseMinInstances = 8;
+
 PROPERTY_SOURCE(PartDesign::Transformed, PartDesign::Feature)
 
 Transformed::Transformed()
@@ -278,76 +286,54 @@ App::DocumentObjectExecReturn *Transformed::execute(void)
         }
 
         // Transform the add/subshape and collect the resulting shapes for overlap testing
-        /*typedef std::vector<std::vector<gp_Trsf>::const_iterator> trsf_it_vec;
+        typedef std::vector<std::vector<gp_Trsf>::const_iterator> trsf_it_vec;
         trsf_it_vec v_transformations;
-        std::vector<TopoDS_Shape> v_transformedShapes;*/
+        std::vector<TopoDS_Shape> v_fuseShapes;
+        std::vector<TopoDS_Shape> v_cutShapes;
 
         std::vector<gp_Trsf>::const_iterator t = transformations.begin();
         ++t; // Skip first transformation, which is always the identity transformation
         for (; t != transformations.end(); ++t) {
-            // Make an explicit copy of the shape because the "true" parameter to BRepBuilderAPI_Transform
-            // seems to be pretty broken
-            BRepBuilderAPI_Copy copy(fuseShape.isNull()?cutShape.getShape():fuseShape.getShape());
-            shape = copy.Shape();
-            if (shape.IsNull())
-                return new App::DocumentObjectExecReturn("Transformed: Linked shape object is empty");
-
-            BRepBuilderAPI_Transform mkTrf(shape, *t, false); // No need to copy, now
-            if (!mkTrf.IsDone())
-                return new App::DocumentObjectExecReturn("Transformation failed", (*o));
-
-            shape = mkTrf.Shape();
-            try {
-                // Intersection checking for additive shape is redundant.
-                // Because according to CheckIntersection() source code, it is
-                // implemented using fusion and counting of the resulting
-                // solid, which will be done in the following modeling step
-                // anyway.
-                //
-                // There is little reason for doing intersection checking on
-                // subtractive shape either, because it does not produce
-                // multiple solids.
-                //
-                // if (!Part::checkIntersection(support, mkTrf.Shape(), false, true)) {
-
+            v_transformations.push_back(t);
+            if (!fuseShape.isNull()) {
+                shape = transformShape(fuseShape.getShape(), *t);
+                if (shape.IsNull())
+                    return new App::DocumentObjectExecReturn("Transformation failed", (*o));
+                v_fuseShapes.push_back(shape);
+            }
+            if (!cutShape.isNull()) {
+                shape = transformShape(cutShape.getShape(), *t);
+                if (shape.IsNull())
+                    return new App::DocumentObjectExecReturn("Transformation failed", (*o));
+                v_cutShapes.push_back(shape);
+            }
+        }
 
+        // Fuse and/or cut the given transformed shapes one at a time. This is the slow path
+        // but it allows to find out which transformations don't intersect the support.
+        auto processSequentially = [&](const std::vector<std::size_t>& indices) -> App::DocumentObjectExecReturn* {
+            for (std::vector<std::size_t>::const_iterator it = indices.begin(); it != indices.end(); ++it) {
                 TopoDS_Shape current = support;
 
                 if (!fuseShape.isNull()) {
                     // We cannot wait to fuse a transformation with the support until all the transformations are done,
                     // because the "support" potentially changes with every transformation, basically when checking intersection
-                    // above you need:
+                    // you need:
                     // 1. The original support
                     // 2. Any extra support gained by any previous transformation of any previous feature (multi-feature transform)
                     // 3. Any extra support gained by any previous transformation of this feature (feature multi-trasform)
                     //
                     // Therefore, if the transformation succeeded, then we fuse it with the support now, before checking the intersection
                     // of the next transformation.
-                    
-                    /*v_transformations.push_back(t);
-                    v_transformedShapes.push_back(mkTrf.Shape());*/
-    
-                    // Note: Transformations that do not intersect the support are ignored in the overlap tests
-                    
-                    //insert scheme here.
-                    /*TopoDS_Compound compoundTool;
-                    std::vector<TopoDS_Shape> individualTools;
-                    divideTools(v_transformedShapes, individualTools, compoundTool);*/
-                    
-                    // Fuse/Cut the compounded transformed shapes with the support
-                    //TopoDS_Shape result;
-
-                    BRepAlgoAPI_Fuse mkFuse(current, shape);
+                    BRepAlgoAPI_Fuse mkFuse(current, v_fuseShapes[*it]);
                     if (!mkFuse.IsDone())
                         return new App::DocumentObjectExecReturn("Fusion with support failed", *o);
 
-                    if(Part::TopoShape(current).countSubShapes(TopAbs_SOLID)
-                            != Part::TopoShape(mkFuse.Shape()).countSubShapes(TopAbs_SOLID))
-                    {
+                    if (countSolids(current) != countSolids(mkFuse.Shape())) {
 #ifdef FC_DEBUG // do not write this in release mode because a message appears already in the task view
                         Base::Console().Warning("Transformed shape does not intersect support %s: Removed\n", (*o)->getNameInDocument());
 #endif
-                        nointersect_trsfms[*o].insert(t);
+                        nointersect_trsfms[*o].insert(v_transformations[*it]);
                         continue;
                     }
                     // we have to get the solids (fuse sometimes creates compounds)
@@ -355,35 +341,110 @@ App::DocumentObjectExecReturn *Transformed::execute(void)
                     // lets check if the result is a solid
                     if (current.IsNull())
                         return new App::DocumentObjectExecReturn("Resulting shape is not a solid", *o);
-
-                    if (!cutShape.isNull()) {
-                        BRepBuilderAPI_Copy copy(cutShape.getShape());
-                        shape = copy.Shape();
-                        if (shape.IsNull())
-                            return new App::DocumentObjectExecReturn("Transformed: Linked shape object is empty");
-            
-                        BRepBuilderAPI_Transform mkTrf(shape, *t, false); // No need to copy, now
-                        if (!mkTrf.IsDone())
-                            return new App::DocumentObjectExecReturn("Transformation failed", (*o));
-                        shape = mkTrf.Shape();
-                    }
                 }
                 if (!cutShape.isNull()) {
-                    BRepAlgoAPI_Cut mkCut(current, shape);
+                    BRepAlgoAPI_Cut mkCut(current, v_cutShapes[*it]);
                     if (!mkCut.IsDone())
                         return new App::DocumentObjectExecReturn("Cut out of support failed", *o);
                     current = mkCut.Shape();
                 }
                 support = current; // Use result of this operation for fuse/cut of next original
-            } catch (Standard_Failure& e) {
-                // Note: Ignoring this failure is probably pointless because if the intersection check fails, the later
-                // fuse operation of the transformation result will also fail
-        
-                std::string msg("Transformation: Intersection check failed");
-                if (e.GetMessageString() != NULL)
-                    msg += std::string(": '") + e.GetMessageString() + "'";
-                return new App::DocumentObjectExecReturn(msg.c_str());
             }
+            return nullptr;
+        };
+
+        try {
+            // Intersection checking for additive shape is redundant.
+            // Because according to CheckIntersection() source code, it is
+            // implemented using fusion and counting of the resulting
+            // solid, which will be done in the following modeling step
+            // anyway.
+            //
+            // There is little reason for doing intersection checking on
+            // subtractive shape either, because it does not produce
+            // multiple solids.
+            App::DocumentObjectExecReturn* ret = nullptr;
+            if (!fuseShape.isNull() && (!cutShape.isNull() || v_fuseShapes.size() < BatchFuseMinInstances)) {
+                // Fusing and cutting of one transformation may affect the next one, so
+                // keep their order. Few additive instances are fused one by one, too.
+                std::vector<std::size_t> indices(v_transformations.size());
+                for (std::size_t i = 0; i < indices.size(); ++i)
+                    indices[i] = i;
+                ret = processSequentially(indices);
+            }
+            else if (!fuseShape.isNull()) {
+                // Only shapes that touch the support on their own are batched. The others
+                // are fused one by one afterwards, against the support grown by the batch,
+                // like the sequential path would do, and get rejected if they still miss it.
+                std::vector<std::size_t> candidates, deferred;
+                std::vector<TopoDS_Shape> candidateShapes;
+                Bnd_Box supportBound;
+                BRepBndLib::Add(support, supportBound);
+                supportBound.SetGap(Precision::Confusion());
+                for (std::size_t i = 0; i < v_fuseShapes.size(); ++i) {
+                    if (touchesSupport(support, supportBound, v_fuseShapes[i])) {
+                        candidates.push_back(i);
+                        candidateShapes.push_back(v_fuseShapes[i]);
+                    }
+                    else {
+                        deferred.push_back(i);
+                    }
+                }
+
+                // Broad phase: shapes whose bounding boxes don't overlap any other are fused
+                // all at once, shapes with overlapping bounding boxes group by group. If the
+                // solid count still changes the group is fused one by one.
+                std::vector<std::size_t> separated;
+                std::vector<std::vector<std::size_t> > overlapping;
+                divideTools(candidateShapes, separated, overlapping);
+                overlapping.insert(overlapping.begin(), separated);
+                for (std::vector<std::vector<std::size_t> >::iterator it = overlapping.begin(); it != overlapping.end(); ++it) {
+                    for (std::vector<std::size_t>::iterator jt = it->begin(); jt != it->end(); ++jt)
+                        *jt = candidates[*jt];
+                }
+
+                for (std::vector<std::vector<std::size_t> >::const_iterator it = overlapping.begin(); it != overlapping.end(); ++it) {
+                    if (it->empty())
+                        continue;
+                    if (it->size() > 1) {
+                        std::vector<TopoDS_Shape> tools;
+                        tools.reserve(it->size());
+                        for (std::vector<std::size_t>::const_iterator jt = it->begin(); jt != it->end(); ++jt)
+                            tools.push_back(v_fuseShapes[*jt]);
+                        TopoDS_Shape result = fuseTools(support, tools);
+                        if (!result.IsNull() && countSolids(support) == countSolids(result)) {
+                            TopoDS_Shape current = this->getSolid(result);
+                            if (current.IsNull())
+                                return new App::DocumentObjectExecReturn("Resulting shape is not a solid", *o);
+                            support = current;
+                            continue;
+                        }
+                    }
+                    ret = processSequentially(*it);
+                    if (ret)
+                        break;
+                }
+                if (!ret)
+                    ret = processSequentially(deferred);
+            }
+            else {
+                // Subtractive shapes never get rejected and the order of cutting doesn't matter
+                TopoDS_Shape result = cutTools(support, v_cutShapes);
+                if (result.IsNull())
+                    return new App::DocumentObjectExecReturn("Cut out of support failed", *o);
+                support = result;
+            }
+
+            if (ret)
+                return ret;
+        } catch (Standard_Failure& e) {
+            // Note: Ignoring this failure is probably pointless because if the intersection check fails, the later
+            // fuse operation of the transformation result will also fail
+
+            std::string msg("Transformation: Intersection check failed");
+            if (e.GetMessageString() != NULL)
+                msg += std::string(": '") + e.GetMessageString() + "'";
+            return new App::DocumentObjectExecReturn(msg.c_str());
         }
     }
     support = refineShapeIfActive(support);
@@ -422,57 +483,129 @@ TopoDS_Shape Transformed::refineShapeIfActive(const TopoDS_Shape& oldShape) cons
     return oldShape;
 }
 
-void Transformed::divideTools(const std::vector<TopoDS_Shape> &toolsIn, std::vector<TopoDS_Shape> &individualsOut,
-                              TopoDS_Compound &compoundOut) const
+TopoDS_Shape Transformed::transformShape(const TopoDS_Shape& shape, const gp_Trsf& trsf)
 {
-    typedef std::pair<TopoDS_Shape, Bnd_Box> ShapeBoundPair;
-    typedef std::list<ShapeBoundPair> PairList;
-    typedef std::vector<ShapeBoundPair> PairVector;
+    // Make an explicit copy of the shape because the "true" parameter to BRepBuilderAPI_Transform
+    // seems to be pretty broken
+    BRepBuilderAPI_Copy copy(shape);
+    TopoDS_Shape copied = copy.Shape();
+    if (copied.IsNull())
+        return TopoDS_Shape();
+
+    BRepBuilderAPI_Transform mkTrf(copied, trsf, false); // No need to copy, now
+    if (!mkTrf.IsDone())
+        return TopoDS_Shape();
+    return mkTrf.Shape();
+}
 
-    PairList pairList;
+bool Transformed::touchesSupport(const TopoDS_Shape& support, const Bnd_Box& supportBound, const TopoDS_Shape& tool)
+{
+    Bnd_Box bound;
+    BRepBndLib::Add(tool, bound);
+    if (supportBound.IsOut(bound))
+        return false;
+
+    // a tool inside the support is an inner solution of distance zero
+    BRepExtrema_DistShapeShape mkDist(support, tool);
+    return mkDist.IsDone() && mkDist.Value() <= Precision::Confusion();
+}
 
-    std::vector<TopoDS_Shape>::const_iterator it;
-    for (it = toolsIn.begin(); it != toolsIn.end(); ++it) {
+TopoDS_Shape Transformed::fuseTools(const TopoDS_Shape& support, const std::vector<TopoDS_Shape>& tools)
+{
+#if OCC_VERSION_HEX >= 0x060900
+    BRepAlgoAPI_Fuse mkFuse;
+    mkFuse.SetRunParallel(true);
+    TopTools_ListOfShape shapeArguments, shapeTools;
+    shapeArguments.Append(support);
+    for (std::vector<TopoDS_Shape>::const_iterator it = tools.begin(); it != tools.end(); ++it)
+        shapeTools.Append(*it);
+    mkFuse.SetArguments(shapeArguments);
+    mkFuse.SetTools(shapeTools);
+    mkFuse.Build();
+    if (!mkFuse.IsDone())
+        return TopoDS_Shape();
+    return mkFuse.Shape();
+#else
+    BRep_Builder builder;
+    TopoDS_Compound compound;
+    builder.MakeCompound(compound);
+    for (std::vector<TopoDS_Shape>::const_iterator it = tools.begin(); it != tools.end(); ++it)
+        builder.Add(compound, *it);
+    BRepAlgoAPI_Fuse mkFuse(support, compound);
+    if (!mkFuse.IsDone())
+        return TopoDS_Shape();
+    return mkFuse.Shape();
+#endif
+}
+
+TopoDS_Shape Transformed::cutTools(const TopoDS_Shape& support, const std::vector<TopoDS_Shape>& tools)
+{
+#if OCC_VERSION_HEX >= 0x060900
+    BRepAlgoAPI_Cut mkCut;
+    mkCut.SetRunParallel(true);
+    TopTools_ListOfShape shapeArguments, shapeTools;
+    shapeArguments.Append(support);
+    for (std::vector<TopoDS_Shape>::const_iterator it = tools.begin(); it != tools.end(); ++it)
+        shapeTools.Append(*it);
+    mkCut.SetArguments(shapeArguments);
+    mkCut.SetTools(shapeTools);
+    mkCut.Build();
+    if (!mkCut.IsDone())
+        return TopoDS_Shape();
+    return mkCut.Shape();
+#else
+    TopoDS_Shape current = support;
+    for (std::vector<TopoDS_Shape>::const_iterator it = tools.begin(); it != tools.end(); ++it) {
+        BRepAlgoAPI_Cut mkCut(current, *it);
+        if (!mkCut.IsDone())
+            return TopoDS_Shape();
+        current = mkCut.Shape();
+    }
+    return current;
+#endif
+}
+
+void Transformed::divideTools(const std::vector<TopoDS_Shape> &toolsIn, std::vector<std::size_t> &separatedOut,
+                              std::vector<std::vector<std::size_t> > &overlappingOut) const
+{
+    std::vector<Bnd_Box> bounds;
+    bounds.reserve(toolsIn.size());
+    for (std::vector<TopoDS_Shape>::const_iterator it = toolsIn.begin(); it != toolsIn.end(); ++it) {
         Bnd_Box bound;
         BRepBndLib::Add(*it, bound);
         bound.SetGap(0.0);
-        ShapeBoundPair temp = std::make_pair(*it, bound);
-        pairList.push_back(temp);
+        bounds.push_back(bound);
     }
 
-    BRep_Builder builder;
-    builder.MakeCompound(compoundOut);
-
-    while(!pairList.empty()) {
-        PairVector currentGroup;
-        currentGroup.push_back(pairList.front());
-        pairList.pop_front();
-        PairList::iterator it = pairList.begin();
-        while(it != pairList.end()) {
-            PairVector::const_iterator groupIt;
-            bool found(false);
-            for (groupIt = currentGroup.begin(); groupIt != currentGroup.end(); ++groupIt) {
-                if (!(*it).second.IsOut((*groupIt).second)) {//touching means is out.
-                    found = true;
-                    break;
+    // Collect the connected components of the 'bounding boxes overlap' relation
+    std::vector<bool> visited(toolsIn.size(), false);
+    for (std::size_t i = 0; i < toolsIn.size(); ++i) {
+        if (visited[i])
+            continue;
+        visited[i] = true;
+
+        std::vector<std::size_t> currentGroup;
+        std::vector<std::size_t> front;
+        front.push_back(i);
+        while (!front.empty()) {
+            std::size_t current = front.back();
+            front.pop_back();
+            currentGroup.push_back(current);
+            for (std::size_t j = i + 1; j < toolsIn.size(); ++j) {
+                if (!visited[j] && !bounds[j].IsOut(bounds[current])) {//touching means is out.
+                    visited[j] = true;
+                    front.push_back(j);
                 }
             }
-            if (found) {
-                currentGroup.push_back(*it);
-                pairList.erase(it);
-                it=pairList.begin();
-                continue;
-            }
-            ++it;
         }
 
         if (currentGroup.size() == 1) {
-            builder.Add(compoundOut, currentGroup.front().first);
+            separatedOut.push_back(i);
         }
         else {
-            PairVector::const_iterator groupIt;
-            for (groupIt = currentGroup.begin(); groupIt != currentGroup.end(); ++groupIt)
-                individualsOut.push_back((*groupIt).first);
+            // keep the order of the transformations
+            std::sort(currentGroup.begin(), currentGroup.end());
+            overlappingOut.push_back(currentGroup);
         }
     }
 }
@@ -29,6 +29,7 @@
 #include <App/PropertyStandard.h>
 #include "Feature.h"
 
+class Bnd_Box;
 
 namespace PartDesign
 {
@@ -92,8 +93,20 @@ protected:
     void Restore(Base::XMLReader &reader);
     virtual void positionBySupport(void);
     TopoDS_Shape refineShapeIfActive(const TopoDS_Shape&) const;
-    void divideTools(const std::vector<TopoDS_Shape> &toolsIn, std::vector<TopoDS_Shape> &individualsOut,
-		     TopoDS_Compound &compoundOut) const; 
+    /** Groups the tool shapes by overlapping bounding boxes
+      * The indices of shapes that don't overlap any other are returned in \a separatedOut,
+      * each group of mutually overlapping shapes is returned as one entry of \a overlappingOut.
+      */
+    void divideTools(const std::vector<TopoDS_Shape> &toolsIn, std::vector<std::size_t> &separatedOut,
+                     std::vector<std::vector<std::size_t> > &overlappingOut) const;
+    /// Returns a transformed copy of \a shape or a null shape on failure
+    static TopoDS_Shape transformShape(const TopoDS_Shape& shape, const gp_Trsf& trsf);
+    /// Checks if \a tool intersects or touches \a support, \a supportBound is the bounding box of the support
+    static bool touchesSupport(const TopoDS_Shape& support, const Bnd_Box& supportBound, const TopoDS_Shape& tool);
+    /// Fuses all \a tools with \a support in a single boolean operation
+    static TopoDS_Shape fuseTools(const TopoDS_Shape& support, const std::vector<TopoDS_Shape>& tools);
+    /// Cuts all \a tools out of \a support in a single boolean operation
+    static TopoDS_Shape cutTools(const TopoDS_Shape& support, const std::vector<TopoDS_Shape>& tools);
 
     rejectedMap rejected;
 };
@@ -18,6 +18,7 @@
 #   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
 #   USA                                                                   *
 #**************************************************************************
+import math
 import unittest
 
 import FreeCAD
@@ -64,6 +65,70 @@ class TestMultiTransform(unittest.TestCase):
         self.Doc.recompute()
         self.assertAlmostEqual(self.MultiTransform.Shape.Volume, 20000)
 
+    def testMultiTransformSubtractiveGrid(self):
+        # 20x20 hole pattern, all holes get cut out of the plate in one go
+        self.Body = self.Doc.addObject('PartDesign::Body','Body')
+        self.Box = self.Doc.addObject('PartDesign::AdditiveBox','Box')
+        self.Body.addObject(self.Box)
+        self.Box.Length=200.00
+        self.Box.Width=200.00
+        self.Box.Height=10.00
+        self.Cylinder = self.Doc.addObject('PartDesign::SubtractiveCylinder','Cylinder')
+        self.Body.addObject(self.Cylinder)
+        self.Cylinder.Radius = 2.0
+        self.Cylinder.Height = 10.0
+        self.Cylinder.Placement.Base = App.Vector(5, 5, 0)
+        self.Doc.recompute()
+        self.MultiTransform = self.Doc.addObject("PartDesign::MultiTransform","MultiTransform")
+        self.MultiTransform.Originals = [self.Cylinder]
+        self.Body.addObject(self.MultiTransform)
+        self.LinearPatternX = self.Doc.addObject("PartDesign::LinearPattern","LinearPatternX")
+        self.LinearPatternX.Direction = (self.Doc.X_Axis,[""])
+        self.LinearPatternX.Length = 190.0
+        self.LinearPatternX.Occurrences = 20
+        self.Body.addObject(self.LinearPatternX)
+        self.LinearPatternY = self.Doc.addObject("PartDesign::LinearPattern","LinearPatternY")
+        self.LinearPatternY.Direction = (self.Doc.Y_Axis,[""])
+        self.LinearPatternY.Length = 190.0
+        self.LinearPatternY.Occurrences = 20
+        self.Body.addObject(self.LinearPatternY)
+        self.MultiTransform.Transformations = [self.LinearPatternX,self.LinearPatternY]
+        self.Doc.recompute()
+        self.assertAlmostEqual(self.MultiTransform.Shape.Volume, 400000 - 400 * math.pi * 4 * 10, places=3)
+
+    def testMultiTransformAdditiveGrid(self):
+        # 20x20 pattern of bosses, none of them overlap so they are fused with the plate in one go
+        self.Body = self.Doc.addObject('PartDesign::Body','Body')
+        self.Box = self.Doc.addObject('PartDesign::AdditiveBox','Box')
+        self.Body.addObject(self.Box)
+        self.Box.Length=200.00
+        self.Box.Width=200.00
+        self.Box.Height=5.00
+        self.Boss = self.Doc.addObject('PartDesign::AdditiveBox','Boss')
+        self.Body.addObject(self.Boss)
+        self.Boss.Length=2.00
+        self.Boss.Width=2.00
+        self.Boss.Height=2.00
+        self.Boss.Placement.Base = App.Vector(4, 4, 5)
+        self.Doc.recompute()
+        self.MultiTransform = self.Doc.addObject("PartDesign::MultiTransform","MultiTransform")
+        self.MultiTransform.Originals = [self.Boss]
+        self.Body.addObject(self.MultiTransform)
+        self.LinearPatternX = self.Doc.addObject("PartDesign::LinearPattern","LinearPatternX")
+        self.LinearPatternX.Direction = (self.Doc.X_Axis,[""])
+        self.LinearPatternX.Length = 190.0
+        self.LinearPatternX.Occurrences = 20
+        self.Body.addObject(self.LinearPatternX)
+        self.LinearPatternY = self.Doc.addObject("PartDesign::LinearPattern","LinearPatternY")
+        self.LinearPatternY.Direction = (self.Doc.Y_Axis,[""])
+        self.LinearPatternY.Length = 190.0
+        self.LinearPatternY.Occurrences = 20
+        self.Body.addObject(self.LinearPatternY)
+        self.MultiTransform.Transformations = [self.LinearPatternX,self.LinearPatternY]
+        self.Doc.recompute()
+        self.assertAlmostEqual(self.MultiTransform.Shape.Volume, 200000 + 400 * 8)
+        self.assertEqual(len(self.MultiTransform.Shape.Solids), 1)
+
     def tearDown(self):
         #closing doc
         FreeCAD.closeDocument("PartDesignTestMultiTransform")
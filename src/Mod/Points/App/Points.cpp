@@ -23,12 +23,14 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <algorithm>
 # include <cmath>
 # include <iostream>
 #endif
 
 #include <boost/math/special_functions/fpclassify.hpp>
 #include <QtConcurrentMap>
+#include <QThread>
 
 #include <Base/Exception.h>
 #include <Base/Matrix.h>
@@ -47,6 +49,74 @@
 using namespace Points;
 using namespace std;
 
+namespace {
+struct PointBlock {
+    std::size_t begin;
+    std::size_t end;
+    std::size_t count;
+};
+
+// Splits the range [0, count) into a few blocks per thread
+std::vector<PointBlock> makeBlocks(std::size_t count)
+{
+    const std::size_t minBlock = 65536;
+    std::size_t numBlocks = static_cast<std::size_t>(std::max(1, QThread::idealThreadCount())) * 4;
+    std::size_t blockSize = std::max<std::size_t>(minBlock, (count + numBlocks - 1) / numBlocks);
+
+    std::vector<PointBlock> blocks;
+    for (std::size_t i = 0; i < count; i += blockSize) {
+        PointBlock block = {i, std::min(count, i + blockSize), 0};
+        blocks.push_back(block);
+    }
+    return blocks;
+}
+
+inline bool isValid(const PointKernel::value_type& p)
+{
+    return !(boost::math::isnan(p.x) || boost::math::isnan(p.y) || boost::math::isnan(p.z));
+}
+
+// Counts the valid points of each block
+void countValidBlocks(const std::vector<PointKernel::value_type>& pts, std::vector<PointBlock>& blocks)
+{
+    QtConcurrent::blockingMap(blocks, [&pts](PointBlock& block) {
+        for (std::size_t i = block.begin; i < block.end; i++) {
+            if (isValid(pts[i]))
+                block.count++;
+        }
+    });
+}
+
+// Affine part of a placement kept in locals so that the compiler can
+// vectorize the loops over a block of points
+class AffineTransform
+{
+public:
+    explicit AffineTransform(const Base::Matrix4D& mat)
+    {
+        for (int i=0; i<3; i++) {
+            for (int j=0; j<4; j++)
+                m[i][j] = mat[i][j];
+        }
+    }
+    void apply(const PointKernel::value_type* in, Base::Vector3d* out, std::size_t num) const
+    {
+        const double m00 = m[0][0], m01 = m[0][1], m02 = m[0][2], m03 = m[0][3];
+        const double m10 = m[1][0], m11 = m[1][1], m12 = m[1][2], m13 = m[1][3];
+        const double m20 = m[2][0], m21 = m[2][1], m22 = m[2][2], m23 = m[2][3];
+        for (std::size_t i=0; i<num; i++) {
+            double x = in[i].x, y = in[i].y, z = in[i].z;
+            out[i].x = m00*x + m01*y + m02*z + m03;
+            out[i].y = m10*x + m11*y + m12*z + m13;
+            out[i].z = m20*x + m21*y + m22*z + m23;
+        }
+    }
+
+private:
+    double m[3][4];
+};
+}
+
 TYPESYSTEM_SOURCE(Points::PointKernel, Data::ComplexGeoData)
 
 PointKernel::PointKernel(const PointKernel& pts)
@@ -116,7 +186,21 @@ Base::BoundBox3d PointKernel::getBoundBox(void)const
         bnd.Add(lbb);
     });
 #else
-    for (const_point_iterator it = begin(); it != end(); ++it)
+    // transform the points block-wise into a local buffer
+    std::vector<PointBlock> blocks = makeBlocks(_Points.size());
+    std::vector<Base::BoundBox3d> bbs(blocks.size());
+    AffineTransform trf(_Mtrx);
+    QtConcurrent::blockingMap(blocks, [this, &trf, &blocks, &bbs](PointBlock& block) {
+        Base::BoundBox3d& bb = bbs[&block - &blocks[0]];
+        Base::Vector3d buf[256];
+        for (std::size_t i = block.begin; i < block.end; i += 256) {
+            std::size_t len = std::min<std::size_t>(256, block.end - i);
+            trf.apply(&_Points[i], buf, len);
+            for (std::size_t j = 0; j < len; j++)
+                bb.Add(buf[j]);
+        }
+    });
+    for (std::vector<Base::BoundBox3d>::iterator it = bbs.begin(); it != bbs.end(); ++it)
         bnd.Add(*it);
 #endif
     return bnd;
@@ -138,32 +222,65 @@ unsigned int PointKernel::getMemSize (void) const
 
 PointKernel::size_type PointKernel::countValid(void) const
 {
+    // A point is invalid if it has a NaN coordinate. This doesn't change
+    // with the placement so the stored points can be checked directly.
+    std::vector<PointBlock> blocks = makeBlocks(_Points.size());
+    countValidBlocks(_Points, blocks);
+
     size_type num = 0;
-    for (const_point_iterator it = begin(); it != end(); ++it) {
-        if (!(boost::math::isnan(it->x) || 
-              boost::math::isnan(it->y) ||
-              boost::math::isnan(it->z)))
-            num++;
-    }
+    for (std::vector<PointBlock>::iterator it = blocks.begin(); it != blocks.end(); ++it)
+        num += it->count;
     return num;
 }
 
 std::vector<PointKernel::value_type> PointKernel::getValidPoints() const
 {
-    std::vector<PointKernel::value_type> valid;
-    valid.reserve(countValid());
-    for (const_point_iterator it = begin(); it != end(); ++it) {
-        if (!(boost::math::isnan(it->x) || 
-              boost::math::isnan(it->y) ||
-              boost::math::isnan(it->z)))
-            valid.emplace_back(
-                    static_cast<float_type>(it->x),
-                    static_cast<float_type>(it->y),
-                    static_cast<float_type>(it->z));
+    std::vector<PointBlock> blocks = makeBlocks(_Points.size());
+    countValidBlocks(_Points, blocks);
+
+    // each block writes its valid points behind the ones of the previous blocks
+    std::vector<std::size_t> offsets;
+    offsets.reserve(blocks.size());
+    std::size_t num = 0;
+    for (std::vector<PointBlock>::iterator it = blocks.begin(); it != blocks.end(); ++it) {
+        offsets.push_back(num);
+        num += it->count;
     }
+
+    std::vector<PointKernel::value_type> valid(num);
+    AffineTransform trf(_Mtrx);
+    QtConcurrent::blockingMap(blocks, [this, &trf, &blocks, &offsets, &valid](PointBlock& block) {
+        std::size_t pos = offsets[&block - &blocks[0]];
+        Base::Vector3d buf[256];
+        for (std::size_t i = block.begin; i < block.end; i += 256) {
+            std::size_t len = std::min<std::size_t>(256, block.end - i);
+            trf.apply(&_Points[i], buf, len);
+            for (std::size_t j = 0; j < len; j++) {
+                if (isValid(_Points[i+j])) {
+                    valid[pos++].Set(static_cast<float_type>(buf[j].x),
+                                     static_cast<float_type>(buf[j].y),
+                                     static_cast<float_type>(buf[j].z));
+                }
+            }
+        }
+    });
     return valid;
 }
 
+void PointKernel::getTransformedPoints(size_type first, size_type count, Base::Vector3d* pts) const
+{
+    if (first >= _Points.size())
+        return;
+    count = std::min(count, _Points.size() - first);
+
+    std::vector<PointBlock> blocks = makeBlocks(count);
+    AffineTransform trf(_Mtrx);
+    const value_type* src = &_Points[first];
+    QtConcurrent::blockingMap(blocks, [&trf, src, pts](PointBlock& block) {
+        trf.apply(src + block.begin, pts + block.begin, block.end - block.begin);
+    });
+}
+
 void PointKernel::Save (Base::Writer &writer) const
 {
     if (!writer.isForceXML()) {
@@ -237,11 +354,10 @@ void PointKernel::getPoints(std::vector<Base::Vector3d> &Points,
                             std::vector<Base::Vector3d> &/*Normals*/,
                             float /*Accuracy*/, uint16_t /*flags*/) const
 {
-    unsigned long ctpoints = _Points.size();
-    Points.reserve(ctpoints);
-    for (unsigned long i=0; i<ctpoints; i++) {
-        Points.push_back(this->getPoint(i));
-    }
+    std::size_t offset = Points.size();
+    Points.resize(offset + _Points.size());
+    if (!_Points.empty())
+        getTransformedPoints(0, _Points.size(), &Points[offset]);
 }
 
 // ----------------------------------------------------------------------------
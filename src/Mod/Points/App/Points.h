@@ -117,6 +117,11 @@ public:
     size_type size(void) const {return this->_Points.size();}
     size_type countValid(void) const;
     std::vector<value_type> getValidPoints() const;
+    /** Transforms the \a count points starting at \a first with the placement
+     * and writes them to \a pts that must have room for \a count points.
+     * Large ranges are transformed in parallel blocks.
+     */
+    void getTransformedPoints(size_type first, size_type count, Base::Vector3d* pts) const;
     void resize(size_type n){_Points.resize(n);}
     void reserve(size_type n){_Points.reserve(n);}
     inline void erase(size_type first, size_type last) {
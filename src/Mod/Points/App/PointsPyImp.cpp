@@ -213,11 +213,8 @@ PyObject* PointsPy::fromValid(PyObject * args)
     try {
         const PointKernel* points = getPointKernelPtr();
         std::unique_ptr<PointKernel> pts(new PointKernel());
-        pts->reserve(points->size());
-        for (PointKernel::const_iterator it = points->begin(); it != points->end(); ++it) {
-            if (!boost::math::isnan(it->x) && !boost::math::isnan(it->y) && !boost::math::isnan(it->z))
-                pts->push_back(*it);
-        }
+        std::vector<PointKernel::value_type> valid = points->getValidPoints();
+        pts->swap(valid);
 
         return new PointsPy(pts.release());
     }
@@ -51,9 +51,26 @@ PropertyPointKernel::~PropertyPointKernel()
 {
 }
 
+void PropertyPointKernel::detach(bool keepContent)
+{
+    // another reference, usually from a copy made for undo or a Python
+    // wrapper, expects the current points to stay unchanged
+    if (_cPoints.getRefCount() <= 1)
+        return;
+
+    Base::Reference<PointKernel> points(new PointKernel());
+    if (keepContent)
+        *points = *_cPoints;
+    else
+        points->setTransform(_cPoints->getTransform());
+    _cPoints = points;
+}
+
 void PropertyPointKernel::setValue(const PointKernel& m)
 {
     aboutToSetValue();
+    if (&m != static_cast<PointKernel*>(_cPoints))
+        detach(false);
     *_cPoints = m;
     hasSetValue();
 }
@@ -114,6 +131,7 @@ void PropertyPointKernel::Restore(Base::XMLReader &reader)
         mtrx.fromString(Matrix);
 
         aboutToSetValue();
+        detach(true);
         _cPoints->setTransform(mtrx);
         hasSetValue();
     }
@@ -128,6 +146,7 @@ void PropertyPointKernel::SaveDocFile (Base::Writer &writer) const
 void PropertyPointKernel::RestoreDocFile(Base::Reader &reader)
 {
     aboutToSetValue();
+    detach(false);
     _cPoints->RestoreDocFile(reader);
     hasSetValue();
 }
@@ -139,9 +158,19 @@ App::Property *PropertyPointKernel::Copy(void) const
     return prop;
 }
 
+App::Property *PropertyPointKernel::copyForTransaction(void) const
+{
+    // the points are shared, both properties get their own ones before
+    // they are modified
+    PropertyPointKernel* prop = new PropertyPointKernel();
+    prop->_cPoints = this->_cPoints;
+    return prop;
+}
+
 void PropertyPointKernel::Paste(const App::Property &from)
 {
     aboutToSetValue();
+    detach(false);
     const PropertyPointKernel& prop = dynamic_cast<const PropertyPointKernel&>(from);
     *(this->_cPoints) = *(prop._cPoints);
     hasSetValue();
@@ -152,9 +181,17 @@ unsigned int PropertyPointKernel::getMemSize (void) const
     return sizeof(Base::Vector3f) * this->_cPoints->size();
 }
 
+unsigned int PropertyPointKernel::getUnsharedMemSize (void) const
+{
+    if (_cPoints.getRefCount() > 1)
+        return 0;
+    return getMemSize();
+}
+
 PointKernel* PropertyPointKernel::startEditing()
 {
     aboutToSetValue();
+    detach(true);
     return static_cast<PointKernel*>(_cPoints);
 }
 
@@ -194,6 +231,7 @@ void PropertyPointKernel::removeIndices( const std::vector<unsigned long>& uIndi
 void PropertyPointKernel::transformGeometry(const Base::Matrix4D &rclMat)
 {
     aboutToSetValue();
+    detach(true);
     _cPoints->transformGeometry(rclMat);
     hasSetValue();
 }
@@ -64,9 +64,14 @@ public:
     //@{
     /// returns a new copy of the property (mainly for Undo/Redo and transactions)
     App::Property *Copy(void) const;
+    /// returns a copy for transactions that references the same points
+    App::Property *copyForTransaction(void) const;
     /// paste the value from the property (mainly for Undo/Redo and transactions)
     void Paste(const App::Property &from);
     unsigned int getMemSize (void) const;
+    /// returns the size of the points unless they are also referenced elsewhere,
+    /// usually by the property the copy was made from
+    unsigned int getUnsharedMemSize (void) const;
     //@}
 
     /** @name Save/restore */
@@ -86,6 +91,10 @@ public:
     void removeIndices( const std::vector<unsigned long>& );
     //@}
 
+private:
+    /// gives this property its own points if they are also referenced elsewhere
+    void detach(bool keepContent);
+
 private:
     Base::Reference<PointKernel> _cPoints;
 };
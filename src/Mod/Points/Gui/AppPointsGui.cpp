@@ -29,6 +29,7 @@
 #include <CXX/Objects.hxx>
 
 #include "ViewProvider.h"
+#include "SoFCPointSet.h"
 #include "Workbench.h"
 
 #include <Base/Console.h>
@@ -97,6 +98,7 @@ PyMOD_INIT_FUNC(PointsGui)
     PointsGui::ViewProviderStructured   ::init();
     PointsGui::ViewProviderPython       ::init();
     PointsGui::Workbench                ::init();
+    PointsGui::SoFCPointSet             ::initClass();
     Gui::ViewProviderBuilder::add(
         Points::PropertyPointKernel::getClassTypeId(),
         PointsGui::ViewProviderPoints::getClassTypeId());
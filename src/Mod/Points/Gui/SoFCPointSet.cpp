@@ -0,0 +1,255 @@
+/***************************************************************************
+ *   Copyright (c) 2020 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <cfloat>
+# include <cmath>
+# include <Inventor/actions/SoGLRenderAction.h>
+# include <Inventor/elements/SoCacheElement.h>
+# include <Inventor/elements/SoGLCacheContextElement.h>
+# include <Inventor/elements/SoModelMatrixElement.h>
+# include <Inventor/elements/SoPointSizeElement.h>
+# include <Inventor/elements/SoViewVolumeElement.h>
+# include <Inventor/elements/SoViewportRegionElement.h>
+# include <Inventor/misc/SoState.h>
+#endif
+
+#include "SoFCPointSet.h"
+
+using namespace PointsGui;
+
+namespace {
+// Number of octree levels encoded in the sort key
+const int MaxLevel = 10;
+
+uint32_t spreadBits(uint32_t v)
+{
+    v = (v | (v << 16)) & 0x030000ff;
+    v = (v | (v <<  8)) & 0x0300f00f;
+    v = (v | (v <<  4)) & 0x030c30c3;
+    v = (v | (v <<  2)) & 0x09249249;
+    return v;
+}
+}
+
+SO_NODE_SOURCE(SoFCPointSet)
+
+void SoFCPointSet::initClass()
+{
+    SO_NODE_INIT_CLASS(SoFCPointSet, SoPointSet, "PointSet");
+}
+
+SoFCPointSet::SoFCPointSet()
+{
+    SO_NODE_CONSTRUCTOR(SoFCPointSet);
+    SO_NODE_ADD_FIELD(pointBudget, (0));
+}
+
+void SoFCPointSet::sortLevels(const SbVec3f* pts, int num,
+                              std::vector<int32_t>& order,
+                              std::vector<int32_t>& levels)
+{
+    order.clear();
+    levels.clear();
+    order.reserve(num);
+
+    SbBox3f box;
+    for (int i=0; i<num; i++) {
+        const SbVec3f& p = pts[i];
+        if (!(std::isnan(p[0]) || std::isnan(p[1]) || std::isnan(p[2])))
+            box.extendBy(p);
+    }
+
+    // sort the valid points along a Morton curve, so that the points of
+    // each octree cell are contiguous on every level
+    std::vector<std::pair<uint32_t, int32_t> > keys;
+    keys.reserve(num);
+    if (!box.isEmpty()) {
+        float dx, dy, dz;
+        box.getSize(dx, dy, dz);
+        float len = std::max(std::max(dx, dy), dz);
+        float scale = len > 0.0f ? static_cast<float>(1 << MaxLevel) / len : 0.0f;
+        const SbVec3f& bmin = box.getMin();
+        uint32_t maxCell = (1 << MaxLevel) - 1;
+        for (int i=0; i<num; i++) {
+            const SbVec3f& p = pts[i];
+            if (std::isnan(p[0]) || std::isnan(p[1]) || std::isnan(p[2]))
+                continue;
+            uint32_t x = std::min(static_cast<uint32_t>((p[0]-bmin[0])*scale), maxCell);
+            uint32_t y = std::min(static_cast<uint32_t>((p[1]-bmin[1])*scale), maxCell);
+            uint32_t z = std::min(static_cast<uint32_t>((p[2]-bmin[2])*scale), maxCell);
+            uint32_t key = (spreadBits(x) << 2) | (spreadBits(y) << 1) | spreadBits(z);
+            keys.push_back(std::make_pair(key, i));
+        }
+        std::sort(keys.begin(), keys.end());
+    }
+
+    // on each level take one point of every occupied cell that doesn't
+    // contain a point of a coarser level yet
+    std::vector<bool> taken(keys.size(), false);
+    std::size_t numKeys = keys.size();
+    for (int level=0; level<=MaxLevel && order.size() < numKeys; level++) {
+        int shift = 3 * (MaxLevel - level);
+        std::size_t begin = 0;
+        while (begin < numKeys) {
+            uint32_t cell = keys[begin].first >> shift;
+            std::size_t end = begin;
+            bool occupied = false;
+            while (end < numKeys && (keys[end].first >> shift) == cell) {
+                if (taken[end])
+                    occupied = true;
+                ++end;
+            }
+            if (!occupied) {
+                taken[begin] = true;
+                order.push_back(keys[begin].second);
+            }
+            begin = end;
+        }
+        levels.push_back(static_cast<int32_t>(order.size()));
+    }
+
+    // the remaining points share the finest cells with others
+    for (std::size_t i=0; i<numKeys; i++) {
+        if (!taken[i])
+            order.push_back(keys[i].second);
+    }
+
+    // invalid points come last
+    if (order.size() < static_cast<std::size_t>(num)) {
+        std::vector<bool> valid(num, false);
+        for (std::size_t i=0; i<numKeys; i++)
+            valid[keys[i].second] = true;
+        for (int i=0; i<num; i++) {
+            if (!valid[i])
+                order.push_back(i);
+        }
+    }
+
+    if (levels.empty() || levels.back() != num)
+        levels.push_back(num);
+}
+
+void SoFCPointSet::setLevels(const std::vector<int32_t>& levels, const SbBox3f& box)
+{
+    levelEnd = levels;
+    bbox = box;
+    touch();
+}
+
+void SoFCPointSet::clearLevels()
+{
+    levelEnd.clear();
+    bbox.makeEmpty();
+    touch();
+}
+
+float SoFCPointSet::screenSize(SoState* state) const
+{
+    const SbViewVolume &vv = SoViewVolumeElement::get(state);
+    const SbMatrix &mm = SoModelMatrixElement::get(state);
+    const SbViewportRegion &vp = SoViewportRegionElement::get(state);
+    SbVec2s size = vp.getViewportSizePixels();
+
+    const SbVec3f &bmin = bbox.getMin();
+    const SbVec3f &bmax = bbox.getMax();
+    float minx = FLT_MAX, miny = FLT_MAX, maxx = -FLT_MAX, maxy = -FLT_MAX;
+    for (int i=0; i<8; i++) {
+        SbVec3f corner(i&1 ? bmax[0] : bmin[0],
+                       i&2 ? bmax[1] : bmin[1],
+                       i&4 ? bmax[2] : bmin[2]);
+        SbVec3f world, screen;
+        mm.multVecMatrix(corner, world);
+        vv.projectToScreen(world, screen);
+        // partly behind the camera or beyond the far plane
+        if (screen[2] < 0.0f || screen[2] > 1.0f)
+            return FLT_MAX;
+        minx = std::min(minx, screen[0]);
+        maxx = std::max(maxx, screen[0]);
+        miny = std::min(miny, screen[1]);
+        maxy = std::max(maxy, screen[1]);
+    }
+    return std::max((maxx-minx)*size[0], (maxy-miny)*size[1]);
+}
+
+int SoFCPointSet::countPoints(SoState* state) const
+{
+    // The cells of level i have 1/2^i of the size of the bounding box. Once
+    // they get smaller than a point on screen finer levels don't add anything.
+    float pixels = screenSize(state);
+    float pointSize = std::max(SoPointSizeElement::get(state), 1.0f);
+    int count = levelEnd.back();
+    for (std::size_t i=0; i<levelEnd.size(); i++) {
+        if (pixels <= pointSize * std::ldexp(1.0f, static_cast<int>(i))) {
+            count = levelEnd[i];
+            break;
+        }
+    }
+
+    int budget = pointBudget.getValue();
+    if (budget > 0)
+        count = std::min(count, budget);
+    return count;
+}
+
+/**
+ * Renders only as many points as are visible at the current view.
+ */
+void SoFCPointSet::GLRender(SoGLRenderAction *action)
+{
+    int numpts = this->numPoints.getValue();
+    if (levelEnd.empty() || bbox.isEmpty() || this->startIndex.getValue() != 0 ||
+        numpts != levelEnd.back()) {
+        inherited::GLRender(action);
+        return;
+    }
+
+    // The number of rendered points depends on the view. A render cache that
+    // is being built gets all points, so replaying it never shows a stale
+    // level. Otherwise ask the separators above not to cache, so the level
+    // can follow the view without invalidating any cache.
+    SoState* state = action->getState();
+    if (SoCacheElement::anyOpen(state)) {
+        inherited::GLRender(action);
+        return;
+    }
+
+    int count = countPoints(state);
+    if (count >= numpts) {
+        inherited::GLRender(action);
+        return;
+    }
+
+    SoGLCacheContextElement::shouldAutoCache(state, SoGLCacheContextElement::DONT_AUTO_CACHE);
+
+    // temporarily shorten the point set without notifying the scene graph
+    SbBool notify = this->numPoints.enableNotify(false);
+    this->numPoints.setValue(count);
+    inherited::GLRender(action);
+    this->numPoints.setValue(numpts);
+    this->numPoints.enableNotify(notify);
+}
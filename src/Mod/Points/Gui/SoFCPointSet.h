@@ -0,0 +1,89 @@
+/***************************************************************************
+ *   Copyright (c) 2020 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+#ifndef POINTSGUI_SOFCPOINTSET_H
+#define POINTSGUI_SOFCPOINTSET_H
+
+#include <vector>
+#include <Inventor/SbBox3f.h>
+#include <Inventor/fields/SoSFInt32.h>
+#include <Inventor/nodes/SoPointSet.h>
+
+class SoState;
+
+namespace PointsGui {
+
+/**
+ * class SoFCPointSet
+ * \brief The SoFCPointSet class renders large point clouds with a level of detail.
+ *
+ * The coordinates are expected in the order computed by sortLevels(): the
+ * first point of each occupied cell of an octree comes first, level by level,
+ * so that any prefix of the coordinates is an evenly spread subset of the cloud.
+ * When rendering, only the prefix whose cells are not smaller than a pixel on
+ * screen is drawn, and never more points than \a pointBudget.
+ * Picking and bounding box calculation always use all points.
+ */
+class PointsGuiExport SoFCPointSet : public SoPointSet {
+    typedef SoPointSet inherited;
+
+    SO_NODE_HEADER(SoFCPointSet);
+
+public:
+    static void initClass();
+    SoFCPointSet();
+
+    /// The maximum number of rendered points, 0 means unlimited
+    SoSFInt32 pointBudget;
+
+    /** Computes the rendering order of the \a num points \a pts.
+     * \a order gets the point indices in octree level order and \a levels
+     * the end of each level in \a order. The last entry of \a levels is \a num.
+     */
+    static void sortLevels(const SbVec3f* pts, int num,
+                           std::vector<int32_t>& order,
+                           std::vector<int32_t>& levels);
+    /// Sets the levels and the bounding box of the sorted points
+    void setLevels(const std::vector<int32_t>& levels, const SbBox3f& box);
+    /// Removes the levels, all points are rendered then
+    void clearLevels();
+
+protected:
+    // Force using the reference count mechanism.
+    virtual ~SoFCPointSet() {}
+    virtual void GLRender(SoGLRenderAction *action);
+
+private:
+    int countPoints(SoState*) const;
+    float screenSize(SoState*) const;
+
+private:
+    std::vector<int32_t> levelEnd;
+    SbBox3f bbox;
+};
+
+} // namespace PointsGui
+
+
+#endif // POINTSGUI_SOFCPOINTSET_H
@@ -58,6 +58,7 @@
 #include <Mod/Points/App/PointsFeature.h>
 
 #include "ViewProvider.h"
+#include "SoFCPointSet.h"
 #include "../App/Properties.h"
 
 
@@ -129,9 +130,17 @@ void ViewProviderPoints::setVertexColorMode(App::PropertyColorList* pcProperty)
     pcColorMat->diffuseColor.setNum(val.size());
     SbColor* col = pcColorMat->diffuseColor.startEditing();
 
-    std::size_t i=0;
-    for (std::vector<App::Color>::const_iterator it = val.begin(); it != val.end(); ++it) {
-        col[i++].setValue(it->r, it->g, it->b);
+    if (renderOrder.size() == val.size()) {
+        for (std::size_t i=0; i<renderOrder.size(); i++) {
+            const App::Color& c = val[renderOrder[i]];
+            col[i].setValue(c.r, c.g, c.b);
+        }
+    }
+    else {
+        std::size_t i=0;
+        for (std::vector<App::Color>::const_iterator it = val.begin(); it != val.end(); ++it) {
+            col[i++].setValue(it->r, it->g, it->b);
+        }
     }
 
     pcColorMat->diffuseColor.finishEditing();
@@ -144,9 +153,17 @@ void ViewProviderPoints::setVertexGreyvalueMode(Points::PropertyGreyValueList* p
     pcColorMat->diffuseColor.setNum(val.size());
     SbColor* col = pcColorMat->diffuseColor.startEditing();
 
-    std::size_t i=0;
-    for (std::vector<float>::const_iterator it = val.begin(); it != val.end(); ++it) {
-        col[i++].setValue(*it, *it, *it);
+    if (renderOrder.size() == val.size()) {
+        for (std::size_t i=0; i<renderOrder.size(); i++) {
+            float g = val[renderOrder[i]];
+            col[i].setValue(g, g, g);
+        }
+    }
+    else {
+        std::size_t i=0;
+        for (std::vector<float>::const_iterator it = val.begin(); it != val.end(); ++it) {
+            col[i++].setValue(*it, *it, *it);
+        }
     }
 
     pcColorMat->diffuseColor.finishEditing();
@@ -159,9 +176,17 @@ void ViewProviderPoints::setVertexNormalMode(Points::PropertyNormalList* pcPrope
     pcPointsNormal->vector.setNum(val.size());
     SbVec3f* norm = pcPointsNormal->vector.startEditing();
 
-    std::size_t i=0;
-    for (std::vector<Base::Vector3f>::const_iterator it = val.begin(); it != val.end(); ++it) {
-        norm[i++].setValue(it->x, it->y, it->z);
+    if (renderOrder.size() == val.size()) {
+        for (std::size_t i=0; i<renderOrder.size(); i++) {
+            const Base::Vector3f& n = val[renderOrder[i]];
+            norm[i].setValue(n.x, n.y, n.z);
+        }
+    }
+    else {
+        std::size_t i=0;
+        for (std::vector<Base::Vector3f>::const_iterator it = val.begin(); it != val.end(); ++it) {
+            norm[i++].setValue(it->x, it->y, it->z);
+        }
     }
 
     pcPointsNormal->vector.finishEditing();
@@ -356,8 +381,12 @@ PROPERTY_SOURCE(PointsGui::ViewProviderScattered, PointsGui::ViewProviderPoints)
 
 ViewProviderScattered::ViewProviderScattered()
 {
-    pcPoints = new SoPointSet();
+    pcPoints = new SoFCPointSet();
     pcPoints->ref();
+
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Points");
+    pcPoints->pointBudget = hGrp->GetInt("PointBudget", 10000000);
 }
 
 ViewProviderScattered::~ViewProviderScattered()
@@ -417,6 +446,7 @@ void ViewProviderScattered::updateData(const App::Property* prop)
     if (prop->getTypeId() == Points::PropertyPointKernel::getClassTypeId()) {
         ViewProviderPointsBuilder builder;
         builder.createPoints(prop, pcPointsCoord, pcPoints);
+        sortPoints();
 
         // The number of points might have changed, so force also a resize of the Inventor internals
         setActiveMode();
@@ -432,6 +462,49 @@ void ViewProviderScattered::updateData(const App::Property* prop)
     }
 }
 
+void ViewProviderScattered::sortPoints()
+{
+    // Small clouds are rendered as they are
+    int numPoints = pcPointsCoord->point.getNum();
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Points");
+    if (numPoints < 100000 || !hGrp->GetBool("LevelOfDetail", true)) {
+        renderOrder.clear();
+        pcPoints->clearLevels();
+        return;
+    }
+
+    std::vector<int32_t> levels;
+    SoFCPointSet::sortLevels(pcPointsCoord->point.getValues(0), numPoints, renderOrder, levels);
+
+    // Apply the order in place by following the cycles of the permutation, a
+    // sorted copy of the coordinates would double their memory for a moment.
+    // The order itself is kept to map colors and normals that are set later.
+    SbVec3f* coords = pcPointsCoord->point.startEditing();
+    std::vector<bool> done(numPoints, false);
+    SbBox3f box;
+    for (int i=0; i<numPoints; i++) {
+        if (done[i])
+            continue;
+        SbVec3f first = coords[i];
+        int j = i;
+        while (renderOrder[j] != i) {
+            coords[j] = coords[renderOrder[j]];
+            done[j] = true;
+            j = renderOrder[j];
+        }
+        coords[j] = first;
+        done[j] = true;
+    }
+    for (int i=0; i<numPoints; i++) {
+        const SbVec3f& p = coords[i];
+        if (!(boost::math::isnan(p[0]) || boost::math::isnan(p[1]) || boost::math::isnan(p[2])))
+            box.extendBy(p);
+    }
+    pcPointsCoord->point.finishEditing();
+    pcPoints->setLevels(levels, box);
+}
+
 void ViewProviderScattered::cut(const std::vector<SbVec2f>& picked, Gui::View3DInventorViewer &Viewer)
 {
     // create the polygon from the picked points
@@ -55,6 +55,8 @@ namespace Points {
 
 namespace PointsGui {
 
+class SoFCPointSet;
+
 class ViewProviderPointsBuilder : public Gui::ViewProviderBuilder
 {
 public:
@@ -107,6 +109,8 @@ protected:
     SoMaterial          * pcColorMat;
     SoNormal            * pcPointsNormal;
     SoDrawStyle         * pcPointStyle;
+    /// The rendering order of the points if it differs from the point kernel
+    std::vector<int32_t>  renderOrder;
 
 private:
     static App::PropertyFloatConstraint::Constraints floatRange;
@@ -135,9 +139,11 @@ public:
 
 protected:
     virtual void cut(const std::vector<SbVec2f>& picked, Gui::View3DInventorViewer &Viewer);
+    /// Sorts the coordinates by octree level for the level of detail rendering
+    void sortPoints();
 
 protected:
-    SoPointSet          * pcPoints;
+    SoFCPointSet        * pcPoints;
 };
 
 /**
@@ -0,0 +1,725 @@
+#***************************************************************************
+#*   Copyright (c) 2020 FreeCAD developers                                 *
+#*                                                                         *
+#*   This file is part of the FreeCAD CAx development system.              *
+#*                                                                         *
+#*   This program is free software; you can redistribute it and/or modify  *
+#*   it under the terms of the GNU Lesser General Public License (LGPL)    *
+#*   as published by the Free Software Foundation; either version 2 of     *
+#*   the License, or (at your option) any later version.                   *
+#*   for detail see the LICENCE text file.                                 *
+#*                                                                         *
+#*   FreeCAD is distributed in the hope that it will be useful,            *
+#*   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#*   GNU Library General Public License for more details.                  *
+#*                                                                         *
+#*   You should have received a copy of the GNU Library General Public     *
+#*   License along with FreeCAD; if not, write to the Free Software        *
+#*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#*   USA                                                                   *
+#*                                                                         *
+#***************************************************************************/
+
+"""Performance benchmarks of the modules.
+
+All input data is generated from fixed sizes and seeds, so the numbers of
+different builds can be compared. Run the benchmarks with
+
+    FreeCADCmd -c "import Benchmark; Benchmark.main('bench.json')"
+
+or with the FreeCADBench executable, which adds the benchmarks of the core
+libraries and writes both into one report.
+"""
+
+from __future__ import print_function
+
+import FreeCAD
+import json
+import math
+import os
+import platform
+import random
+import shutil
+import tempfile
+import time
+
+try:
+    _clock = time.perf_counter
+except AttributeError:
+    _clock = time.time
+
+SEED = 4711
+FORMAT_VERSION = 1
+
+
+def _statistics(times):
+    if not times:
+        return {'repeat': 0, 'times': []}
+    ordered = sorted(times)
+    count = len(ordered)
+    if count % 2:
+        median = ordered[count // 2]
+    else:
+        median = 0.5 * (ordered[count // 2 - 1] + ordered[count // 2])
+    return {
+        'repeat': count,
+        'times': times,
+        'min': ordered[0],
+        'max': ordered[-1],
+        'median': median,
+        'mean': sum(ordered) / count,
+    }
+
+
+def makeResult(group, name, size, times, error=None):
+    "Returns the result entry of a benchmark, also used by FreeCADBench."
+    result = {'name': group + '/' + name, 'group': group, 'size': size, 'unit': 's'}
+    if error:
+        result['error'] = error
+    result.update(_statistics(times))
+    return result
+
+
+def _module(name):
+    "Returns the module or None if it isn't built."
+    try:
+        return __import__(name)
+    except ImportError:
+        return None
+
+
+class Benchmark(object):
+    """Runs benchmark functions and collects their timings.
+
+    repeat is the number of timed runs of each benchmark, scale multiplies
+    the size of the generated inputs and only benchmarks whose name contains
+    filter are run.
+    """
+
+    def __init__(self, repeat=3, scale=1.0, filter=None):
+        self.repeat = max(1, int(repeat))
+        self.scale = float(scale)
+        self.filter = filter
+        self.results = []
+        self.tmpdir = tempfile.mkdtemp(prefix='FreeCADBench')
+
+    def close(self):
+        shutil.rmtree(self.tmpdir, ignore_errors=True)
+
+    def size(self, n, power=1.0):
+        "Returns n scaled by the scale factor to the given power."
+        return max(1, int(round(n * self.scale ** power)))
+
+    def selected(self, group, name=None):
+        if not self.filter:
+            return True
+        full = group if name is None else group + '/' + name
+        # a group is selected if any of its benchmarks could match
+        return self.filter in full or (name is None and full in self.filter)
+
+    def path(self, filename):
+        return os.path.join(self.tmpdir, filename)
+
+    def skip(self, group, reason):
+        if self.selected(group):
+            self.results.append({'name': group, 'group': group, 'skipped': reason})
+
+    def run(self, group, name, size, func, setup=None, teardown=None):
+        """Calls func(state) repeat times and records the time of each call.
+
+        setup() is called before each call to create the state and
+        teardown(state) after it. Neither of them is timed.
+        """
+        if not self.selected(group, name):
+            return
+        full = group + '/' + name
+        times = []
+        error = None
+        try:
+            for i in range(self.repeat):
+                state = setup() if setup else None
+                try:
+                    start = _clock()
+                    func(state)
+                    times.append(_clock() - start)
+                finally:
+                    if teardown:
+                        teardown(state)
+        except Exception as e:
+            error = '{}: {}'.format(type(e).__name__, e)
+            FreeCAD.Console.PrintError('Benchmark {} failed: {}\n'.format(full, error))
+        result = makeResult(group, name, size, times, error)
+        self.results.append(result)
+        FreeCAD.Console.PrintLog('Benchmark {}: {}\n'.format(full, result.get('median')))
+
+
+class _Toggle(object):
+    "Alternates between two values, so each timed run has something to do."
+    def __init__(self, first, second):
+        self.values = (first, second)
+        self.index = 0
+
+    def next(self):
+        self.index = 1 - self.index
+        return self.values[self.index]
+
+
+def _newDocument(name):
+    doc = FreeCAD.newDocument(name)
+    doc.UndoMode = 0
+    return doc
+
+
+def _closeDocument(doc):
+    FreeCAD.closeDocument(doc.Name)
+
+
+def _originFeature(body, role):
+    for feature in body.Origin.OriginFeatures:
+        if feature.Role == role:
+            return feature
+    raise ValueError('Body has no origin feature ' + role)
+
+
+def _addPolygon(sketch, points):
+    Part = _module('Part')
+    count = len(points)
+    geometry = []
+    for i in range(count):
+        p1 = FreeCAD.Vector(points[i][0], points[i][1], 0)
+        p2 = FreeCAD.Vector(points[(i + 1) % count][0], points[(i + 1) % count][1], 0)
+        geometry.append(Part.LineSegment(p1, p2))
+    sketch.addGeometry(geometry, False)
+
+
+#---------------------------------------------------------------------------
+# the benchmarks of the modules
+#---------------------------------------------------------------------------
+
+def benchDocument(bench):
+    "Saves and opens a document of generated Part features."
+    Part = _module('Part')
+    if not Part:
+        bench.skip('document', 'Part module not available')
+        return
+    if not bench.selected('document'):
+        return
+
+    count = bench.size(1000)
+    rng = random.Random(SEED)
+    doc = _newDocument('BenchDocument')
+    columns = int(math.ceil(math.sqrt(count)))
+    for i in range(count):
+        pos = FreeCAD.Vector((i % columns) * 3.0, (i // columns) * 3.0, 0)
+        box = Part.makeBox(1 + rng.random(), 1 + rng.random(), 1 + rng.random(), pos)
+        if i % 2:
+            box = box.cut(Part.makeCylinder(0.4, 3, pos + FreeCAD.Vector(0.5, 0.5, -1)))
+        doc.addObject('Part::Feature', 'Shape').Shape = box
+
+    path = bench.path('BenchDocument.FCStd')
+    saveCopy = bench.path('BenchDocumentCopy.FCStd')
+
+    def removeCopy(state):
+        if os.path.exists(saveCopy):
+            os.remove(saveCopy)
+
+    bench.run('document', 'save', count, lambda s: doc.saveAs(saveCopy), teardown=removeCopy)
+    doc.saveAs(path)
+    _closeDocument(doc)
+
+    opened = []
+    def openDocument(state):
+        opened.append(FreeCAD.openDocument(path))
+
+    def closeOpened(state):
+        while opened:
+            _closeDocument(opened.pop())
+
+    bench.run('document', 'open', count, openDocument, teardown=closeOpened)
+
+
+def benchProperties(bench):
+    "Reads and writes properties of features and links by their Python names."
+    if not bench.selected('property'):
+        return
+
+    count = bench.size(200000)
+    doc = _newDocument('BenchProperties')
+    try:
+        feature = doc.addObject('App::FeaturePython', 'Feature')
+        feature.addProperty('App::PropertyFloat', 'Value')
+        link = doc.addObject('App::Link', 'Link')
+        link.setLink(feature)
+
+        def read(obj, name):
+            def func(state):
+                for i in range(count):
+                    getattr(obj, name)
+            return func
+
+        def write(state):
+            for i in range(count):
+                feature.Value = i
+
+        bench.run('property', 'get_static', count, read(feature, 'Label'))
+        bench.run('property', 'get_dynamic', count, read(feature, 'Value'))
+        # found on the linked object after the own and extension tables
+        bench.run('property', 'get_linked', count, read(link, 'Value'))
+        bench.run('property', 'set_dynamic', count, write)
+    finally:
+        _closeDocument(doc)
+
+
+def _makeBody(doc, holes, occurrences):
+    body = doc.addObject('PartDesign::Body', 'Body')
+    plane = _originFeature(body, 'XY_Plane')
+    axis = _originFeature(body, 'Z_Axis')
+
+    base = body.newObject('Sketcher::SketchObject', 'BaseSketch')
+    base.Support = (plane, [''])
+    base.MapMode = 'FlatFace'
+    _addPolygon(base, [(-50, -50), (50, -50), (50, 50), (-50, 50)])
+    pad = body.newObject('PartDesign::Pad', 'Pad')
+    pad.Profile = base
+    pad.Length = 10
+
+    Part = _module('Part')
+    top = FreeCAD.Placement(FreeCAD.Vector(0, 0, 10), FreeCAD.Rotation())
+    grid = body.newObject('Sketcher::SketchObject', 'GridSketch')
+    grid.Support = (plane, [''])
+    grid.MapMode = 'FlatFace'
+    grid.AttachmentOffset = top
+    columns = int(math.ceil(math.sqrt(holes)))
+    spacing = 60.0 / columns
+    circles = []
+    for i in range(holes):
+        center = FreeCAD.Vector(-30 + (i % columns + 0.5) * spacing,
+                                -30 + (i // columns + 0.5) * spacing, 0)
+        circles.append(Part.Circle(center, FreeCAD.Vector(0, 0, 1), spacing * 0.3))
+    grid.addGeometry(circles, False)
+    pocket = body.newObject('PartDesign::Pocket', 'Pocket')
+    pocket.Profile = grid
+    pocket.Length = 5
+
+    slot = body.newObject('Sketcher::SketchObject', 'SlotSketch')
+    slot.Support = (plane, [''])
+    slot.MapMode = 'FlatFace'
+    slot.AttachmentOffset = top
+    slot.addGeometry(Part.Circle(FreeCAD.Vector(45, 0, 0), FreeCAD.Vector(0, 0, 1), 1.5), False)
+    hole = body.newObject('PartDesign::Pocket', 'SlotPocket')
+    hole.Profile = slot
+    hole.Type = 'ThroughAll'
+    pattern = body.newObject('PartDesign::PolarPattern', 'PolarPattern')
+    pattern.Originals = [hole]
+    pattern.Axis = (axis, [''])
+    pattern.Angle = 360
+    pattern.Occurrences = occurrences
+    return body, pad
+
+
+def benchPartDesign(bench):
+    "Recomputes a generated body with a pad, a pocket and a polar pattern."
+    if not (_module('PartDesign') and _module('Sketcher')):
+        bench.skip('partdesign', 'PartDesign or Sketcher module not available')
+        return
+    if not bench.selected('partdesign'):
+        return
+
+    holes = bench.size(64)
+    occurrences = bench.size(48)
+    doc = _newDocument('BenchPartDesign')
+    try:
+        body, pad = _makeBody(doc, holes, occurrences)
+        doc.recompute()
+        if not body.Shape.isValid():
+            raise RuntimeError('invalid body')
+
+        length = _Toggle(10.0, 10.5)
+        def changeLength():
+            pad.Length = length.next()
+        bench.run('partdesign', 'recompute_body', holes + occurrences,
+                  lambda s: doc.recompute(), setup=changeLength)
+
+        def touchAll():
+            for obj in doc.Objects:
+                obj.touch()
+        bench.run('partdesign', 'recompute_all', len(doc.Objects),
+                  lambda s: doc.recompute(), setup=touchAll)
+    finally:
+        _closeDocument(doc)
+
+
+def benchMesh(bench):
+    "Reads, writes and processes generated meshes."
+    Mesh = _module('Mesh')
+    if not Mesh:
+        bench.skip('mesh', 'Mesh module not available')
+        return
+    if not bench.selected('mesh'):
+        return
+
+    sampling = bench.size(200, 0.5)
+    sphere = Mesh.createSphere(10.0, sampling)
+    facets = sphere.CountFacets
+
+    for ext in ('stl', 'obj', 'off', 'ply'):
+        path = bench.path('BenchMesh.' + ext)
+        bench.run('mesh', 'write_' + ext, facets, lambda s: sphere.write(path))
+        if os.path.exists(path):
+            bench.run('mesh', 'read_' + ext, facets, lambda s: Mesh.Mesh(path))
+            os.remove(path)
+
+    copy = lambda: sphere.copy()
+    bench.run('mesh', 'smooth_laplace', facets,
+              lambda m: m.smooth(Method='Laplace', Iteration=10), setup=copy)
+    bench.run('mesh', 'smooth_taubin', facets,
+              lambda m: m.smooth(Method='Taubin', Iteration=10), setup=copy)
+    bench.run('mesh', 'decimate', facets,
+              lambda m: m.decimate(0.1, 0.5), setup=copy)
+    target = facets // 10
+    bench.run('mesh', 'decimate_serial', facets,
+              lambda m: m.decimate(target, partitions=1), setup=copy)
+    bench.run('mesh', 'decimate_partitioned', facets,
+              lambda m: m.decimate(target, partitions=4), setup=copy)
+    bench.run('mesh', 'curvature', facets,
+              lambda s: sphere.getCurvaturePerVertex())
+    bench.run('mesh', 'self_intersections', facets,
+              lambda s: sphere.hasSelfIntersections())
+
+    rng = random.Random(SEED)
+    rays = []
+    for i in range(bench.size(1000)):
+        base = (rng.uniform(-20, 20), rng.uniform(-20, 20), rng.uniform(-20, 20))
+        rays.append((base, (-base[0], -base[1], -base[2])))
+    def castRays(state):
+        for base, direction in rays:
+            sphere.nearestFacetOnRay(base, direction)
+    bench.run('mesh', 'nearest_facet_on_ray', len(rays), castRays)
+
+    other = sphere.copy()
+    other.translate(5.0, 3.0, 1.0)
+    bench.run('mesh', 'unite', facets, lambda s: sphere.unite(other))
+    bench.run('mesh', 'difference', facets, lambda s: sphere.difference(other))
+
+
+def _rectangleSketch(sketch, count, rng):
+    "Adds count fully constrained rectangles with perturbed start positions."
+    Part = _module('Part')
+    Sketcher = _module('Sketcher')
+    columns = int(math.ceil(math.sqrt(count)))
+    geometry = []
+    constraints = []
+    widths = []
+    for i in range(count):
+        x = 5.0 + (i % columns) * 20.0
+        y = 5.0 + (i // columns) * 20.0
+        corners = [(x, y), (x + 10, y), (x + 10, y + 8), (x, y + 8)]
+        corners = [(cx + rng.uniform(-1, 1), cy + rng.uniform(-1, 1)) for cx, cy in corners]
+        first = len(geometry)
+        for k in range(4):
+            p1 = FreeCAD.Vector(corners[k][0], corners[k][1], 0)
+            p2 = FreeCAD.Vector(corners[(k + 1) % 4][0], corners[(k + 1) % 4][1], 0)
+            geometry.append(Part.LineSegment(p1, p2))
+        for k in range(4):
+            constraints.append(Sketcher.Constraint('Coincident', first + k, 2, first + (k + 1) % 4, 1))
+        constraints.append(Sketcher.Constraint('Horizontal', first))
+        constraints.append(Sketcher.Constraint('Horizontal', first + 2))
+        constraints.append(Sketcher.Constraint('Vertical', first + 1))
+        constraints.append(Sketcher.Constraint('Vertical', first + 3))
+        constraints.append(Sketcher.Constraint('DistanceX', first, 1, x))
+        constraints.append(Sketcher.Constraint('DistanceY', first, 1, y))
+        widths.append(len(constraints))
+        constraints.append(Sketcher.Constraint('DistanceX', first, 10.0))
+        constraints.append(Sketcher.Constraint('DistanceY', first + 1, 8.0))
+    sketch.addGeometry(geometry, False)
+    sketch.addConstraint(constraints)
+    return widths
+
+
+def benchSketcher(bench):
+    "Solves a sketch of generated, fully constrained rectangles with planegcs."
+    if not (_module('Part') and _module('Sketcher')):
+        bench.skip('sketcher', 'Sketcher module not available')
+        return
+    if not bench.selected('sketcher'):
+        return
+
+    count = bench.size(50)
+    doc = _newDocument('BenchSketcher')
+    try:
+        sketch = doc.addObject('Sketcher::SketchObject', 'Sketch')
+        widths = _rectangleSketch(sketch, count, random.Random(SEED))
+        doc.recompute()
+
+        width = _Toggle(10.0, 11.0)
+        bench.run('sketcher', 'set_datum', count,
+                  lambda s: sketch.setDatum(widths[0], width.next()))
+        bench.run('sketcher', 'solve', count, lambda s: sketch.solve())
+        bench.run('sketcher', 'recompute', count, lambda s: doc.recompute(),
+                  setup=lambda: sketch.touch())
+    finally:
+        _closeDocument(doc)
+
+
+def benchConstraintSolver(bench):
+    "Solves a generated chain of distance constraints with the solver backends."
+    CS = _module('ConstraintSolver')
+    if not CS:
+        bench.skip('constraintsolver', 'ConstraintSolver module not available')
+        return
+    if not bench.selected('constraintsolver'):
+        return
+
+    count = bench.size(200)
+
+    def makeSystem():
+        rng = random.Random(SEED)
+        store = CS.ParameterStore()
+        points = []
+        for i in range(count + 1):
+            point = CS.G2D.ParaPoint(store=store)
+            point.x.Value = i * 2.0 + rng.uniform(-0.5, 0.5)
+            point.y.Value = rng.uniform(-0.5, 0.5)
+            points.append(point)
+        points[0].x.fix()
+        points[0].y.fix()
+        system = CS.SubSystem()
+        for point in points[1:]:
+            system.addUnknown(point.Parameters)
+        for i in range(count):
+            constraint = CS.G2D.ConstraintDistance(p1=points[i], p2=points[i + 1], store=store)
+            constraint.dist.Value = 2.0 + 0.5 * math.sin(i)
+            constraint.dist.fix()
+            constraint.update()
+            system.addConstraint(constraint)
+        values = CS.ValueSet(CS.ParameterSubset(store.allFree()))
+        return system, values
+
+    for backend in ('LM', 'DogLeg'):
+        solver = CS.SolverBackend('FCS::' + backend)
+        bench.run('constraintsolver', 'solve_' + backend.lower(), count,
+                  lambda s: solver.solve(s[0], s[1]), setup=makeSystem)
+
+
+def benchTechDraw(bench):
+    "Projects a generated part with hidden line removal."
+    Part = _module('Part')
+    if not (Part and _module('TechDraw')):
+        bench.skip('techdraw', 'TechDraw module not available')
+        return
+    if not bench.selected('techdraw'):
+        return
+
+    holes = bench.size(36)
+    columns = int(math.ceil(math.sqrt(holes)))
+    spacing = 80.0 / columns
+    shape = Part.makeBox(100, 100, 20, FreeCAD.Vector(-50, -50, 0))
+    tools = []
+    for i in range(holes):
+        center = FreeCAD.Vector(-40 + (i % columns + 0.5) * spacing,
+                                -40 + (i // columns + 0.5) * spacing, -1)
+        tools.append(Part.makeCylinder(spacing * 0.3, 22, center))
+    shape = shape.cut(Part.makeCompound(tools))
+
+    doc = _newDocument('BenchTechDraw')
+    try:
+        part = doc.addObject('Part::Feature', 'Part')
+        part.Shape = shape
+        page = doc.addObject('TechDraw::DrawPage', 'Page')
+        template = os.path.join(FreeCAD.getResourceDir(), 'Mod', 'TechDraw', 'Templates',
+                                'A3_Landscape_blank.svg')
+        if os.path.exists(template):
+            page.Template = doc.addObject('TechDraw::DrawSVGTemplate', 'Template')
+            page.Template.Template = template
+        view = doc.addObject('TechDraw::DrawViewPart', 'View')
+        page.addView(view)
+        view.Source = [part]
+        view.Direction = FreeCAD.Vector(1, 1, 1)
+        doc.recompute()
+
+        view.HardHidden = True
+        bench.run('techdraw', 'project_hlr', holes, lambda s: doc.recompute(),
+                  setup=lambda: view.touch())
+        view.CoarseView = True
+        bench.run('techdraw', 'project_coarse', holes, lambda s: doc.recompute(),
+                  setup=lambda: view.touch())
+    finally:
+        _closeDocument(doc)
+
+
+def benchLinkArray(bench):
+    "Places, redraws and picks the elements of a generated link array."
+    Part = _module('Part')
+    if not (Part and FreeCAD.GuiUp):
+        bench.skip('linkarray', 'needs the GUI and the Part module')
+        return
+    if not bench.selected('linkarray'):
+        return
+
+    import FreeCADGui
+    count = bench.size(10000)
+    columns = int(math.ceil(math.sqrt(count)))
+    doc = _newDocument('BenchLinkArray')
+    try:
+        box = doc.addObject('Part::Feature', 'Box')
+        box.Shape = Part.makeBox(1, 1, 1)
+        array = doc.addObject('App::Link', 'Array')
+        array.setLink(box)
+        array.ShowElement = False
+        array.ElementCount = count
+        doc.recompute()
+
+        def placements(spacing):
+            return [FreeCAD.Placement(FreeCAD.Vector((i % columns) * spacing,
+                                                     (i // columns) * spacing, 0),
+                                      FreeCAD.Rotation()) for i in range(count)]
+        spacings = (placements(2.0), placements(2.5))
+        spacing = _Toggle(0, 1)
+        bench.run('linkarray', 'set_placements', count,
+                  lambda s: setattr(array, 'PlacementList', spacings[spacing.next()]))
+        bench.run('linkarray', 'set_count', count,
+                  lambda s: setattr(array, 'ElementCount', count),
+                  setup=lambda: setattr(array, 'ElementCount', count // 2))
+
+        view = FreeCADGui.getDocument(doc.Name).ActiveView
+        view.fitAll()
+        image = bench.path('BenchLinkArray.png')
+        bench.run('linkarray', 'render', count,
+                  lambda s: view.saveImage(image, 800, 600, 'Current'))
+        size = view.getSize()
+        bench.run('linkarray', 'pick', count,
+                  lambda s: view.getObjectInfo((size[0] // 2, size[1] // 2)))
+    finally:
+        _closeDocument(doc)
+
+
+def benchPoints(bench):
+    "Renders a generated scattered point cloud with and without level of detail."
+    Points = _module('Points')
+    if not (Points and FreeCAD.GuiUp):
+        bench.skip('points', 'needs the GUI and the Points module')
+        return
+    if not bench.selected('points'):
+        return
+
+    import FreeCADGui
+    import random
+    count = bench.size(2000000)
+    rng = random.Random(0)
+    kernel = Points.Points([FreeCAD.Vector(rng.uniform(0, 100), rng.uniform(0, 100),
+                                           rng.uniform(0, 10)) for i in range(count)])
+    param = FreeCAD.ParamGet('User parameter:BaseApp/Preferences/Mod/Points')
+    lod = param.GetBool('LevelOfDetail', True)
+    doc = _newDocument('BenchPoints')
+    try:
+        cloud = doc.addObject('Points::Feature', 'Cloud')
+        view = FreeCADGui.getDocument(doc.Name).ActiveView
+        image = bench.path('BenchPoints.png')
+        render = lambda s: view.saveImage(image, 800, 600, 'Current')
+
+        for name, enabled in (('lod', True), ('all', False)):
+            # the sorting is chosen when the points are assigned
+            param.SetBool('LevelOfDetail', enabled)
+            cloud.Points = kernel
+            doc.recompute()
+            view.viewIsometric()
+            view.fitAll()
+            bench.run('points', 'render_fit_' + name, count, render)
+            for i in range(8):
+                view.zoomOut()
+            bench.run('points', 'render_far_' + name, count, render)
+    finally:
+        param.SetBool('LevelOfDetail', lod)
+        _closeDocument(doc)
+
+
+def benchSpreadsheet(bench):
+    "Evaluates a generated sheet of dependent formulas."
+    if not _module('Spreadsheet'):
+        bench.skip('spreadsheet', 'Spreadsheet module not available')
+        return
+    if not bench.selected('spreadsheet'):
+        return
+
+    rows = bench.size(1000)
+    doc = _newDocument('BenchSpreadsheet')
+    try:
+        sheet = doc.addObject('Spreadsheet::Sheet', 'Sheet')
+
+        def fill(state):
+            sheet.set('A1', '1')
+            sheet.set('B1', '=A1 * 2')
+            sheet.set('C1', '=sin(A1) + B1 / 3')
+            for row in range(2, rows + 1):
+                sheet.set('A%d' % row, '=A%d + 1' % (row - 1))
+                sheet.set('B%d' % row, '=A%d * 2 + B%d' % (row, row - 1))
+                sheet.set('C%d' % row, '=sin(A%d) + B%d / 3' % (row, row))
+            sheet.set('D1', '=sum(A1:C%d)' % rows)
+
+        bench.run('spreadsheet', 'set_cells', rows * 3, fill,
+                  teardown=lambda s: sheet.clearAll())
+        fill(None)
+        doc.recompute()
+
+        value = _Toggle('1', '2')
+        bench.run('spreadsheet', 'recompute', rows * 3, lambda s: doc.recompute(),
+                  setup=lambda: sheet.set('A1', value.next()))
+    finally:
+        _closeDocument(doc)
+
+
+BENCHMARKS = [
+    benchDocument,
+    benchProperties,
+    benchPartDesign,
+    benchMesh,
+    benchSketcher,
+    benchConstraintSolver,
+    benchTechDraw,
+    benchLinkArray,
+    benchPoints,
+    benchSpreadsheet,
+]
+
+
+def run(repeat=3, scale=1.0, filter=None):
+    "Runs the benchmarks and returns a list of results."
+    bench = Benchmark(repeat, scale, filter)
+    try:
+        for func in BENCHMARKS:
+            func(bench)
+    finally:
+        bench.close()
+    return bench.results
+
+
+def report(results, repeat=3, scale=1.0):
+    "Returns the JSON report of the results."
+    config = FreeCAD.ConfigGet
+    data = {
+        'format': FORMAT_VERSION,
+        'version': '.'.join([config('BuildVersionMajor'), config('BuildVersionMinor'),
+                             config('BuildRevision')]),
+        'revision': config('BuildRevisionHash'),
+        'platform': platform.platform(),
+        'python': platform.python_version(),
+        'repeat': repeat,
+        'scale': scale,
+        'benchmarks': results,
+    }
+    return json.dumps(data, indent=1, sort_keys=True)
+
+
+def main(output=None, repeat=3, scale=1.0, filter=None):
+    """Runs the benchmarks and writes the report to output or to stdout."""
+    text = report(run(repeat, scale, filter), repeat, scale)
+    if output:
+        with open(output, 'w') as f:
+            f.write(text)
+    else:
+        print(text)
+
+
+if __name__ == '__main__':
+    main(os.environ.get('FREECAD_BENCH_OUTPUT'))
@@ -608,6 +608,48 @@ class DocumentRecomputeCases(unittest.TestCase):
     self.Doc.removeObject(L7.Name)
     self.Doc.removeObject(L8.Name)
 
+  def testRecomputeAsync(self):
+    L1 = self.Doc.addObject("App::FeatureTest","Async_1")
+    L2 = self.Doc.addObject("App::FeatureTest","Async_2")
+    L3 = self.Doc.addObject("App::FeatureTest","Async_3")
+    L1.Link = L2
+    L2.Link = L3
+    self.Doc.recompute()
+    count = (L1.ExecCount, L2.ExecCount, L3.ExecCount)
+
+    class Observer():
+      def __init__(self):
+        self.recomputed = []
+      def slotRecomputedObject(self, obj):
+        self.recomputed.append(obj.Name)
+
+    obs = Observer()
+    FreeCAD.addDocumentObserver(obs)
+    try:
+      L2.enforceRecompute()
+      self.failUnless(self.Doc.recomputeAsync())
+      # the document is locked until the results are processed
+      self.assertRaises(RuntimeError, self.Doc.addObject, "App::FeatureTest", "Async_4")
+      with self.assertRaises(RuntimeError):
+        L3.Integer = 5
+      while self.Doc.processAsyncRecompute(100):
+        pass
+      self.failUnless((count[0]+1, count[1]+1, count[2]) == (L1.ExecCount, L2.ExecCount, L3.ExecCount))
+      self.failUnless(obs.recomputed == [L2.Name, L1.Name])
+      self.failUnless(not self.Doc.processAsyncRecompute())
+
+      # canceling leaves the remaining objects touched for the next recompute
+      L3.enforceRecompute()
+      self.failUnless(self.Doc.recomputeAsync())
+      self.Doc.cancelRecompute()
+      while self.Doc.processAsyncRecompute(100):
+        pass
+      self.Doc.recompute()
+      self.failUnless(not L1.isTouched() and not L2.isTouched() and not L3.isTouched())
+      self.failUnless((count[0]+2, count[1]+2, count[2]+1) == (L1.ExecCount, L2.ExecCount, L3.ExecCount))
+    finally:
+      FreeCAD.removeDocumentObserver(obs)
+
   def tearDown(self):
     #closing doc
     FreeCAD.closeDocument("RecomputeTests")
@@ -1191,6 +1233,31 @@ class DocumentBacklinks(unittest.TestCase):
     self.Doc.undo()
     self.Doc.openTransaction("Create object")
 
+  def testRecursiveLists(self):
+    # the recursive lists are cached and must follow every link change
+    obj1=self.Doc.addObject("App::FeatureTest","Test1")
+    obj2=self.Doc.addObject("App::FeatureTest","Test2")
+    obj3=self.Doc.addObject("App::FeatureTest","Test3")
+    obj2.Link=obj1
+    obj3.Link=obj2
+    self.assertEqual(set(obj3.OutListRecursive), set([obj1,obj2]))
+    self.assertEqual(set(obj1.InListRecursive), set([obj2,obj3]))
+    # the furthest linking object comes last
+    self.assertEqual(obj1.InListRecursive, [obj2,obj3])
+
+    obj2.Link=None
+    self.assertEqual(obj3.OutListRecursive, [obj2])
+    self.assertEqual(obj1.InListRecursive, [])
+
+    obj4=self.Doc.addObject("App::FeatureTest","Test4")
+    obj2.Link=obj4
+    obj4.Link=obj1
+    self.assertEqual(set(obj3.OutListRecursive), set([obj1,obj2,obj4]))
+    self.assertEqual(set(obj1.InListRecursive), set([obj2,obj3,obj4]))
+
+    self.Doc.removeObject(obj3.Name)
+    self.assertEqual(set(obj1.InListRecursive), set([obj2,obj4]))
+
   def tearDown(self):
     # closing doc
     FreeCAD.closeDocument("BackLinks")
@@ -1838,6 +1905,57 @@ class DocumentObserverCases(unittest.TestCase):
     self.Obs.signal = []
     self.Obs.parameter = []
     self.Obs.parameter2 = []
+
+  def testChangeBatch(self):
+    class ChangeObserver():
+      def __init__(self):
+        self.changed = []
+      def slotChangedObject(self, obj, prop):
+        self.changed.append((obj.Name, prop))
+
+    class BatchObserver(ChangeObserver):
+      def __init__(self):
+        ChangeObserver.__init__(self)
+        self.batches = []
+      def slotChangedObjects(self, doc, changes):
+        self.batches.append([(obj.Name, prop) for obj, prop in changes])
+
+    self.Doc1 = FreeCAD.newDocument("Observer1")
+    obj1 = self.Doc1.addObject("App::FeaturePython","obj1")
+    obj2 = self.Doc1.addObject("App::FeaturePython","obj2")
+    obj3 = self.Doc1.addObject("App::FeaturePython","obj3")
+    obs = BatchObserver()
+    single = ChangeObserver()
+    FreeCAD.addDocumentObserver(obs)
+    FreeCAD.addDocumentObserver(single)
+    try:
+      # outside of a batch every change is delivered on its own
+      obj1.Label = "a"
+      self.assertEqual(obs.changed, [("obj1", "Label")])
+      self.assertEqual(obs.batches, [])
+      obs.changed = []
+      single.changed = []
+
+      # repeated changes are coalesced, in order of their first change
+      with FreeCAD.ChangeBatch(self.Doc1):
+        obj2.Label = "b"
+        obj1.Label = "c"
+        with FreeCAD.ChangeBatch(self.Doc1):
+          obj2.Label = "d"
+          obj3.Label = "e"
+        self.assertEqual(obs.changed, [])
+        self.assertEqual(single.changed, [])
+        # changes of removed objects are dropped
+        self.Doc1.removeObject("obj3")
+      # an observer of whole batches gets the changes only once
+      self.assertEqual(obs.changed, [])
+      self.assertEqual(obs.batches, [[("obj2", "Label"), ("obj1", "Label")]])
+      self.assertEqual(single.changed, [("obj2", "Label"), ("obj1", "Label")])
+      self.assertEqual(obj2.Label, "d")
+    finally:
+      FreeCAD.removeDocumentObserver(single)
+      FreeCAD.removeDocumentObserver(obs)
+      FreeCAD.closeDocument(self.Doc1.Name)
     
   def testGuiObserver(self):
   